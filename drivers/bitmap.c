@@ -0,0 +1,129 @@
+/*
+ * bitmap.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#include <dpm/bitmap.h>
+#include <xcore/accel.h>
+#include <xcore/atomic.h>
+#include <assert.h>
+/*----------------------------------------------------------------------------*/
+void bitmapInit(struct Bitmap *bitmap, uint32_t *words, size_t size,
+    bool value)
+{
+  const size_t count = BITMAP_WORDS(size);
+
+  assert(size > 0 && size <= BITMAP_MAX_SIZE);
+
+  bitmap->words = words;
+  bitmap->summary = 0;
+
+  for (size_t index = 0; index < count; ++index)
+  {
+    if (value)
+    {
+      const size_t width = MIN(size - index * BITMAP_WORD_WIDTH,
+          BITMAP_WORD_WIDTH);
+
+      words[index] = width < BITMAP_WORD_WIDTH ?
+          (1UL << width) - 1 : UINT32_MAX;
+      bitmap->summary |= 1UL << index;
+    }
+    else
+      words[index] = 0;
+  }
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Clear a bit in the bitmap.
+ * @param bitmap Pointer to a Bitmap object.
+ * @param position Bit position.
+ * @return @b true when the bit was set before the operation.
+ */
+bool bitmapClear(struct Bitmap *bitmap, size_t position)
+{
+  const size_t index = position / BITMAP_WORD_WIDTH;
+  const uint32_t mask = 1UL << (position % BITMAP_WORD_WIDTH);
+  const uint32_t value = atomicFetchAnd(&bitmap->words[index], ~mask);
+
+  if (value == mask)
+  {
+    /* Word became empty, concurrent setters are handled by the recheck */
+    atomicFetchAnd(&bitmap->summary, ~(1UL << index));
+
+    if (atomicLoad(&bitmap->words[index]))
+      atomicFetchOr(&bitmap->summary, 1UL << index);
+  }
+
+  return (value & mask) != 0;
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Find the most significant set bit.
+ * @param bitmap Pointer to a Bitmap object.
+ * @return Bit position or @b BITMAP_NONE when the bitmap is empty.
+ */
+size_t bitmapFindLast(struct Bitmap *bitmap)
+{
+  uint32_t summary;
+
+  while ((summary = atomicLoad(&bitmap->summary)) != 0)
+  {
+    const uint32_t index = 31 - countLeadingZeros32(summary);
+    const uint32_t word = atomicLoad(&bitmap->words[index]);
+
+    if (word)
+      return index * BITMAP_WORD_WIDTH + (31 - countLeadingZeros32(word));
+
+    /* Remove the stale summary bit */
+    atomicFetchAnd(&bitmap->summary, ~(1UL << index));
+
+    if (atomicLoad(&bitmap->words[index]))
+      atomicFetchOr(&bitmap->summary, 1UL << index);
+  }
+
+  return BITMAP_NONE;
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Set a bit in the bitmap.
+ * @param bitmap Pointer to a Bitmap object.
+ * @param position Bit position.
+ * @return @b true when the bitmap was empty before the operation.
+ */
+bool bitmapSet(struct Bitmap *bitmap, size_t position)
+{
+  const size_t index = position / BITMAP_WORD_WIDTH;
+  const uint32_t mask = 1UL << (position % BITMAP_WORD_WIDTH);
+  const uint32_t value = atomicFetchOr(&bitmap->words[index], mask);
+  uint32_t summary = atomicFetchOr(&bitmap->summary, 1UL << index);
+
+  if (value)
+    return false;
+
+  /*
+   * Summary is updated after the word, therefore it may contain bits
+   * of words emptied by concurrent clear operations, such bits are skipped.
+   */
+  summary &= ~(1UL << index);
+
+  while (summary)
+  {
+    const uint32_t other = 31 - countLeadingZeros32(summary);
+
+    if (atomicLoad(&bitmap->words[other]))
+      return false;
+    summary &= ~(1UL << other);
+  }
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+bool bitmapTest(const struct Bitmap *bitmap, size_t position)
+{
+  const size_t index = position / BITMAP_WORD_WIDTH;
+  const uint32_t mask = 1UL << (position % BITMAP_WORD_WIDTH);
+
+  return (bitmap->words[index] & mask) != 0;
+}
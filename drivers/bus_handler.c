@@ -5,32 +5,46 @@
  */
 
 #include <dpm/bus_handler.h>
+#include <halm/timer.h>
 #include <halm/wq.h>
-#include <xcore/accel.h>
-#include <xcore/atomic.h>
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 /*----------------------------------------------------------------------------*/
+static inline size_t entryToIndex(const struct BusHandler *,
+    const struct BHEntry *);
 static void bhOnDetach(void *);
 static void bhOnError(void *);
 static void bhOnIdle(void *);
 static void bhOnUpdate(void *);
 static void bhUpdate(void *);
+static inline uint64_t statsGetTime(const struct BusHandler *);
+static inline void statsOnError(struct BHEntry *);
+static inline void statsOnRequest(struct BusHandler *, struct BHEntry *);
+static inline void statsOnStart(struct BHEntry *, uint64_t);
+static inline void statsOnStop(struct BHEntry *, uint64_t);
+/*----------------------------------------------------------------------------*/
+static inline size_t entryToIndex(const struct BusHandler *handler,
+    const struct BHEntry *entry)
+{
+  return (size_t)(entry - handler->devices);
+}
 /*----------------------------------------------------------------------------*/
 static void bhOnDetach(void *argument)
 {
   struct BusHandler * const handler = argument;
 
-  while (!handler->busy && handler->detaching)
+  while (!handler->busy)
   {
-    const uint32_t index = 31 - countLeadingZeros32(handler->detaching);
-    struct BHEntry * const entry = &handler->devices[index];
+    const size_t index = bitmapFindLast(&handler->detaching);
 
-    atomicFetchAnd(&handler->detaching, ~entry->mask);
-    atomicFetchAnd(&handler->updating, ~entry->mask);
-    atomicFetchOr(&handler->pool, entry->mask);
+    if (index == BITMAP_NONE)
+      break;
 
-    entry->device = NULL;
+    bitmapClear(&handler->detaching, index);
+    bitmapClear(&handler->updating, index);
+    handler->devices[index].device = NULL;
+    bitmapSet(&handler->pool, index);
   }
 }
 /*----------------------------------------------------------------------------*/
@@ -39,6 +53,8 @@ static void bhOnError(void *argument)
   struct BHEntry * const entry = argument;
   struct BusHandler * const handler = entry->handler;
 
+  statsOnError(entry);
+
   if (handler->errorCallback != NULL)
     handler->errorCallback(handler->errorCallbackArgument, entry->device);
 }
@@ -57,7 +73,10 @@ static void bhOnUpdate(void *argument)
   struct BHEntry * const entry = argument;
   struct BusHandler * const handler = entry->handler;
 
-  const uint32_t updating = atomicFetchOr(&handler->updating, entry->mask);
+  statsOnRequest(handler, entry);
+
+  const bool empty = bitmapSet(&handler->updating,
+      entryToIndex(handler, entry));
 
   if (handler->busy)
   {
@@ -66,7 +85,7 @@ static void bhOnUpdate(void *argument)
   }
   else
   {
-    if (updating == 0)
+    if (empty)
       wqAdd(handler->wq, bhUpdate, handler);
   }
 }
@@ -77,58 +96,163 @@ static void bhUpdate(void *argument)
 
   if (handler->current != NULL)
   {
-    atomicFetchAnd(&handler->updating, ~handler->current->mask);
+    bitmapClear(&handler->updating, entryToIndex(handler, handler->current));
     handler->busy = handler->current->updateCallback(handler->current->device);
 
     if (!handler->busy)
+    {
+      statsOnStop(handler->current, statsGetTime(handler));
       handler->current = NULL;
+    }
   }
 
-  while (!handler->busy && handler->updating)
+  while (!handler->busy)
   {
-    const uint32_t index = 31 - countLeadingZeros32(handler->updating);
+    const size_t index = bitmapFindLast(&handler->updating);
+
+    if (index == BITMAP_NONE)
+      break;
+
     struct BHEntry * const entry = &handler->devices[index];
 
-    atomicFetchAnd(&handler->updating, ~entry->mask);
+    bitmapClear(&handler->updating, index);
+    statsOnStart(entry, statsGetTime(handler));
     handler->busy = entry->updateCallback(entry->device);
 
     if (handler->busy)
+    {
       handler->current = entry;
+    }
     else
+    {
+      statsOnStop(entry, statsGetTime(handler));
       handler->current = NULL;
+    }
   }
 }
 /*----------------------------------------------------------------------------*/
+#ifdef CONFIG_BUS_HANDLER_STATS
+static inline uint64_t statsGetTime(const struct BusHandler *handler)
+{
+  return handler->chrono != NULL ? timerGetValue64(handler->chrono) : 0;
+}
+/*----------------------------------------------------------------------------*/
+static inline void statsOnError(struct BHEntry *entry)
+{
+  ++entry->stats.errors;
+}
+/*----------------------------------------------------------------------------*/
+static inline void statsOnRequest(struct BusHandler *handler,
+    struct BHEntry *entry)
+{
+  /* Repeated requests and requests of the active device are not counted */
+  if (handler->current != entry
+      && !bitmapTest(&handler->updating, entryToIndex(handler, entry)))
+  {
+    entry->requested = statsGetTime(handler);
+  }
+}
+/*----------------------------------------------------------------------------*/
+static inline void statsOnStart(struct BHEntry *entry, uint64_t timestamp)
+{
+  const uint64_t wait = timestamp - entry->requested;
+
+  entry->started = timestamp;
+  entry->stats.waitTime += wait;
+  if (wait > entry->stats.waitTimeMax)
+    entry->stats.waitTimeMax = wait;
+}
+/*----------------------------------------------------------------------------*/
+static inline void statsOnStop(struct BHEntry *entry, uint64_t timestamp)
+{
+  entry->stats.busyTime += timestamp - entry->started;
+  ++entry->stats.cycles;
+}
+#else
+static inline uint64_t statsGetTime(const struct BusHandler *)
+{
+  return 0;
+}
+/*----------------------------------------------------------------------------*/
+static inline void statsOnError(struct BHEntry *)
+{
+}
+/*----------------------------------------------------------------------------*/
+static inline void statsOnRequest(struct BusHandler *, struct BHEntry *)
+{
+}
+/*----------------------------------------------------------------------------*/
+static inline void statsOnStart(struct BHEntry *, uint64_t)
+{
+}
+/*----------------------------------------------------------------------------*/
+static inline void statsOnStop(struct BHEntry *, uint64_t)
+{
+}
+#endif
+/*----------------------------------------------------------------------------*/
 bool bhInit(struct BusHandler *handler, size_t capacity, void *wq)
 {
-  handler->devices = malloc(sizeof(struct BHEntry) * capacity);
-  if (handler->devices == NULL)
+  assert(capacity > 0 && capacity <= BITMAP_MAX_SIZE);
+
+  struct BHEntry * const devices = malloc(sizeof(struct BHEntry) * capacity
+      + sizeof(uint32_t) * BITMAP_WORDS(capacity) * 3);
+
+  if (devices == NULL)
     return false;
 
+  bhInitStatic(handler, devices, (uint32_t *)(devices + capacity),
+      capacity, wq);
+  handler->allocated = true;
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Initialize the bus handler using caller-provided storage.
+ * @param handler Pointer to a BusHandler object.
+ * @param devices Array of entries with @b capacity elements.
+ * @param words Array for device bitmaps with a size of at least
+ * 3 * BITMAP_WORDS(capacity) elements.
+ * @param capacity Maximum number of attached devices.
+ * @param wq Work queue for update tasks, default work queue is used
+ * when the argument is NULL.
+ */
+void bhInitStatic(struct BusHandler *handler, struct BHEntry *devices,
+    uint32_t *words, size_t capacity, void *wq)
+{
+  assert(capacity > 0 && capacity <= BITMAP_MAX_SIZE);
+
+  const size_t count = BITMAP_WORDS(capacity);
+
+  handler->devices = devices;
   for (size_t index = 0; index < capacity; ++index)
   {
     handler->devices[index].handler = handler;
     handler->devices[index].device = NULL;
-    handler->devices[index].mask = 1UL << index;
   }
 
+  bitmapInit(&handler->pool, words, capacity, true);
+  bitmapInit(&handler->detaching, words + count, capacity, false);
+  bitmapInit(&handler->updating, words + count * 2, capacity, false);
+
   handler->capacity = capacity;
-  handler->pool = (1UL << capacity) - 1;
-  handler->detaching = 0;
-  handler->updating = 0;
+  handler->allocated = false;
   handler->busy = false;
 
   handler->current = NULL;
   handler->wq = wq ? wq : WQ_DEFAULT;
+#ifdef CONFIG_BUS_HANDLER_STATS
+  handler->chrono = NULL;
+#endif
   handler->errorCallback = NULL;
   handler->idleCallback = NULL;
-
-  return true;
 }
 /*----------------------------------------------------------------------------*/
 void bhDeinit(struct BusHandler *handler)
 {
-  free(handler->devices);
+  if (handler->allocated)
+    free(handler->devices);
 }
 /*----------------------------------------------------------------------------*/
 bool bhAttach(struct BusHandler *handler, void *device,
@@ -141,13 +265,11 @@ bool bhAttach(struct BusHandler *handler, void *device,
   assert(updateCallbackSetter != NULL);
   assert(updateCallback != NULL);
 
-  while (handler->pool)
-  {
-    const unsigned int channel = 31 - countLeadingZeros32(handler->pool);
-    const uint32_t mask = 1UL << channel;
-    const uint32_t pool = atomicFetchAnd(&handler->pool, ~mask);
+  size_t channel;
 
-    if (!(pool & mask))
+  while ((channel = bitmapFindLast(&handler->pool)) != BITMAP_NONE)
+  {
+    if (!bitmapClear(&handler->pool, channel))
       continue;
 
     struct BHEntry * const entry = &handler->devices[channel];
@@ -157,6 +279,11 @@ bool bhAttach(struct BusHandler *handler, void *device,
     entry->idleCallbackSetter = idleCallbackSetter;
     entry->updateCallbackSetter = updateCallbackSetter;
     entry->updateCallback = updateCallback;
+#ifdef CONFIG_BUS_HANDLER_STATS
+    memset(&entry->stats, 0, sizeof(entry->stats));
+    entry->requested = 0;
+    entry->started = 0;
+#endif
 
     if (entry->errorCallbackSetter != NULL)
       entry->errorCallbackSetter(device, bhOnError, entry);
@@ -184,7 +311,7 @@ void bhDetach(struct BusHandler *handler, void *device)
         entry->idleCallbackSetter(device, NULL, NULL);
       entry->updateCallbackSetter(device, NULL, NULL);
 
-      atomicFetchOr(&handler->detaching, entry->mask);
+      bitmapSet(&handler->detaching, index);
       wqAdd(handler->wq, bhOnDetach, handler);
       break;
     }
@@ -204,3 +331,51 @@ void bhSetIdleCallback(struct BusHandler *handler, BHCallback callback,
   handler->idleCallbackArgument = argument;
   handler->idleCallback = callback;
 }
+/*----------------------------------------------------------------------------*/
+#ifdef CONFIG_BUS_HANDLER_STATS
+/**
+ * Get bus usage statistics of the attached device.
+ * @param handler Pointer to a BusHandler object.
+ * @param device Pointer to the attached device.
+ * @param stats Pointer to a structure where the statistics will be stored.
+ * @return @b true when the device was found, @b false otherwise.
+ */
+bool bhGetStatistics(const struct BusHandler *handler, const void *device,
+    struct BHStatistics *stats)
+{
+  for (size_t index = 0; index < handler->capacity; ++index)
+  {
+    const struct BHEntry * const entry = &handler->devices[index];
+
+    if (entry->device == device)
+    {
+      *stats = entry->stats;
+      return true;
+    }
+  }
+
+  return false;
+}
+#endif
+/*----------------------------------------------------------------------------*/
+#ifdef CONFIG_BUS_HANDLER_STATS
+void bhResetStatistics(struct BusHandler *handler)
+{
+  for (size_t index = 0; index < handler->capacity; ++index)
+    memset(&handler->devices[index].stats, 0, sizeof(struct BHStatistics));
+}
+#endif
+/*----------------------------------------------------------------------------*/
+#ifdef CONFIG_BUS_HANDLER_STATS
+/**
+ * Set a timer used for time measurements. Time values in the statistics
+ * are expressed in ticks of this timer.
+ * @param handler Pointer to a BusHandler object.
+ * @param chrono Pointer to a 64-bit timer. Pass NULL to disable time
+ * measurements.
+ */
+void bhSetChrono(struct BusHandler *handler, struct Timer64 *chrono)
+{
+  handler->chrono = chrono;
+}
+#endif
@@ -0,0 +1,411 @@
+/*
+ * bus_scheduler.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#include <dpm/bus_scheduler.h>
+#include <halm/timer.h>
+#include <halm/wq.h>
+#include <xcore/accel.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+/*----------------------------------------------------------------------------*/
+static void bsOnError(void *);
+static void bsOnIdle(void *);
+static void bsOnUpdate(void *);
+static void bsUpdate(void *);
+static void detachEntries(struct BusScheduler *);
+static inline size_t entryToIndex(const struct BusScheduler *,
+    const struct BSEntry *);
+static inline uint64_t getTime(const struct BusScheduler *);
+static void invokeUpdate(struct BusScheduler *);
+static void releaseBus(struct BusScheduler *, struct BSBus *);
+static void setPending(struct BusScheduler *, const struct BSEntry *);
+static void updateBus(struct BusScheduler *, struct BSBus *);
+/*----------------------------------------------------------------------------*/
+static void bsOnError(void *argument)
+{
+  struct BSEntry * const entry = argument;
+  struct BusScheduler * const scheduler = entry->scheduler;
+
+  if (scheduler->errorCallback != NULL)
+    scheduler->errorCallback(scheduler->errorCallbackArgument, entry->device);
+}
+/*----------------------------------------------------------------------------*/
+static void bsOnIdle(void *argument)
+{
+  struct BSEntry * const entry = argument;
+  struct BusScheduler * const scheduler = entry->scheduler;
+
+  if (scheduler->idleCallback != NULL)
+    scheduler->idleCallback(scheduler->idleCallbackArgument, entry->device);
+}
+/*----------------------------------------------------------------------------*/
+static void bsOnUpdate(void *argument)
+{
+  struct BSEntry * const entry = argument;
+  struct BusScheduler * const scheduler = entry->scheduler;
+
+  bitmapSet(&scheduler->updating, entryToIndex(scheduler, entry));
+
+  /*
+   * Device that occupies a bus is updated by that bus only. When the device
+   * releases the bus concurrently, the request will be queued by the
+   * releasing side.
+   */
+  if (entry->bus == NULL)
+    setPending(scheduler, entry);
+
+  invokeUpdate(scheduler);
+}
+/*----------------------------------------------------------------------------*/
+static void bsUpdate(void *argument)
+{
+  struct BusScheduler * const scheduler = argument;
+
+  scheduler->pending = false;
+
+  for (size_t number = 0; number < scheduler->count; ++number)
+    updateBus(scheduler, &scheduler->buses[number]);
+
+  detachEntries(scheduler);
+}
+/*----------------------------------------------------------------------------*/
+static void detachEntries(struct BusScheduler *scheduler)
+{
+  if (bitmapEmpty(&scheduler->detaching))
+    return;
+
+  /* Detaching is rare, linear search is acceptable */
+  for (size_t index = 0; index < scheduler->capacity; ++index)
+  {
+    struct BSEntry * const entry = &scheduler->devices[index];
+
+    if (entry->bus != NULL || !bitmapTest(&scheduler->detaching, index))
+      continue;
+
+    bitmapClear(&scheduler->detaching, index);
+    bitmapClear(&scheduler->updating, index);
+
+    for (size_t number = 0; number < scheduler->count; ++number)
+      bitmapClear(&scheduler->buses[number].pending, index);
+
+    entry->device = NULL;
+    bitmapSet(&scheduler->pool, index);
+  }
+}
+/*----------------------------------------------------------------------------*/
+static inline size_t entryToIndex(const struct BusScheduler *scheduler,
+    const struct BSEntry *entry)
+{
+  return (size_t)(entry - scheduler->devices);
+}
+/*----------------------------------------------------------------------------*/
+static inline uint64_t getTime(const struct BusScheduler *scheduler)
+{
+  return scheduler->chrono != NULL ? timerGetValue64(scheduler->chrono) : 0;
+}
+/*----------------------------------------------------------------------------*/
+static void invokeUpdate(struct BusScheduler *scheduler)
+{
+  if (!scheduler->pending)
+  {
+    scheduler->pending = true;
+
+    if (wqAdd(scheduler->wq, bsUpdate, scheduler) != E_OK)
+      scheduler->pending = false;
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void releaseBus(struct BusScheduler *scheduler, struct BSBus *bus)
+{
+  struct BSEntry * const entry = bus->current;
+
+  bus->stats.busyTime += getTime(scheduler) - bus->started;
+  ++bus->stats.cycles;
+
+  bus->current = NULL;
+  entry->bus = NULL;
+
+  /* Requests received while the bus was occupied should be queued again */
+  if (bitmapTest(&scheduler->updating, entryToIndex(scheduler, entry)))
+    setPending(scheduler, entry);
+}
+/*----------------------------------------------------------------------------*/
+static void setPending(struct BusScheduler *scheduler,
+    const struct BSEntry *entry)
+{
+  const size_t index = entryToIndex(scheduler, entry);
+  uint32_t reachable = entry->reachable;
+
+  while (reachable)
+  {
+    const uint32_t number = 31 - countLeadingZeros32(reachable);
+
+    bitmapSet(&scheduler->buses[number].pending, index);
+    reachable &= ~(1UL << number);
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void updateBus(struct BusScheduler *scheduler, struct BSBus *bus)
+{
+  if (bus->current != NULL)
+  {
+    struct BSEntry * const entry = bus->current;
+
+    if (bitmapClear(&scheduler->updating, entryToIndex(scheduler, entry)))
+    {
+      if (!entry->updateCallback(entry->device))
+        releaseBus(scheduler, bus);
+    }
+  }
+
+  while (bus->current == NULL)
+  {
+    const size_t index = bitmapFindLast(&bus->pending);
+
+    if (index == BITMAP_NONE)
+      break;
+
+    struct BSEntry * const entry = &scheduler->devices[index];
+
+    bitmapClear(&bus->pending, index);
+
+    /* Skip devices served by other buses and stale requests */
+    if (entry->bus != NULL || bitmapTest(&scheduler->detaching, index))
+      continue;
+    if (!bitmapClear(&scheduler->updating, index))
+      continue;
+
+    if (entry->busSetter != NULL)
+      entry->busSetter(entry->device, bus->interface);
+
+    bus->current = entry;
+    bus->started = getTime(scheduler);
+    entry->bus = bus;
+
+    if (!entry->updateCallback(entry->device))
+      releaseBus(scheduler, bus);
+  }
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Initialize the bus scheduler.
+ * @param scheduler Pointer to a BusScheduler object.
+ * @param interfaces Array of bus objects passed to devices on dispatch.
+ * @param count Number of buses.
+ * @param capacity Maximum number of attached devices.
+ * @param wq Work queue for update tasks, default work queue is used
+ * when the argument is NULL.
+ * @return @b true on success, @b false when memory allocation failed.
+ */
+bool bsInit(struct BusScheduler *scheduler, void * const *interfaces,
+    size_t count, size_t capacity, void *wq)
+{
+  assert(count > 0 && count <= BS_MAX_BUSES);
+  assert(capacity > 0 && capacity <= BITMAP_MAX_SIZE);
+
+  struct BSBus * const buses = malloc(sizeof(struct BSBus) * count
+      + sizeof(struct BSEntry) * capacity
+      + sizeof(uint32_t) * BITMAP_WORDS(capacity) * (count + 3));
+
+  if (buses == NULL)
+    return false;
+
+  struct BSEntry * const devices = (struct BSEntry *)(buses + count);
+
+  bsInitStatic(scheduler, buses, devices, (uint32_t *)(devices + capacity),
+      interfaces, count, capacity, wq);
+  scheduler->allocated = true;
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Initialize the bus scheduler using caller-provided storage.
+ * @param scheduler Pointer to a BusScheduler object.
+ * @param buses Array of bus descriptors with @b count elements.
+ * @param devices Array of entries with @b capacity elements.
+ * @param words Array for device bitmaps with a size of at least
+ * (count + 3) * BITMAP_WORDS(capacity) elements.
+ * @param interfaces Array of bus objects passed to devices on dispatch.
+ * @param count Number of buses.
+ * @param capacity Maximum number of attached devices.
+ * @param wq Work queue for update tasks, default work queue is used
+ * when the argument is NULL.
+ */
+void bsInitStatic(struct BusScheduler *scheduler, struct BSBus *buses,
+    struct BSEntry *devices, uint32_t *words, void * const *interfaces,
+    size_t count, size_t capacity, void *wq)
+{
+  assert(count > 0 && count <= BS_MAX_BUSES);
+  assert(capacity > 0 && capacity <= BITMAP_MAX_SIZE);
+
+  const size_t length = BITMAP_WORDS(capacity);
+
+  scheduler->buses = buses;
+  for (size_t number = 0; number < count; ++number)
+  {
+    struct BSBus * const bus = &scheduler->buses[number];
+
+    bus->current = NULL;
+    bus->interface = interfaces != NULL ? interfaces[number] : NULL;
+    bus->started = 0;
+    memset(&bus->stats, 0, sizeof(bus->stats));
+
+    bitmapInit(&bus->pending, words + length * (number + 3), capacity, false);
+  }
+
+  scheduler->devices = devices;
+  for (size_t index = 0; index < capacity; ++index)
+  {
+    scheduler->devices[index].scheduler = scheduler;
+    scheduler->devices[index].device = NULL;
+    scheduler->devices[index].bus = NULL;
+  }
+
+  bitmapInit(&scheduler->pool, words, capacity, true);
+  bitmapInit(&scheduler->detaching, words + length, capacity, false);
+  bitmapInit(&scheduler->updating, words + length * 2, capacity, false);
+
+  scheduler->capacity = capacity;
+  scheduler->count = count;
+  scheduler->allocated = false;
+  scheduler->pending = false;
+
+  scheduler->wq = wq ? wq : WQ_DEFAULT;
+  scheduler->chrono = NULL;
+  scheduler->errorCallback = NULL;
+  scheduler->idleCallback = NULL;
+}
+/*----------------------------------------------------------------------------*/
+void bsDeinit(struct BusScheduler *scheduler)
+{
+  if (scheduler->allocated)
+    free(scheduler->buses);
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Attach a device to the scheduler.
+ * @param scheduler Pointer to a BusScheduler object.
+ * @param device Pointer to a device.
+ * @param reachable Bit mask of buses the device is connected to.
+ * @param busSetter Function that switches the device to the selected bus.
+ * May be NULL when the device is connected to a single bus.
+ * @param errorCallbackSetter Function that sets the error callback, optional.
+ * @param idleCallbackSetter Function that sets the idle callback, optional.
+ * @param updateCallbackSetter Function that sets the update callback.
+ * @param updateCallback Update function of the device.
+ * @return @b true on success, @b false when there are no free entries.
+ */
+bool bsAttach(struct BusScheduler *scheduler, void *device, uint32_t reachable,
+    BSDeviceBusSetter busSetter,
+    BHDeviceCallbackSetter errorCallbackSetter,
+    BHDeviceCallbackSetter idleCallbackSetter,
+    BHDeviceCallbackSetter updateCallbackSetter,
+    BHDeviceCallback updateCallback)
+{
+  assert(device != NULL);
+  assert(reachable != 0);
+  assert(scheduler->count == BS_MAX_BUSES
+      || !(reachable >> scheduler->count));
+  assert(busSetter != NULL || !(reachable & (reachable - 1)));
+  assert(updateCallbackSetter != NULL);
+  assert(updateCallback != NULL);
+
+  size_t channel;
+
+  while ((channel = bitmapFindLast(&scheduler->pool)) != BITMAP_NONE)
+  {
+    if (!bitmapClear(&scheduler->pool, channel))
+      continue;
+
+    struct BSEntry * const entry = &scheduler->devices[channel];
+
+    entry->device = device;
+    entry->bus = NULL;
+    entry->reachable = reachable;
+    entry->busSetter = busSetter;
+    entry->errorCallbackSetter = errorCallbackSetter;
+    entry->idleCallbackSetter = idleCallbackSetter;
+    entry->updateCallbackSetter = updateCallbackSetter;
+    entry->updateCallback = updateCallback;
+
+    if (entry->errorCallbackSetter != NULL)
+      entry->errorCallbackSetter(device, bsOnError, entry);
+    if (entry->idleCallbackSetter != NULL)
+      entry->idleCallbackSetter(device, bsOnIdle, entry);
+    entry->updateCallbackSetter(device, bsOnUpdate, entry);
+
+    return true;
+  }
+
+  return false;
+}
+/*----------------------------------------------------------------------------*/
+void bsDetach(struct BusScheduler *scheduler, void *device)
+{
+  for (size_t index = 0; index < scheduler->capacity; ++index)
+  {
+    struct BSEntry * const entry = &scheduler->devices[index];
+
+    if (entry->device == device)
+    {
+      if (entry->errorCallbackSetter != NULL)
+        entry->errorCallbackSetter(device, NULL, NULL);
+      if (entry->idleCallbackSetter != NULL)
+        entry->idleCallbackSetter(device, NULL, NULL);
+      entry->updateCallbackSetter(device, NULL, NULL);
+
+      bitmapSet(&scheduler->detaching, index);
+      invokeUpdate(scheduler);
+      break;
+    }
+  }
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Get usage statistics of the bus. Bus utilization may be calculated
+ * as a ratio of the busy time to the time elapsed since the statistics
+ * were reset.
+ * @param scheduler Pointer to a BusScheduler object.
+ * @param number Bus number.
+ * @param stats Pointer to a structure where the statistics will be stored.
+ * @return @b true on success, @b false when the bus number is incorrect.
+ */
+bool bsGetStatistics(const struct BusScheduler *scheduler, size_t number,
+    struct BSStatistics *stats)
+{
+  if (number >= scheduler->count)
+    return false;
+
+  *stats = scheduler->buses[number].stats;
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+void bsResetStatistics(struct BusScheduler *scheduler)
+{
+  for (size_t number = 0; number < scheduler->count; ++number)
+    memset(&scheduler->buses[number].stats, 0, sizeof(struct BSStatistics));
+}
+/*----------------------------------------------------------------------------*/
+void bsSetChrono(struct BusScheduler *scheduler, struct Timer64 *chrono)
+{
+  scheduler->chrono = chrono;
+}
+/*----------------------------------------------------------------------------*/
+void bsSetErrorCallback(struct BusScheduler *scheduler, BHCallback callback,
+    void *argument)
+{
+  scheduler->errorCallbackArgument = argument;
+  scheduler->errorCallback = callback;
+}
+/*----------------------------------------------------------------------------*/
+void bsSetIdleCallback(struct BusScheduler *scheduler, BHCallback callback,
+    void *argument)
+{
+  scheduler->idleCallbackArgument = argument;
+  scheduler->idleCallback = callback;
+}
@@ -0,0 +1,380 @@
+/*
+ * framebuffer.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#include <dpm/displays/framebuffer.h>
+#include <halm/wq.h>
+#include <xcore/memory.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+/*----------------------------------------------------------------------------*/
+/*
+ * Cost of a window change expressed in pixels. Regions are merged when
+ * their bounding box costs less than separate transfers.
+ */
+#define MERGE_OVERHEAD 64
+/*----------------------------------------------------------------------------*/
+static void addRegion(struct Framebuffer *, struct DisplayWindow);
+static inline uint32_t calcArea(const struct DisplayWindow *);
+static void finishFlush(struct Framebuffer *);
+static void flushTask(void *);
+static bool isWindowValid(const struct Framebuffer *,
+    const struct DisplayWindow *);
+static void onDisplayEvent(void *);
+static void restorePending(struct Framebuffer *);
+static struct DisplayWindow uniteRegions(const struct DisplayWindow *,
+    const struct DisplayWindow *);
+static bool writeNext(struct Framebuffer *);
+/*----------------------------------------------------------------------------*/
+static void addRegion(struct Framebuffer *framebuffer,
+    struct DisplayWindow region)
+{
+  size_t index = 0;
+
+  while (index < framebuffer->count)
+  {
+    const struct DisplayWindow * const current = &framebuffer->pending[index];
+    const struct DisplayWindow merged = uniteRegions(current, &region);
+
+    if (calcArea(&merged)
+        <= calcArea(current) + calcArea(&region) + MERGE_OVERHEAD)
+    {
+      /* Merged region may overlap other regions, restart the search */
+      framebuffer->pending[index] =
+          framebuffer->pending[--framebuffer->count];
+      region = merged;
+      index = 0;
+    }
+    else
+      ++index;
+  }
+
+  if (framebuffer->count == framebuffer->capacity)
+  {
+    /* List is full, join the region with the closest one */
+    uint32_t growth = UINT32_MAX;
+    size_t closest = 0;
+
+    for (index = 0; index < framebuffer->count; ++index)
+    {
+      const struct DisplayWindow * const current =
+          &framebuffer->pending[index];
+      const struct DisplayWindow merged = uniteRegions(current, &region);
+      const uint32_t difference = calcArea(&merged) - calcArea(current);
+
+      if (difference < growth)
+      {
+        growth = difference;
+        closest = index;
+      }
+    }
+
+    framebuffer->pending[closest] =
+        uniteRegions(&framebuffer->pending[closest], &region);
+  }
+  else
+    framebuffer->pending[framebuffer->count++] = region;
+}
+/*----------------------------------------------------------------------------*/
+static inline uint32_t calcArea(const struct DisplayWindow *region)
+{
+  return (uint32_t)(region->bx - region->ax + 1)
+      * (uint32_t)(region->by - region->ay + 1);
+}
+/*----------------------------------------------------------------------------*/
+static void finishFlush(struct Framebuffer *framebuffer)
+{
+  ifSetCallback(framebuffer->display, NULL, NULL);
+  ifSetParam(framebuffer->display, IF_BLOCKING, NULL);
+
+  framebuffer->busy = false;
+
+  if (framebuffer->callback != NULL)
+    framebuffer->callback(framebuffer->callbackArgument);
+}
+/*----------------------------------------------------------------------------*/
+static void flushTask(void *argument)
+{
+  struct Framebuffer * const framebuffer = argument;
+
+  if (ifGetParam(framebuffer->display, IF_STATUS, NULL) != E_OK)
+  {
+    /* Transfer of the current region failed, resend it later */
+    framebuffer->row = 0;
+    restorePending(framebuffer);
+    finishFlush(framebuffer);
+  }
+  else if (!writeNext(framebuffer))
+    finishFlush(framebuffer);
+}
+/*----------------------------------------------------------------------------*/
+static bool isWindowValid(const struct Framebuffer *framebuffer,
+    const struct DisplayWindow *window)
+{
+  return window->ax <= window->bx && window->ay <= window->by
+      && window->bx < framebuffer->width && window->by < framebuffer->height;
+}
+/*----------------------------------------------------------------------------*/
+static void onDisplayEvent(void *argument)
+{
+  struct Framebuffer * const framebuffer = argument;
+
+  /* Window changes use blocking transfers, continue in the task context */
+  if (wqAdd(framebuffer->wq, flushTask, framebuffer) != E_OK)
+  {
+    restorePending(framebuffer);
+    finishFlush(framebuffer);
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void restorePending(struct Framebuffer *framebuffer)
+{
+  if (framebuffer->index < framebuffer->total)
+  {
+    /* Rows of the current region before the failure were written */
+    struct DisplayWindow region = framebuffer->active[framebuffer->index++];
+
+    region.ay += framebuffer->row;
+    if (region.ay <= region.by)
+      addRegion(framebuffer, region);
+  }
+
+  for (; framebuffer->index < framebuffer->total; ++framebuffer->index)
+    addRegion(framebuffer, framebuffer->active[framebuffer->index]);
+}
+/*----------------------------------------------------------------------------*/
+static struct DisplayWindow uniteRegions(const struct DisplayWindow *a,
+    const struct DisplayWindow *b)
+{
+  return (struct DisplayWindow){
+      MIN(a->ax, b->ax),
+      MIN(a->ay, b->ay),
+      MAX(a->bx, b->bx),
+      MAX(a->by, b->by)
+  };
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Start a transfer of the next part of the active regions.
+ * @param framebuffer Pointer to a Framebuffer object.
+ * @return @b true when the transfer was started, @b false when all regions
+ * were written or an error occurred.
+ */
+static bool writeNext(struct Framebuffer *framebuffer)
+{
+  const struct DisplayWindow *region;
+
+  /* Advance to the next region when the current one is complete */
+  while (framebuffer->index < framebuffer->total)
+  {
+    region = &framebuffer->active[framebuffer->index];
+
+    if (framebuffer->row <= region->by - region->ay)
+      break;
+
+    framebuffer->row = 0;
+    ++framebuffer->index;
+  }
+
+  if (framebuffer->index == framebuffer->total)
+    return false;
+
+  if (framebuffer->row == 0)
+  {
+    if (ifSetParam(framebuffer->display, IF_DISPLAY_WINDOW, region) != E_OK)
+    {
+      restorePending(framebuffer);
+      return false;
+    }
+  }
+
+  const uint16_t width = region->bx - region->ax + 1;
+  const uint16_t *pixels = framebuffer->pixels
+      + (region->ay + framebuffer->row) * framebuffer->width + region->ax;
+
+  /* Rows of full-width regions are contiguous in memory */
+  const uint16_t rows = width == framebuffer->width ?
+      region->by - region->ay + 1 - framebuffer->row : 1;
+  const size_t length = (size_t)rows * width * sizeof(uint16_t);
+
+  if (ifWrite(framebuffer->display, pixels, length) != length)
+  {
+    restorePending(framebuffer);
+    return false;
+  }
+
+  framebuffer->row += rows;
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+bool fbInit(struct Framebuffer *framebuffer,
+    const struct FramebufferConfig *config)
+{
+  assert(config != NULL);
+  assert(config->display != NULL);
+  assert(config->capacity > 0);
+
+  struct DisplayResolution resolution;
+
+  if (ifGetParam(config->display, IF_DISPLAY_RESOLUTION, &resolution) != E_OK)
+    return false;
+
+  const size_t pixels = (size_t)resolution.width * resolution.height;
+  uint8_t * const memory = malloc(pixels * sizeof(uint16_t)
+      + sizeof(struct DisplayWindow) * config->capacity * 2);
+
+  if (memory == NULL)
+    return false;
+
+  framebuffer->callback = NULL;
+  framebuffer->callbackArgument = NULL;
+  framebuffer->display = config->display;
+  framebuffer->wq = config->wq != NULL ? config->wq : WQ_DEFAULT;
+  framebuffer->pixels = (uint16_t *)memory;
+  framebuffer->pending =
+      (struct DisplayWindow *)(memory + pixels * sizeof(uint16_t));
+  framebuffer->active = framebuffer->pending + config->capacity;
+  framebuffer->capacity = config->capacity;
+  framebuffer->count = 0;
+  framebuffer->total = 0;
+  framebuffer->index = 0;
+  framebuffer->width = resolution.width;
+  framebuffer->height = resolution.height;
+  framebuffer->row = 0;
+  framebuffer->busy = false;
+
+  memset(framebuffer->pixels, 0, pixels * sizeof(uint16_t));
+
+  /* Content of the display is unknown */
+  fbInvalidate(framebuffer, &(struct DisplayWindow){
+      0, 0, resolution.width - 1, resolution.height - 1
+  });
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+void fbDeinit(struct Framebuffer *framebuffer)
+{
+  assert(!framebuffer->busy);
+  free(framebuffer->pixels);
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Fill a rectangle with a solid color.
+ * @param framebuffer Pointer to a Framebuffer object.
+ * @param window Rectangle with inclusive coordinates.
+ * @param color Color in RGB565 format.
+ */
+void fbFill(struct Framebuffer *framebuffer,
+    const struct DisplayWindow *window, uint16_t color)
+{
+  assert(isWindowValid(framebuffer, window));
+
+  const uint16_t value = toBigEndian16(color);
+  const uint16_t width = window->bx - window->ax + 1;
+
+  for (uint16_t y = window->ay; y <= window->by; ++y)
+  {
+    uint16_t * const row = framebuffer->pixels + y * framebuffer->width
+        + window->ax;
+
+    for (uint16_t x = 0; x < width; ++x)
+      row[x] = value;
+  }
+
+  addRegion(framebuffer, *window);
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Write dirty regions to the display. Regions are written asynchronously
+ * in zero-copy mode, the callback is called after completion. Regions
+ * that could not be written remain dirty.
+ * @param framebuffer Pointer to a Framebuffer object.
+ * @return @b true when the flush was started, @b false when there are no
+ * dirty regions, the previous flush is still in progress or an error
+ * occurred.
+ */
+bool fbFlush(struct Framebuffer *framebuffer)
+{
+  if (framebuffer->busy || !framebuffer->count)
+    return false;
+
+  struct DisplayWindow * const regions = framebuffer->active;
+
+  framebuffer->active = framebuffer->pending;
+  framebuffer->pending = regions;
+  framebuffer->total = framebuffer->count;
+  framebuffer->count = 0;
+  framebuffer->index = 0;
+  framebuffer->row = 0;
+  framebuffer->busy = true;
+
+  ifSetParam(framebuffer->display, IF_ZEROCOPY, NULL);
+  ifSetCallback(framebuffer->display, onDisplayEvent, framebuffer);
+
+  if (!writeNext(framebuffer))
+  {
+    ifSetCallback(framebuffer->display, NULL, NULL);
+    ifSetParam(framebuffer->display, IF_BLOCKING, NULL);
+    framebuffer->busy = false;
+    return false;
+  }
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Mark a rectangle as dirty after direct modification of the pixel array.
+ * @param framebuffer Pointer to a Framebuffer object.
+ * @param window Rectangle with inclusive coordinates.
+ */
+void fbInvalidate(struct Framebuffer *framebuffer,
+    const struct DisplayWindow *window)
+{
+  assert(isWindowValid(framebuffer, window));
+  addRegion(framebuffer, *window);
+}
+/*----------------------------------------------------------------------------*/
+void fbSetCallback(struct Framebuffer *framebuffer, void (*callback)(void *),
+    void *argument)
+{
+  framebuffer->callbackArgument = argument;
+  framebuffer->callback = callback;
+}
+/*----------------------------------------------------------------------------*/
+void fbSetPixel(struct Framebuffer *framebuffer, uint16_t x, uint16_t y,
+    uint16_t color)
+{
+  assert(x < framebuffer->width && y < framebuffer->height);
+
+  framebuffer->pixels[y * framebuffer->width + x] = toBigEndian16(color);
+  addRegion(framebuffer, (struct DisplayWindow){x, y, x, y});
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Copy an image to a rectangle.
+ * @param framebuffer Pointer to a Framebuffer object.
+ * @param window Rectangle with inclusive coordinates.
+ * @param pixels Image in RGB565 format, rows are stored without padding.
+ */
+void fbWrite(struct Framebuffer *framebuffer,
+    const struct DisplayWindow *window, const uint16_t *pixels)
+{
+  assert(isWindowValid(framebuffer, window));
+
+  const uint16_t width = window->bx - window->ax + 1;
+
+  for (uint16_t y = window->ay; y <= window->by; ++y)
+  {
+    uint16_t * const row = framebuffer->pixels + y * framebuffer->width
+        + window->ax;
+
+    for (uint16_t x = 0; x < width; ++x)
+      row[x] = toBigEndian16(*pixels++);
+  }
+
+  addRegion(framebuffer, *window);
+}
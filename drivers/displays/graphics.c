@@ -0,0 +1,405 @@
+/*
+ * graphics.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#include <dpm/displays/graphics.h>
+#include <xcore/memory.h>
+#include <assert.h>
+#include <stdlib.h>
+/*----------------------------------------------------------------------------*/
+#define DEFAULT_CACHE_SIZE  8
+#define RGB565_EXPAND_MASK  0x07E0F81FUL
+/*----------------------------------------------------------------------------*/
+static uint16_t blendColors(uint16_t, uint16_t, uint8_t);
+static bool clipArea(const struct Graphics *, int32_t, int32_t, uint16_t,
+    uint16_t, struct DisplayWindow *);
+static const uint16_t *getGlyphPixels(struct Graphics *, uint8_t, uint16_t,
+    uint16_t);
+static void renderGlyph(const struct Graphics *, const struct GfxGlyph *,
+    uint16_t *, uint16_t, uint16_t);
+static bool writePixels(struct Graphics *, const struct DisplayWindow *,
+    const uint16_t *, size_t, bool);
+/*----------------------------------------------------------------------------*/
+/**
+ * Blend two colors in RGB565 format. All three channels are processed
+ * at once: the color is expanded to a 32-bit word with the green channel
+ * moved to the upper half-word, leaving gaps for multiplication carries.
+ * @param color Foreground color.
+ * @param background Background color.
+ * @param coverage Foreground coverage in the range from 0 to 15.
+ * @return Blended color.
+ */
+static uint16_t blendColors(uint16_t color, uint16_t background,
+    uint8_t coverage)
+{
+  /* Scale coverage to the range from 0 to 32 */
+  const uint32_t alpha = ((uint32_t)coverage * 32 + 7) / 15;
+
+  if (alpha == 0)
+    return background;
+  if (alpha >= 32)
+    return color;
+
+  const uint32_t fg = (color | ((uint32_t)color << 16)) & RGB565_EXPAND_MASK;
+  const uint32_t bg = (background | ((uint32_t)background << 16))
+      & RGB565_EXPAND_MASK;
+  const uint32_t mixed = ((fg * alpha + bg * (32 - alpha)) >> 5)
+      & RGB565_EXPAND_MASK;
+
+  return (uint16_t)(mixed | (mixed >> 16));
+}
+/*----------------------------------------------------------------------------*/
+static bool clipArea(const struct Graphics *graphics, int32_t x, int32_t y,
+    uint16_t width, uint16_t height, struct DisplayWindow *window)
+{
+  if (!width || !height)
+    return false;
+
+  const int32_t ax = MAX(x, 0);
+  const int32_t ay = MAX(y, 0);
+  const int32_t bx = MIN(x + width - 1, (int32_t)graphics->width - 1);
+  const int32_t by = MIN(y + height - 1, (int32_t)graphics->height - 1);
+
+  if (ax > bx || ay > by)
+    return false;
+
+  *window = (struct DisplayWindow){
+      (uint16_t)ax, (uint16_t)ay, (uint16_t)bx, (uint16_t)by
+  };
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+static const uint16_t *getGlyphPixels(struct Graphics *graphics,
+    uint8_t code, uint16_t color, uint16_t background)
+{
+  struct GfxCacheEntry *victim = graphics->entries;
+
+  for (size_t index = 0; index < graphics->capacity; ++index)
+  {
+    struct GfxCacheEntry * const entry = &graphics->entries[index];
+
+    if (entry->valid && entry->code == code && entry->color == color
+        && entry->background == background)
+    {
+      entry->time = ++graphics->time;
+      return entry->pixels;
+    }
+
+    /* Empty entries have zero time and are replaced first */
+    if (entry->time < victim->time)
+      victim = entry;
+  }
+
+  const struct GfxFont * const font = graphics->font;
+
+  renderGlyph(graphics, &font->glyphs[code - font->first], victim->pixels,
+      color, background);
+
+  victim->time = ++graphics->time;
+  victim->color = color;
+  victim->background = background;
+  victim->code = code;
+  victim->valid = true;
+
+  return victim->pixels;
+}
+/*----------------------------------------------------------------------------*/
+static void renderGlyph(const struct Graphics *graphics,
+    const struct GfxGlyph *glyph, uint16_t *pixels, uint16_t color,
+    uint16_t background)
+{
+  const struct GfxFont * const font = graphics->font;
+  const uint8_t *bitmap = font->bitmaps + glyph->offset;
+  const size_t stride = (glyph->width + 1) >> 1;
+
+  assert(glyph->width <= font->width);
+
+  for (uint8_t row = 0; row < font->height; ++row)
+  {
+    for (uint8_t column = 0; column < glyph->width; ++column)
+    {
+      const uint8_t value = bitmap[column >> 1];
+      const uint8_t coverage = (column & 1) ? (value & 0x0F) : (value >> 4);
+
+      *pixels++ = toBigEndian16(blendColors(color, background, coverage));
+    }
+
+    bitmap += stride;
+  }
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Write a clipped part of an image to the display.
+ * @param graphics Pointer to a Graphics object.
+ * @param window Display area.
+ * @param pixels Pointer to the first visible pixel of the image.
+ * @param stride Distance between image rows in pixels.
+ * @param convert Pixels are in RGB565 format and should be converted
+ * to the byte order of the display interface.
+ * @return @b true on success.
+ */
+static bool writePixels(struct Graphics *graphics,
+    const struct DisplayWindow *window, const uint16_t *pixels,
+    size_t stride, bool convert)
+{
+  const size_t width = window->bx - window->ax + 1;
+  const size_t height = window->by - window->ay + 1;
+
+  if (ifSetParam(graphics->display, IF_DISPLAY_WINDOW, window) != E_OK)
+    return false;
+
+  if (!convert && width == stride)
+  {
+    /* Image is contiguous, write it at once */
+    const size_t length = width * height * sizeof(uint16_t);
+    return ifWrite(graphics->display, pixels, length) == length;
+  }
+
+  for (size_t row = 0; row < height; ++row)
+  {
+    const uint16_t *input = pixels + row * stride;
+
+    if (!convert)
+    {
+      const size_t length = width * sizeof(uint16_t);
+
+      if (ifWrite(graphics->display, input, length) != length)
+        return false;
+      continue;
+    }
+
+    for (size_t left = width; left;)
+    {
+      const size_t chunk = MIN(left, GFX_PATTERN_LENGTH);
+      const size_t length = chunk * sizeof(uint16_t);
+
+      for (size_t index = 0; index < chunk; ++index)
+        graphics->pattern[index] = toBigEndian16(*input++);
+
+      if (ifWrite(graphics->display, graphics->pattern, length) != length)
+        return false;
+      left -= chunk;
+    }
+  }
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+bool gfxInit(struct Graphics *graphics, const struct GraphicsConfig *config)
+{
+  assert(config != NULL);
+  assert(config->display != NULL);
+
+  struct DisplayResolution resolution;
+
+  if (ifGetParam(config->display, IF_DISPLAY_RESOLUTION, &resolution) != E_OK)
+    return false;
+
+  /* Pattern buffer and glyph cache are reused right after each write */
+  if (ifSetParam(config->display, IF_BLOCKING, NULL) != E_OK)
+    return false;
+
+  graphics->display = config->display;
+  graphics->font = config->font;
+  graphics->entries = NULL;
+  graphics->capacity = 0;
+  graphics->time = 0;
+  graphics->width = resolution.width;
+  graphics->height = resolution.height;
+
+  if (config->font != NULL)
+  {
+    const size_t capacity = config->cache ? config->cache : DEFAULT_CACHE_SIZE;
+    const size_t pixels = (size_t)config->font->width * config->font->height;
+    uint8_t * const memory = malloc(capacity
+        * (sizeof(struct GfxCacheEntry) + pixels * sizeof(uint16_t)));
+
+    if (memory == NULL)
+      return false;
+
+    graphics->entries = (struct GfxCacheEntry *)memory;
+    graphics->capacity = capacity;
+
+    uint16_t *storage = (uint16_t *)(graphics->entries + capacity);
+
+    for (size_t index = 0; index < capacity; ++index)
+    {
+      graphics->entries[index].pixels = storage;
+      graphics->entries[index].time = 0;
+      graphics->entries[index].valid = false;
+      storage += pixels;
+    }
+  }
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+void gfxDeinit(struct Graphics *graphics)
+{
+  free(graphics->entries);
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Copy an image to the display, parts outside the display are clipped.
+ * @param graphics Pointer to a Graphics object.
+ * @param x Horizontal position of the top left corner.
+ * @param y Vertical position of the top left corner.
+ * @param width Image width.
+ * @param height Image height.
+ * @param pixels Image in RGB565 format, rows are stored without padding.
+ * @return @b true on success.
+ */
+bool gfxBlit(struct Graphics *graphics, int16_t x, int16_t y, uint16_t width,
+    uint16_t height, const uint16_t *pixels)
+{
+  struct DisplayWindow window;
+
+  if (!clipArea(graphics, x, y, width, height, &window))
+    return true;
+
+  pixels += (window.ay - y) * width + (window.ax - x);
+  return writePixels(graphics, &window, pixels, width, true);
+}
+/*----------------------------------------------------------------------------*/
+bool gfxDrawHLine(struct Graphics *graphics, int16_t x, int16_t y,
+    uint16_t length, uint16_t color)
+{
+  return gfxFill(graphics, x, y, length, 1, color);
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Draw antialiased text on a solid background. Glyphs are blended with
+ * the background once and stored in the cache, subsequent output of the
+ * same glyph with the same colors is a single display write.
+ * @param graphics Pointer to a Graphics object.
+ * @param x Horizontal position of the top left corner.
+ * @param y Vertical position of the top left corner.
+ * @param text Null-terminated string, characters without glyphs are skipped.
+ * @param color Text color in RGB565 format.
+ * @param background Background color in RGB565 format.
+ * @return @b true on success.
+ */
+bool gfxDrawText(struct Graphics *graphics, int16_t x, int16_t y,
+    const char *text, uint16_t color, uint16_t background)
+{
+  const struct GfxFont * const font = graphics->font;
+  int32_t position = x;
+
+  assert(font != NULL);
+
+  for (; *text && position < graphics->width; ++text)
+  {
+    const uint8_t code = (uint8_t)*text;
+
+    if (code < font->first || code - font->first >= font->count)
+      continue;
+
+    const struct GfxGlyph * const glyph = &font->glyphs[code - font->first];
+    struct DisplayWindow window;
+
+    if (clipArea(graphics, position, y, glyph->width, font->height, &window))
+    {
+      const uint16_t * const pixels = getGlyphPixels(graphics, code, color,
+          background);
+      const size_t offset = (window.ay - y) * glyph->width
+          + (window.ax - position);
+
+      if (!writePixels(graphics, &window, pixels + offset, glyph->width,
+          false))
+      {
+        return false;
+      }
+    }
+
+    if (glyph->advance > glyph->width)
+    {
+      /* Fill the spacing between glyphs */
+      if (!gfxFill(graphics, (int16_t)(position + glyph->width), y,
+          glyph->advance - glyph->width, font->height, background))
+      {
+        return false;
+      }
+    }
+
+    position += glyph->advance;
+  }
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+bool gfxDrawVLine(struct Graphics *graphics, int16_t x, int16_t y,
+    uint16_t length, uint16_t color)
+{
+  return gfxFill(graphics, x, y, 1, length, color);
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Fill a rectangle with a solid color. The display window is set once
+ * and the color is streamed as a repeated pattern. When the display bus
+ * supports writes with a fixed source address, a single pixel is repeated
+ * by the bus without copying.
+ * @param graphics Pointer to a Graphics object.
+ * @param x Horizontal position of the top left corner.
+ * @param y Vertical position of the top left corner.
+ * @param width Rectangle width.
+ * @param height Rectangle height.
+ * @param color Color in RGB565 format.
+ * @return @b true on success.
+ */
+bool gfxFill(struct Graphics *graphics, int16_t x, int16_t y, uint16_t width,
+    uint16_t height, uint16_t color)
+{
+  struct DisplayWindow window;
+
+  if (!clipArea(graphics, x, y, width, height, &window))
+    return true;
+  if (ifSetParam(graphics->display, IF_DISPLAY_WINDOW, &window) != E_OK)
+    return false;
+
+  const uint16_t value = toBigEndian16(color);
+  size_t count = (size_t)(window.bx - window.ax + 1)
+      * (window.by - window.ay + 1);
+
+  if (ifSetParam(graphics->display, IF_DISPLAY_REPEAT, NULL) == E_OK)
+  {
+    const size_t length = count * sizeof(uint16_t);
+
+    graphics->pattern[0] = value;
+    return ifWrite(graphics->display, graphics->pattern, length) == length;
+  }
+
+  for (size_t index = 0; index < MIN(count, GFX_PATTERN_LENGTH); ++index)
+    graphics->pattern[index] = value;
+
+  while (count)
+  {
+    const size_t chunk = MIN(count, GFX_PATTERN_LENGTH);
+    const size_t length = chunk * sizeof(uint16_t);
+
+    if (ifWrite(graphics->display, graphics->pattern, length) != length)
+      return false;
+    count -= chunk;
+  }
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+uint16_t gfxGetTextWidth(const struct Graphics *graphics, const char *text)
+{
+  const struct GfxFont * const font = graphics->font;
+  uint16_t width = 0;
+
+  assert(font != NULL);
+
+  for (; *text; ++text)
+  {
+    const uint8_t code = (uint8_t)*text;
+
+    if (code >= font->first && code - font->first < font->count)
+      width += font->glyphs[code - font->first].advance;
+  }
+
+  return width;
+}
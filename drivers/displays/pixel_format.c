@@ -0,0 +1,273 @@
+/*
+ * pixel_format.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#include <dpm/displays/pixel_format.h>
+#include <xcore/memory.h>
+#include <string.h>
+/*----------------------------------------------------------------------------*/
+#define RB_MASK 0x00FF00FFUL
+#define G_MASK  0x0000FF00UL
+/*----------------------------------------------------------------------------*/
+static inline uint32_t addSaturated(uint32_t, uint32_t);
+static inline uint16_t blendPixel(uint32_t, uint32_t);
+static inline uint32_t loadWord(const void *);
+static void makeThresholds(uint32_t *, uint16_t, uint16_t);
+static inline uint16_t packRgb(uint32_t);
+static inline void storePair(uint16_t *, uint16_t, uint16_t, bool);
+static inline void storePixel(uint16_t *, uint16_t, bool);
+static inline void unpackQuad(uint16_t *, uint32_t, uint32_t, uint32_t);
+/*----------------------------------------------------------------------------*/
+/* Bayer matrix for ordered dithering */
+static const uint8_t ditherMatrix[4][4] = {
+    {0, 8, 2, 10},
+    {12, 4, 14, 6},
+    {3, 11, 1, 9},
+    {15, 7, 13, 5}
+};
+/*----------------------------------------------------------------------------*/
+/**
+ * Add two words byte by byte with saturation.
+ * @param value Pixel data.
+ * @param threshold Values to be added, each byte should be less than 128.
+ * @return Byte-wise sum saturated to 255.
+ */
+static inline uint32_t addSaturated(uint32_t value, uint32_t threshold)
+{
+  const uint32_t high = value & 0x80808080UL;
+  const uint32_t sum = (value & 0x7F7F7F7FUL) + threshold;
+  const uint32_t overflow = (high & sum) >> 7;
+
+  return (sum ^ high) | (overflow * 0xFF);
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Blend a pixel with the background. Red and blue channels are processed
+ * together with a single multiplication.
+ * @param pixel Pixel in ARGB8888 format.
+ * @param background Background color in RGB888 format.
+ * @return Blended color in RGB565 format.
+ */
+static inline uint16_t blendPixel(uint32_t pixel, uint32_t background)
+{
+  const uint32_t alpha = pixel >> 24;
+
+  if (alpha == 0xFF)
+    return packRgb(pixel);
+
+  /* Scale alpha to the range from 0 to 256 */
+  const uint32_t foreground = alpha + (alpha >> 7);
+  const uint32_t rest = 256 - foreground;
+  const uint32_t rb = (((pixel & RB_MASK) * foreground
+      + (background & RB_MASK) * rest) >> 8) & RB_MASK;
+  const uint32_t g = (((pixel & G_MASK) * foreground
+      + (background & G_MASK) * rest) >> 8) & G_MASK;
+
+  return packRgb(rb | g);
+}
+/*----------------------------------------------------------------------------*/
+static inline uint32_t loadWord(const void *input)
+{
+  uint32_t value;
+
+  memcpy(&value, input, sizeof(value));
+  return fromLittleEndian32(value);
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Prepare dithering thresholds for four consecutive RGB888 pixels packed
+ * into three words. The pattern repeats every four pixels, therefore
+ * the same thresholds are used for the whole row.
+ * @param thresholds Array of three words.
+ * @param x Horizontal position of the first pixel.
+ * @param y Row number.
+ */
+static void makeThresholds(uint32_t *thresholds, uint16_t x, uint16_t y)
+{
+  uint8_t bytes[12];
+
+  for (size_t index = 0; index < 4; ++index)
+  {
+    const uint8_t value = ditherMatrix[y & 3][(x + index) & 3];
+
+    /* Five bits are kept for red and blue channels, six bits for green */
+    bytes[index * 3 + 0] = value >> 1;
+    bytes[index * 3 + 1] = value >> 2;
+    bytes[index * 3 + 2] = value >> 1;
+  }
+
+  for (size_t index = 0; index < 3; ++index)
+    thresholds[index] = loadWord(bytes + index * 4);
+}
+/*----------------------------------------------------------------------------*/
+static inline uint16_t packRgb(uint32_t value)
+{
+  return (uint16_t)(((value >> 8) & 0xF800) | ((value >> 5) & 0x07E0)
+      | ((value >> 3) & 0x001F));
+}
+/*----------------------------------------------------------------------------*/
+static inline void storePair(uint16_t *output, uint16_t first,
+    uint16_t second, bool bigEndian)
+{
+  const uint32_t value = bigEndian ?
+      toBigEndian32(((uint32_t)first << 16) | second) :
+      toLittleEndian32(first | ((uint32_t)second << 16));
+
+  memcpy(output, &value, sizeof(value));
+}
+/*----------------------------------------------------------------------------*/
+static inline void storePixel(uint16_t *output, uint16_t pixel, bool bigEndian)
+{
+  const uint16_t value = bigEndian ?
+      toBigEndian16(pixel) : toLittleEndian16(pixel);
+
+  memcpy(output, &value, sizeof(value));
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Convert four RGB888 pixels loaded as three little-endian words.
+ * Fields are moved to their places directly without unpacking bytes.
+ * @param output Array of four pixels in RGB565 format.
+ * @param w0 Bytes R0 G0 B0 R1.
+ * @param w1 Bytes G1 B1 R2 G2.
+ * @param w2 Bytes B2 R3 G3 B3.
+ */
+static inline void unpackQuad(uint16_t *output, uint32_t w0, uint32_t w1,
+    uint32_t w2)
+{
+  output[0] = (uint16_t)(((w0 << 8) & 0xF800) | ((w0 >> 5) & 0x07E0)
+      | ((w0 >> 19) & 0x001F));
+  output[1] = (uint16_t)(((w0 >> 16) & 0xF800) | ((w1 << 3) & 0x07E0)
+      | ((w1 >> 11) & 0x001F));
+  output[2] = (uint16_t)(((w1 >> 8) & 0xF800) | ((w1 >> 21) & 0x07E0)
+      | ((w2 >> 3) & 0x001F));
+  output[3] = (uint16_t)((w2 & 0xF800) | ((w2 >> 13) & 0x07E0)
+      | (w2 >> 27));
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Blend ARGB8888 pixels onto a solid background and convert them
+ * to RGB565 format.
+ * @param output Output buffer.
+ * @param input Input pixels, alpha channel is in the most significant byte.
+ * @param count Number of pixels.
+ * @param background Background color in RGB565 format.
+ * @param bigEndian Store output pixels in big-endian byte order used by
+ * serial display interfaces, little-endian order is used otherwise.
+ */
+void pfArgb8888ToRgb565(uint16_t *output, const uint32_t *input, size_t count,
+    uint16_t background, bool bigEndian)
+{
+  const uint32_t r = background >> 11;
+  const uint32_t g = (background >> 5) & 0x3F;
+  const uint32_t b = background & 0x1F;
+
+  /* Background is expanded to RGB888 with replication of high bits */
+  const uint32_t expanded = (((r << 3) | (r >> 2)) << 16)
+      | (((g << 2) | (g >> 4)) << 8) | ((b << 3) | (b >> 2));
+
+  for (; count >= 2; count -= 2)
+  {
+    const uint16_t first = blendPixel(input[0], expanded);
+    const uint16_t second = blendPixel(input[1], expanded);
+
+    storePair(output, first, second, bigEndian);
+    input += 2;
+    output += 2;
+  }
+
+  if (count)
+    storePixel(output, blendPixel(*input, expanded), bigEndian);
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Convert RGB888 pixels to RGB565 format by truncation. Four pixels
+ * are loaded as three words and two pixels are stored at once.
+ * @param output Output buffer.
+ * @param input Input pixels, each pixel is stored as red, green and
+ * blue bytes.
+ * @param count Number of pixels.
+ * @param bigEndian Store output pixels in big-endian byte order.
+ */
+void pfRgb888ToRgb565(uint16_t *output, const uint8_t *input, size_t count,
+    bool bigEndian)
+{
+  uint16_t quad[4];
+
+  for (; count >= 4; count -= 4)
+  {
+    unpackQuad(quad, loadWord(input), loadWord(input + 4),
+        loadWord(input + 8));
+
+    storePair(output, quad[0], quad[1], bigEndian);
+    storePair(output + 2, quad[2], quad[3], bigEndian);
+    input += 12;
+    output += 4;
+  }
+
+  for (; count; --count)
+  {
+    storePixel(output++, packRgb(((uint32_t)input[0] << 16)
+        | ((uint32_t)input[1] << 8) | input[2]), bigEndian);
+    input += 3;
+  }
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Convert RGB888 pixels to RGB565 format with 4x4 ordered dithering.
+ * @param output Output buffer.
+ * @param input Input pixels, each pixel is stored as red, green and
+ * blue bytes.
+ * @param count Number of pixels.
+ * @param x Horizontal position of the first pixel on the screen.
+ * @param y Row number on the screen.
+ * @param bigEndian Store output pixels in big-endian byte order.
+ */
+void pfRgb888ToRgb565Dither(uint16_t *output, const uint8_t *input,
+    size_t count, uint16_t x, uint16_t y, bool bigEndian)
+{
+  uint32_t thresholds[3];
+  uint16_t quad[4];
+
+  makeThresholds(thresholds, x, y);
+
+  for (; count >= 4; count -= 4)
+  {
+    unpackQuad(quad,
+        addSaturated(loadWord(input), thresholds[0]),
+        addSaturated(loadWord(input + 4), thresholds[1]),
+        addSaturated(loadWord(input + 8), thresholds[2]));
+
+    storePair(output, quad[0], quad[1], bigEndian);
+    storePair(output + 2, quad[2], quad[3], bigEndian);
+    input += 12;
+    output += 4;
+    x += 4;
+  }
+
+  for (; count; --count)
+  {
+    const uint8_t value = ditherMatrix[y & 3][x++ & 3];
+    const uint32_t r = MIN((uint32_t)input[0] + (value >> 1), 255);
+    const uint32_t g = MIN((uint32_t)input[1] + (value >> 2), 255);
+    const uint32_t b = MIN((uint32_t)input[2] + (value >> 1), 255);
+
+    storePixel(output++, packRgb((r << 16) | (g << 8) | b), bigEndian);
+    input += 3;
+  }
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Swap bytes of 16-bit pixels. Input and output buffers may be the same.
+ * @param output Output buffer.
+ * @param input Input pixels.
+ * @param count Number of pixels.
+ */
+void pfSwapBytes(uint16_t *output, const uint16_t *input, size_t count)
+{
+  /* Simple loop is vectorized by compilers unlike paired word accesses */
+  for (size_t index = 0; index < count; ++index)
+    output[index] = (uint16_t)((input[index] << 8) | (input[index] >> 8));
+}
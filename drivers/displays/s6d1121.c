@@ -6,6 +6,7 @@
 
 #include <dpm/displays/display.h>
 #include <dpm/displays/s6d1121.h>
+#include <dpm/memory_bus.h>
 #include <halm/delay.h>
 #include <xcore/bits.h>
 #include <xcore/memory.h>
@@ -311,6 +312,7 @@ static enum Result displayInit(void *object, const void *configPtr)
   display->callback = NULL;
   display->bus = config->bus;
   display->blocking = true;
+  display->repeat = false;
 
   /* Reset display */
   pinReset(display->reset);
@@ -425,7 +427,7 @@ static enum Result displaySetParam(void *object, int parameter,
     {
       const struct DisplayWindow * const window = data;
 
-      if (window->ax < window->bx && window->ay < window->by
+      if (window->ax <= window->bx && window->ay <= window->by
           && window->bx < DISPLAY_WIDTH && window->by < DISPLAY_HEIGHT)
       {
         display->window = *window;
@@ -436,6 +438,15 @@ static enum Result displaySetParam(void *object, int parameter,
         return E_VALUE;
     }
 
+    case IF_DISPLAY_REPEAT:
+      if (ifGetParam(display->bus, IF_MEMORY_BUS_REPEAT, NULL) == E_OK)
+      {
+        display->repeat = true;
+        return E_OK;
+      }
+      else
+        return E_INVALID;
+
     default:
       break;
   }
@@ -465,6 +476,13 @@ static size_t displayWrite(void *object, const void *buffer, size_t length)
 
   selectDataMode(display);
 
+  if (display->repeat)
+  {
+    /* Option is applied to the pixel data only */
+    display->repeat = false;
+    ifSetParam(display->bus, IF_MEMORY_BUS_REPEAT, NULL);
+  }
+
   if (display->blocking)
   {
     bytesWritten = ifWrite(display->bus, buffer, length);
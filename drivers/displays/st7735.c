@@ -404,7 +404,7 @@ static enum Result displaySetParam(void *object, int parameter,
     {
       const struct DisplayWindow * const window = data;
 
-      if (window->ax < window->bx && window->ay < window->by
+      if (window->ax <= window->bx && window->ay <= window->by
           && window->bx < DISPLAY_WIDTH && window->by < DISPLAY_HEIGHT)
       {
         display->window = *window;
@@ -0,0 +1,473 @@
+/*
+ * strip_renderer.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#include <dpm/displays/strip_renderer.h>
+#include <halm/wq.h>
+#include <xcore/atomic.h>
+#include <xcore/memory.h>
+#include <assert.h>
+#include <stdlib.h>
+/*----------------------------------------------------------------------------*/
+enum
+{
+  COMMAND_BITMAP,
+  COMMAND_GLYPH,
+  COMMAND_LINE,
+  COMMAND_RECT
+};
+/*----------------------------------------------------------------------------*/
+static bool addCommand(struct StripRenderer *, const struct SRCommand *);
+static void drawBitmap(const struct StripRenderer *, uint16_t *, uint16_t,
+    uint16_t, const struct SRCommand *);
+static void drawGlyph(const struct StripRenderer *, uint16_t *, uint16_t,
+    uint16_t, const struct SRCommand *);
+static void drawLine(const struct StripRenderer *, uint16_t *, uint16_t,
+    uint16_t, const struct SRCommand *);
+static void drawRect(const struct StripRenderer *, uint16_t *, uint16_t,
+    uint16_t, const struct SRCommand *);
+static void finishFrame(struct StripRenderer *);
+static inline uint16_t getStripRows(const struct StripRenderer *, uint16_t);
+static void onDisplayEvent(void *);
+static void processFrame(struct StripRenderer *);
+static void renderStrip(struct StripRenderer *, uint16_t);
+static void renderTask(void *);
+static bool startTransfer(struct StripRenderer *);
+/*----------------------------------------------------------------------------*/
+static bool addCommand(struct StripRenderer *renderer,
+    const struct SRCommand *command)
+{
+  assert(!renderer->busy);
+
+  if (renderer->count == renderer->capacity)
+    return false;
+
+  renderer->commands[renderer->count++] = *command;
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+static void drawBitmap(const struct StripRenderer *renderer, uint16_t *buffer,
+    uint16_t top, uint16_t bottom, const struct SRCommand *command)
+{
+  const struct DisplayWindow * const area = &command->area;
+  const uint16_t *pixels = command->data;
+  const uint16_t right = MIN(area->bx, renderer->width - 1);
+  const uint16_t stride = area->bx - area->ax + 1;
+
+  for (uint16_t y = MAX(area->ay, top); y <= MIN(area->by, bottom); ++y)
+  {
+    const uint16_t * const input = pixels + (y - area->ay) * stride;
+    uint16_t * const output = buffer + (y - top) * renderer->width;
+
+    for (uint16_t x = area->ax; x <= right; ++x)
+      output[x] = toBigEndian16(input[x - area->ax]);
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void drawGlyph(const struct StripRenderer *renderer, uint16_t *buffer,
+    uint16_t top, uint16_t bottom, const struct SRCommand *command)
+{
+  const struct DisplayWindow * const area = &command->area;
+  const uint8_t * const bitmap = command->data;
+  const uint16_t right = MIN(area->bx, renderer->width - 1);
+  const uint16_t stride = (area->bx - area->ax + 8) >> 3;
+
+  for (uint16_t y = MAX(area->ay, top); y <= MIN(area->by, bottom); ++y)
+  {
+    const uint8_t * const input = bitmap + (y - area->ay) * stride;
+    uint16_t * const output = buffer + (y - top) * renderer->width;
+
+    for (uint16_t x = area->ax; x <= right; ++x)
+    {
+      const uint16_t column = x - area->ax;
+
+      if (input[column >> 3] & (0x80 >> (column & 7)))
+        output[x] = command->color;
+    }
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void drawLine(const struct StripRenderer *renderer, uint16_t *buffer,
+    uint16_t top, uint16_t bottom, const struct SRCommand *command)
+{
+  const struct DisplayWindow * const area = &command->area;
+  const int dx = area->bx - area->ax;
+  const int dy = -(area->by - area->ay);
+  const int sy = command->rising ? -1 : 1;
+  const int y1 = command->rising ? area->ay : area->by;
+  int x = area->ax;
+  int y = command->rising ? area->by : area->ay;
+  int error = dx + dy;
+
+  /* Line is traced from the beginning, only points of the strip are drawn */
+  while (true)
+  {
+    if (y >= top && y <= bottom && x < renderer->width)
+      buffer[(y - top) * renderer->width + x] = command->color;
+
+    if (x == area->bx && y == y1)
+      break;
+
+    const int error2 = error * 2;
+
+    if (error2 >= dy)
+    {
+      error += dy;
+      ++x;
+    }
+    if (error2 <= dx)
+    {
+      error += dx;
+      y += sy;
+    }
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void drawRect(const struct StripRenderer *renderer, uint16_t *buffer,
+    uint16_t top, uint16_t bottom, const struct SRCommand *command)
+{
+  const struct DisplayWindow * const area = &command->area;
+  const uint16_t right = MIN(area->bx, renderer->width - 1);
+
+  for (uint16_t y = MAX(area->ay, top); y <= MIN(area->by, bottom); ++y)
+  {
+    uint16_t * const output = buffer + (y - top) * renderer->width;
+
+    for (uint16_t x = area->ax; x <= right; ++x)
+      output[x] = command->color;
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void finishFrame(struct StripRenderer *renderer)
+{
+  ifSetCallback(renderer->display, NULL, NULL);
+  ifSetParam(renderer->display, IF_BLOCKING, NULL);
+
+  renderer->busy = false;
+
+  if (renderer->callback != NULL)
+    renderer->callback(renderer->callbackArgument);
+}
+/*----------------------------------------------------------------------------*/
+static inline uint16_t getStripRows(const struct StripRenderer *renderer,
+    uint16_t strip)
+{
+  return MIN(renderer->rows, renderer->height - strip * renderer->rows);
+}
+/*----------------------------------------------------------------------------*/
+static void onDisplayEvent(void *argument)
+{
+  struct StripRenderer * const renderer = argument;
+
+  atomicStore(&renderer->transfer, false);
+
+  /* Display drivers may issue blocking commands, leave interrupt context */
+  if (wqAdd(renderer->wq, renderTask, renderer) != E_OK)
+    finishFrame(renderer);
+}
+/*----------------------------------------------------------------------------*/
+static void processFrame(struct StripRenderer *renderer)
+{
+  while (true)
+  {
+    const bool transfer = atomicLoad(&renderer->transfer);
+
+    if (!transfer && renderer->sent < renderer->rendered)
+    {
+      /* Next strip is ready and the bus is free */
+      if (!startTransfer(renderer))
+      {
+        finishFrame(renderer);
+        return;
+      }
+
+      continue;
+    }
+
+    if (!transfer && renderer->sent == renderer->strips)
+    {
+      finishFrame(renderer);
+      return;
+    }
+
+    /* Each buffer is reused after the strip two positions back is sent */
+    const uint16_t completed = renderer->sent - (transfer ? 1 : 0);
+
+    if (renderer->rendered < renderer->strips
+        && renderer->rendered < completed + 2)
+    {
+      renderStrip(renderer, renderer->rendered);
+      ++renderer->rendered;
+    }
+    else
+      break;
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void renderStrip(struct StripRenderer *renderer, uint16_t strip)
+{
+  uint16_t * const buffer = renderer->buffers[strip & 1];
+  const uint16_t rows = getStripRows(renderer, strip);
+  const uint16_t top = strip * renderer->rows;
+  const uint16_t bottom = top + rows - 1;
+  const size_t pixels = (size_t)rows * renderer->width;
+
+  for (size_t index = 0; index < pixels; ++index)
+    buffer[index] = renderer->background;
+
+  /* Primitives are drawn in the order of the display list */
+  for (size_t index = 0; index < renderer->count; ++index)
+  {
+    const struct SRCommand * const command = &renderer->commands[index];
+
+    if (command->area.ay > bottom || command->area.by < top)
+      continue;
+    if (command->area.ax >= renderer->width)
+      continue;
+
+    switch (command->type)
+    {
+      case COMMAND_BITMAP:
+        drawBitmap(renderer, buffer, top, bottom, command);
+        break;
+
+      case COMMAND_GLYPH:
+        drawGlyph(renderer, buffer, top, bottom, command);
+        break;
+
+      case COMMAND_LINE:
+        drawLine(renderer, buffer, top, bottom, command);
+        break;
+
+      case COMMAND_RECT:
+        drawRect(renderer, buffer, top, bottom, command);
+        break;
+    }
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void renderTask(void *argument)
+{
+  struct StripRenderer * const renderer = argument;
+
+  if (ifGetParam(renderer->display, IF_STATUS, NULL) != E_OK)
+    finishFrame(renderer);
+  else
+    processFrame(renderer);
+}
+/*----------------------------------------------------------------------------*/
+static bool startTransfer(struct StripRenderer *renderer)
+{
+  const uint16_t strip = renderer->sent++;
+  const size_t length = (size_t)getStripRows(renderer, strip)
+      * renderer->width * sizeof(uint16_t);
+
+  atomicStore(&renderer->transfer, true);
+
+  if (ifWrite(renderer->display, renderer->buffers[strip & 1], length)
+      != length)
+  {
+    atomicStore(&renderer->transfer, false);
+    return false;
+  }
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+bool srInit(struct StripRenderer *renderer,
+    const struct StripRendererConfig *config)
+{
+  assert(config != NULL);
+  assert(config->display != NULL);
+  assert(config->capacity > 0);
+  assert(config->rows > 0);
+
+  struct DisplayResolution resolution;
+
+  if (ifGetParam(config->display, IF_DISPLAY_RESOLUTION, &resolution) != E_OK)
+    return false;
+
+  const uint16_t rows = MIN(config->rows, resolution.height);
+  const size_t pixels = (size_t)resolution.width * rows;
+  uint8_t * const memory = malloc(pixels * sizeof(uint16_t) * 2
+      + sizeof(struct SRCommand) * config->capacity);
+
+  if (memory == NULL)
+    return false;
+
+  renderer->callback = NULL;
+  renderer->callbackArgument = NULL;
+  renderer->display = config->display;
+  renderer->wq = config->wq != NULL ? config->wq : WQ_DEFAULT;
+  renderer->buffers[0] = (uint16_t *)memory;
+  renderer->buffers[1] = renderer->buffers[0] + pixels;
+  renderer->commands = (struct SRCommand *)(renderer->buffers[1] + pixels);
+  renderer->capacity = config->capacity;
+  renderer->count = 0;
+  renderer->width = resolution.width;
+  renderer->height = resolution.height;
+  renderer->rows = rows;
+  renderer->strips = (resolution.height + rows - 1) / rows;
+  renderer->rendered = 0;
+  renderer->sent = 0;
+  renderer->background = 0;
+  renderer->transfer = false;
+  renderer->busy = false;
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+void srDeinit(struct StripRenderer *renderer)
+{
+  assert(!renderer->busy);
+  free(renderer->buffers[0]);
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Add an image to the display list.
+ * @param renderer Pointer to a StripRenderer object.
+ * @param x Horizontal position of the top left corner.
+ * @param y Vertical position of the top left corner.
+ * @param width Image width.
+ * @param height Image height.
+ * @param pixels Image in RGB565 format, rows are stored without padding.
+ * Image should remain valid until the end of rendering.
+ * @return @b true on success, @b false when the display list is full.
+ */
+bool srAddBitmap(struct StripRenderer *renderer, uint16_t x, uint16_t y,
+    uint16_t width, uint16_t height, const uint16_t *pixels)
+{
+  assert(width > 0 && height > 0);
+
+  return addCommand(renderer, &(struct SRCommand){
+      .data = pixels,
+      .area = {x, y, x + width - 1, y + height - 1},
+      .type = COMMAND_BITMAP
+  });
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Add a monochrome glyph to the display list. Only set bits are drawn.
+ * @param renderer Pointer to a StripRenderer object.
+ * @param x Horizontal position of the top left corner.
+ * @param y Vertical position of the top left corner.
+ * @param width Glyph width.
+ * @param height Glyph height.
+ * @param bitmap Glyph rows, each row is aligned to a byte and
+ * the most significant bit is the leftmost pixel. Bitmap should remain
+ * valid until the end of rendering.
+ * @param color Glyph color in RGB565 format.
+ * @return @b true on success, @b false when the display list is full.
+ */
+bool srAddGlyph(struct StripRenderer *renderer, uint16_t x, uint16_t y,
+    uint16_t width, uint16_t height, const uint8_t *bitmap, uint16_t color)
+{
+  assert(width > 0 && height > 0);
+
+  return addCommand(renderer, &(struct SRCommand){
+      .data = bitmap,
+      .area = {x, y, x + width - 1, y + height - 1},
+      .color = toBigEndian16(color),
+      .type = COMMAND_GLYPH
+  });
+}
+/*----------------------------------------------------------------------------*/
+bool srAddLine(struct StripRenderer *renderer, uint16_t ax, uint16_t ay,
+    uint16_t bx, uint16_t by, uint16_t color)
+{
+  if (ax > bx)
+  {
+    /* Lines are always traced from left to right */
+    const uint16_t tx = ax;
+    const uint16_t ty = ay;
+
+    ax = bx;
+    ay = by;
+    bx = tx;
+    by = ty;
+  }
+
+  if (ax == bx || ay == by)
+  {
+    /* Horizontal and vertical lines are drawn as rectangles */
+    return addCommand(renderer, &(struct SRCommand){
+        .area = {ax, MIN(ay, by), bx, MAX(ay, by)},
+        .color = toBigEndian16(color),
+        .type = COMMAND_RECT
+    });
+  }
+  else
+  {
+    return addCommand(renderer, &(struct SRCommand){
+        .area = {ax, MIN(ay, by), bx, MAX(ay, by)},
+        .color = toBigEndian16(color),
+        .type = COMMAND_LINE,
+        .rising = by < ay
+    });
+  }
+}
+/*----------------------------------------------------------------------------*/
+bool srAddRect(struct StripRenderer *renderer,
+    const struct DisplayWindow *window, uint16_t color)
+{
+  assert(window->ax <= window->bx && window->ay <= window->by);
+
+  return addCommand(renderer, &(struct SRCommand){
+      .area = *window,
+      .color = toBigEndian16(color),
+      .type = COMMAND_RECT
+  });
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Clear the display list.
+ * @param renderer Pointer to a StripRenderer object.
+ * @param background Background color in RGB565 format.
+ */
+void srClear(struct StripRenderer *renderer, uint16_t background)
+{
+  assert(!renderer->busy);
+
+  renderer->background = toBigEndian16(background);
+  renderer->count = 0;
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Render the display list to the whole display. Strips are rendered
+ * in a work queue task while the previous strip is written in zero-copy
+ * mode, the callback is called after completion.
+ * @param renderer Pointer to a StripRenderer object.
+ * @return @b true when rendering was started.
+ */
+bool srRender(struct StripRenderer *renderer)
+{
+  if (renderer->busy)
+    return false;
+
+  const struct DisplayWindow window = {
+      0, 0, renderer->width - 1, renderer->height - 1
+  };
+
+  if (ifSetParam(renderer->display, IF_DISPLAY_WINDOW, &window) != E_OK)
+    return false;
+
+  renderer->rendered = 0;
+  renderer->sent = 0;
+  renderer->transfer = false;
+  renderer->busy = true;
+
+  ifSetParam(renderer->display, IF_ZEROCOPY, NULL);
+  ifSetCallback(renderer->display, onDisplayEvent, renderer);
+
+  processFrame(renderer);
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+void srSetCallback(struct StripRenderer *renderer, void (*callback)(void *),
+    void *argument)
+{
+  renderer->callbackArgument = argument;
+  renderer->callback = callback;
+}
@@ -4,6 +4,7 @@
  * Project is distributed under the terms of the MIT License
  */
 
+#include <dpm/memory_bus.h>
 #include <dpm/platform/lpc/memory_bus_dma.h>
 #include <dpm/platform/lpc/memory_bus_dma_finalizer.h>
 #include <halm/platform/lpc/gpdma_circular.h>
@@ -11,9 +12,10 @@
 #include <xcore/memory.h>
 #include <assert.h>
 /*----------------------------------------------------------------------------*/
+static void configureDma(struct MemoryBusDma *, bool);
 static void interruptHandler(void *);
 static bool setupDma(struct MemoryBusDma *, const struct MemoryBusDmaConfig *,
-    uint8_t, uint8_t);
+    uint8_t);
 static void setupGpio(struct MemoryBusDma *, const struct MemoryBusDmaConfig *);
 /*----------------------------------------------------------------------------*/
 static enum Result busInit(void *, const void *);
@@ -38,6 +40,33 @@ static const struct InterfaceClass busTable = {
 /*----------------------------------------------------------------------------*/
 const struct InterfaceClass * const MemoryBusDma = &busTable;
 /*----------------------------------------------------------------------------*/
+static void configureDma(struct MemoryBusDma *interface, bool fixed)
+{
+  const enum GpDmaWidth width = interface->width ?
+      DMA_WIDTH_HALFWORD : DMA_WIDTH_BYTE;
+
+  const struct GpDmaSettings dmaSettings = {
+      .source = {
+          .burst = DMA_BURST_4,
+          .width = width,
+          .increment = !fixed
+      },
+      .destination = {
+          .burst = DMA_BURST_1,
+          .width = width,
+          .increment = false
+      }
+  };
+
+  /*
+   * To improve performance DMA synchronization logic can be disabled.
+   * This will decrease data write time from 5 to 4 AHB cycles.
+   */
+
+  dmaConfigure(interface->dma, &dmaSettings);
+  interface->fixed = fixed;
+}
+/*----------------------------------------------------------------------------*/
 static void interruptHandler(void *object)
 {
   struct MemoryBusDma * const interface = object;
@@ -81,32 +110,11 @@ static void setupGpio(struct MemoryBusDma *interface,
 }
 /*----------------------------------------------------------------------------*/
 static bool setupDma(struct MemoryBusDma *interface,
-    const struct MemoryBusDmaConfig *config, uint8_t matchChannel,
-    uint8_t busWidth)
+    const struct MemoryBusDmaConfig *config, uint8_t matchChannel)
 {
   /* Only channels 0 and 1 can be used as DMA events */
   assert(matchChannel < 2);
 
-  const enum GpDmaWidth width = busWidth ? DMA_WIDTH_HALFWORD : DMA_WIDTH_BYTE;
-
-  const struct GpDmaSettings dmaSettings = {
-      .source = {
-          .burst = DMA_BURST_4,
-          .width = width,
-          .increment = true
-      },
-      .destination = {
-          .burst = DMA_BURST_1,
-          .width = width,
-          .increment = false
-      }
-  };
-
-  /*
-   * To improve performance DMA synchronization logic can be disabled.
-   * This will decrease data write time from 5 to 4 AHB cycles.
-   */
-
   if (config->size <= GPDMA_MAX_TRANSFER_SIZE)
   {
     const struct GpDmaOneShotConfig dmaConfig = {
@@ -135,7 +143,7 @@ static bool setupDma(struct MemoryBusDma *interface,
 
   if (interface->dma != NULL)
   {
-    dmaConfigure(interface->dma, &dmaSettings);
+    configureDma(interface, false);
     return true;
   }
   else
@@ -187,12 +195,13 @@ static enum Result busInit(void *object, const void *configPtr)
   const uint8_t dmaEvent = config->clock.swap ?
       interface->clock->trailing : interface->clock->leading;
 
-  if (setupDma(interface, config, dmaEvent, interface->width))
+  if (setupDma(interface, config, dmaEvent))
   {
     timerSetCallback(interface->clock, interruptHandler, interface);
 
     interface->blocking = true;
     interface->busy = false;
+    interface->repeat = false;
     interface->callback = NULL;
 
     return E_OK;
@@ -224,6 +233,15 @@ static enum Result busGetParam(void *object, int parameter, void *data)
 {
   struct MemoryBusDma * const interface = object;
 
+  switch ((enum MemoryBusParameter)parameter)
+  {
+    case IF_MEMORY_BUS_REPEAT:
+      return E_OK;
+
+    default:
+      break;
+  }
+
   switch ((enum IfParameter)parameter)
   {
     case IF_STATUS:
@@ -242,6 +260,16 @@ static enum Result busSetParam(void *object, int parameter, const void *)
 {
   struct MemoryBusDma * const interface = object;
 
+  switch ((enum MemoryBusParameter)parameter)
+  {
+    case IF_MEMORY_BUS_REPEAT:
+      interface->repeat = true;
+      return E_OK;
+
+    default:
+      break;
+  }
+
   switch ((enum IfParameter)parameter)
   {
     case IF_BLOCKING:
@@ -265,11 +293,18 @@ static size_t busRead(void *, void *, size_t)
 static size_t busWrite(void *object, const void *buffer, size_t length)
 {
   struct MemoryBusDma * const interface = object;
+  const bool repeat = interface->repeat;
   size_t samples = length >> interface->width;
 
+  interface->repeat = false;
+
   if (!samples)
     return 0;
 
+  /* Source address is fixed when the first element is repeated */
+  if (interface->fixed != repeat)
+    configureDma(interface, repeat);
+
   interface->busy = true;
 
   /* Configure and start control timer */
@@ -293,7 +328,9 @@ static size_t busWrite(void *object, const void *buffer, size_t length)
         chunk << interface->width);
 
     samples -= chunk;
-    position += chunk << interface->width;
+
+    if (!repeat)
+      position += chunk << interface->width;
   }
 
   if (dmaEnable(interface->dma) != E_OK)
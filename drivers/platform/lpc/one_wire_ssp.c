@@ -7,16 +7,38 @@
 #include <dpm/platform/lpc/one_wire_ssp.h>
 #include <halm/platform/lpc/ssp_defs.h>
 #include <xcore/memory.h>
+#include <assert.h>
+#include <stdlib.h>
 /*----------------------------------------------------------------------------*/
-#define DATA_MASK         0x3FC0
-
-#define PATTERN_HIGH      0x7FFF
-#define PATTERN_LOW       0x000F
-#define PATTERN_PRESENCE  0xFFFF
-#define PATTERN_RESET     0x0000
-
-#define RATE_RESET        31250
-#define RATE_DATA         250000
+/*
+ * Each time slot is sent as a 16-bit frame starting with the low level.
+ * Overdrive rate divides a 10 us slot into 16 bits of 625 ns: write-1 and
+ * read slots are 1.25 us low, write-0 slots are 7.5 us low followed by
+ * 2.5 us of recovery, reads are sampled from 1.25 us to 1.875 us.
+ */
+#define MAKE_PATTERN(time, rate) \
+    ((uint16_t)(0xFFFFU >> (((time) * ((rate) / 1000) + 999999) / 1000000)))
+
+#define DATA_MASK               0x3FC0
+#define DATA_MASK_OVERDRIVE     0x2000
+
+#define PATTERN_HIGH            0x7FFF
+#define PATTERN_HIGH_OVERDRIVE  \
+    MAKE_PATTERN(TIME_LOW_1_OVERDRIVE, RATE_DATA_OVERDRIVE)
+#define PATTERN_LOW             0x000F
+#define PATTERN_LOW_OVERDRIVE   \
+    MAKE_PATTERN(TIME_LOW_0_OVERDRIVE, RATE_DATA_OVERDRIVE)
+#define PATTERN_PRESENCE        0xFFFF
+#define PATTERN_RESET           0x0000
+
+#define RATE_RESET              31250
+#define RATE_RESET_OVERDRIVE    250000
+#define RATE_DATA               250000
+#define RATE_DATA_OVERDRIVE     1600000
+
+/* Minimal low times of overdrive slots in nanoseconds */
+#define TIME_LOW_0_OVERDRIVE    7500
+#define TIME_LOW_1_OVERDRIVE    1000
 
 #define TX_QUEUE_LENGTH   24
 /*----------------------------------------------------------------------------*/
@@ -25,7 +47,16 @@ enum Command
   SEARCH_ROM  = 0xF0,
   READ_ROM    = 0x33,
   MATCH_ROM   = 0x55,
-  SKIP_ROM    = 0xCC
+  SKIP_ROM    = 0xCC,
+
+  OVERDRIVE_MATCH_ROM = 0x69,
+  OVERDRIVE_SKIP_ROM  = 0x3C
+};
+
+enum Speed
+{
+  SPEED_STANDARD,
+  SPEED_OVERDRIVE
 };
 
 enum State
@@ -35,9 +66,11 @@ enum State
   STATE_PRESENCE,
   STATE_RECEIVE,
   STATE_TRANSMIT,
+  STATE_OVERDRIVE,
   STATE_SEARCH_START,
   STATE_SEARCH_REQUEST,
   STATE_SEARCH_RESPONSE,
+  STATE_SEARCH_CACHE,
   STATE_ERROR
 };
 /*----------------------------------------------------------------------------*/
@@ -45,10 +78,14 @@ static void adjustPins(struct OneWireSsp *, const struct OneWireSspConfig *);
 static void beginTransmission(struct OneWireSsp *);
 static void sendWord(struct OneWireSsp *, uint8_t);
 static void standardInterruptHandler(void *);
+static void updatePresence(struct OneWireSsp *, bool);
 
+static void appendCachedAddress(struct OneWireSsp *);
+static void cacheInterruptHandler(void *);
 static void searchInterruptHandler(void *);
 static void sendSearchRequest(struct OneWireSsp *);
 static void sendSearchResponse(struct OneWireSsp *, bool);
+static bool serveCachedAddress(struct OneWireSsp *);
 static void startSearch(struct OneWireSsp *);
 /*----------------------------------------------------------------------------*/
 static enum Result oneWireInit(void *, const void *);
@@ -82,7 +119,9 @@ static void beginTransmission(struct OneWireSsp *interface)
 {
   LPC_SSP_Type * const reg = interface->base.reg;
 
-  sspSetRate(&interface->base, RATE_RESET);
+  /* Reset at standard speed also returns all devices to standard speed */
+  sspSetRate(&interface->base, interface->speed == SPEED_OVERDRIVE ?
+      RATE_RESET_OVERDRIVE : RATE_RESET);
   interface->state = STATE_RESET;
 
   /* Clear interrupt flags and enable interrupts */
@@ -96,10 +135,13 @@ static void beginTransmission(struct OneWireSsp *interface)
 static void sendWord(struct OneWireSsp *interface, uint8_t word)
 {
   LPC_SSP_Type * const reg = interface->base.reg;
+  const bool overdrive = interface->speed == SPEED_OVERDRIVE;
+  const uint16_t high = overdrive ? PATTERN_HIGH_OVERDRIVE : PATTERN_HIGH;
+  const uint16_t low = overdrive ? PATTERN_LOW_OVERDRIVE : PATTERN_LOW;
   uint8_t counter = 0;
 
   while (counter < 8)
-    reg->DR = ((word >> counter++) & 0x01) ? PATTERN_HIGH : PATTERN_LOW;
+    reg->DR = ((word >> counter++) & 0x01) ? high : low;
 }
 /*----------------------------------------------------------------------------*/
 static void standardInterruptHandler(void *object)
@@ -115,9 +157,14 @@ static void standardInterruptHandler(void *object)
     switch ((enum State)interface->state)
     {
       case STATE_RECEIVE:
-        if (!(data & DATA_MASK))
+      {
+        const uint16_t mask = interface->speed == SPEED_OVERDRIVE ?
+            DATA_MASK_OVERDRIVE : DATA_MASK;
+
+        if (!(data & mask))
           interface->word |= 1 << interface->bit;
         [[fallthrough]];
+      }
       case STATE_TRANSMIT:
         if (++interface->bit == 8)
         {
@@ -135,21 +182,52 @@ static void standardInterruptHandler(void *object)
         }
         break;
 
+      case STATE_OVERDRIVE:
+        /* Overdrive ROM command is sent at standard speed */
+        if (++interface->bit == 8)
+        {
+          sspSetRate(&interface->base, RATE_DATA_OVERDRIVE);
+
+          interface->bit = 0;
+          interface->speed = SPEED_OVERDRIVE;
+          interface->state = STATE_TRANSMIT;
+          --interface->left;
+        }
+        break;
+
       case STATE_RESET:
         interface->state = STATE_PRESENCE;
         break;
 
       case STATE_PRESENCE:
       {
+        updatePresence(interface, (data & DATA_MASK) != 0);
+
         if (data & DATA_MASK)
         {
-          sspSetRate(&interface->base, RATE_DATA);
-
           interface->bit = 0;
-          interface->state = STATE_TRANSMIT;
+
+          if (interface->speed == SPEED_OVERDRIVE)
+          {
+            sspSetRate(&interface->base, RATE_DATA_OVERDRIVE);
+            interface->state = STATE_TRANSMIT;
+          }
+          else if (interface->overdrive)
+          {
+            sspSetRate(&interface->base, RATE_DATA);
+            interface->state = STATE_OVERDRIVE;
+            sendWord(interface, byteQueuePopFront(&interface->txQueue));
+          }
+          else
+          {
+            sspSetRate(&interface->base, RATE_DATA);
+            interface->state = STATE_TRANSMIT;
+          }
         }
         else
         {
+          /* Devices may have returned to standard speed after power loss */
+          interface->speed = SPEED_STANDARD;
           interface->state = STATE_ERROR;
           event = true;
         }
@@ -180,6 +258,41 @@ static void standardInterruptHandler(void *object)
   }
 }
 /*----------------------------------------------------------------------------*/
+static void updatePresence(struct OneWireSsp *interface, bool present)
+{
+  /*
+   * Presence pulse only shows whether the bus is empty, devices added to
+   * or removed from a non-empty bus are not detected.
+   */
+  if (interface->present != present)
+  {
+    interface->present = present;
+    interface->cacheValid = false;
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void appendCachedAddress(struct OneWireSsp *interface)
+{
+  if (interface->cacheCount < interface->cacheCapacity)
+  {
+    interface->cache[interface->cacheCount++] = interface->address;
+    interface->cachePosition = interface->cacheCount;
+
+    /* Enumeration is complete when there are no unexplored branches */
+    interface->cacheValid = interface->lastDiscrepancy == 0;
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void cacheInterruptHandler(void *object)
+{
+  struct OneWireSsp * const interface = object;
+
+  interface->state = STATE_IDLE;
+
+  if (interface->callback != NULL)
+    interface->callback(interface->callbackArgument);
+}
+/*----------------------------------------------------------------------------*/
 static void searchInterruptHandler(void *object)
 {
   struct OneWireSsp * const interface = object;
@@ -213,6 +326,7 @@ static void searchInterruptHandler(void *object)
         {
           interface->lastDiscrepancy = interface->lastZero;
           interface->state = STATE_IDLE;
+          appendCachedAddress(interface);
           event = true;
         }
         else
@@ -227,6 +341,8 @@ static void searchInterruptHandler(void *object)
 
       case STATE_PRESENCE:
       {
+        updatePresence(interface, (data & DATA_MASK) != 0);
+
         if (data & DATA_MASK)
         {
           sspSetRate(&interface->base, RATE_DATA);
@@ -327,8 +443,29 @@ static void sendSearchResponse(struct OneWireSsp *interface, bool value)
   reg->DR = value ? PATTERN_HIGH : PATTERN_LOW;
 }
 /*----------------------------------------------------------------------------*/
+static bool serveCachedAddress(struct OneWireSsp *interface)
+{
+  if (interface->cachePosition == interface->cacheCount)
+    return false;
+
+  interface->address = interface->cache[interface->cachePosition++];
+
+  /*
+   * Completion is reported from the interrupt as for a bus search,
+   * this way the callback may request the next address without recursion.
+   */
+  interface->base.handler = cacheInterruptHandler;
+  interface->state = STATE_SEARCH_CACHE;
+  irqSetPending(interface->base.irq);
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
 static void startSearch(struct OneWireSsp *interface)
 {
+  /* Search is always performed at standard speed */
+  interface->speed = SPEED_STANDARD;
+
   /* Configure interrupts and start transmission */
   interface->base.handler = searchInterruptHandler;
 
@@ -339,6 +476,7 @@ static enum Result oneWireInit(void *object, const void *configBase)
 {
   const struct OneWireSspConfig * const config = configBase;
   assert(config != NULL);
+  assert(config->cache <= UINT8_MAX);
 
   const struct SspBaseConfig baseConfig = {
       .channel = config->channel,
@@ -359,6 +497,15 @@ static enum Result oneWireInit(void *object, const void *configBase)
   if (!byteQueueInit(&interface->txQueue, TX_QUEUE_LENGTH))
     return E_MEMORY;
 
+  if (config->cache)
+  {
+    interface->cache = malloc(sizeof(uint64_t) * config->cache);
+    if (interface->cache == NULL)
+      return E_MEMORY;
+  }
+  else
+    interface->cache = NULL;
+
   interface->callback = NULL;
   interface->callbackArgument = NULL;
   interface->address = 0;
@@ -370,6 +517,13 @@ static enum Result oneWireInit(void *object, const void *configBase)
   interface->blocking = true;
   interface->lastDiscrepancy = 0;
   interface->lastZero = 0;
+  interface->cacheCapacity = (uint8_t)config->cache;
+  interface->cacheCount = 0;
+  interface->cachePosition = 0;
+  interface->cacheValid = false;
+  interface->present = false;
+  interface->overdrive = false;
+  interface->speed = SPEED_STANDARD;
 
   LPC_SSP_Type * const reg = interface->base.reg;
 
@@ -399,6 +553,7 @@ static void oneWireDeinit(void *object)
   irqDisable(interface->base.irq);
   reg->CR1 = 0;
 
+  free(interface->cache);
   byteQueueDeinit(&interface->txQueue);
   SspBase->deinit(interface);
 }
@@ -441,12 +596,22 @@ static enum Result oneWireSetParam(void *object, int parameter,
   switch ((enum OneWireParameter)parameter)
   {
     case IF_ONE_WIRE_START_SEARCH:
+      /*
+       * Presence pulse does not show devices attached to or detached from
+       * a non-empty bus, therefore an explicit search always walks the bus
+       * and rebuilds the cache.
+       */
       interface->address = 0;
+      interface->cacheCount = 0;
+      interface->cacheValid = false;
       interface->lastDiscrepancy = 0;
       startSearch(interface);
       return E_OK;
 
     case IF_ONE_WIRE_FIND_NEXT:
+      if (interface->cacheValid)
+        return serveCachedAddress(interface) ? E_OK : E_EMPTY;
+
       if (interface->lastDiscrepancy)
       {
         startSearch(interface);
@@ -455,6 +620,20 @@ static enum Result oneWireSetParam(void *object, int parameter,
       else
         return E_EMPTY;
 
+    case IF_ONE_WIRE_INVALIDATE:
+      interface->cacheCount = 0;
+      interface->cacheValid = false;
+      return E_OK;
+
+    case IF_ONE_WIRE_OVERDRIVE:
+      interface->overdrive = true;
+      return E_OK;
+
+    case IF_ONE_WIRE_STANDARD:
+      interface->overdrive = false;
+      interface->speed = SPEED_STANDARD;
+      return E_OK;
+
     default:
       break;
   }
@@ -530,16 +709,22 @@ static size_t oneWireWrite(void *object, const void *buffer, size_t length)
   interface->bit = 0;
   interface->left = 1;
 
+  /* Devices are switched to overdrive speed with special ROM commands */
+  const bool enter = interface->overdrive
+      && interface->speed == SPEED_STANDARD;
+
   /* Select the addressing mode */
   if (interface->address)
   {
-    byteQueuePushBack(&interface->txQueue, MATCH_ROM);
+    byteQueuePushBack(&interface->txQueue,
+        enter ? OVERDRIVE_MATCH_ROM : MATCH_ROM);
     interface->left += byteQueuePushArray(&interface->txQueue,
         &interface->address, sizeof(interface->address));
   }
   else
   {
-    byteQueuePushBack(&interface->txQueue, SKIP_ROM);
+    byteQueuePushBack(&interface->txQueue,
+        enter ? OVERDRIVE_SKIP_ROM : SKIP_ROM);
   }
 
   /* Push data into the transmit queue */
@@ -0,0 +1,202 @@
+/*
+ * regmap.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#include <dpm/regmap.h>
+#include <xcore/accel.h>
+#include <assert.h>
+#include <string.h>
+/*----------------------------------------------------------------------------*/
+static size_t findFirstDirty(const struct RegMap *);
+static inline bool isDirty(const struct RegMap *, size_t);
+static void markRange(struct RegMap *, size_t, size_t, bool);
+/*----------------------------------------------------------------------------*/
+static size_t findFirstDirty(const struct RegMap *map)
+{
+  for (size_t index = 0; index < REGMAP_WORDS((size_t)map->count); ++index)
+  {
+    const uint32_t word = map->dirty[index];
+
+    if (word)
+    {
+      return index * REGMAP_WORD_WIDTH
+          + countLeadingZeros32(reverseBits32(word));
+    }
+  }
+
+  return map->count;
+}
+/*----------------------------------------------------------------------------*/
+static inline bool isDirty(const struct RegMap *map, size_t position)
+{
+  const uint32_t mask = 1UL << (position % REGMAP_WORD_WIDTH);
+  return (map->dirty[position / REGMAP_WORD_WIDTH] & mask) != 0;
+}
+/*----------------------------------------------------------------------------*/
+static void markRange(struct RegMap *map, size_t position, size_t count,
+    bool value)
+{
+  for (size_t index = position; index < position + count; ++index)
+  {
+    const uint32_t mask = 1UL << (index % REGMAP_WORD_WIDTH);
+
+    if (value)
+      map->dirty[index / REGMAP_WORD_WIDTH] |= mask;
+    else
+      map->dirty[index / REGMAP_WORD_WIDTH] &= ~mask;
+  }
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Initialize the register map. All registers are set to zero and marked
+ * as dirty because the state of the device is unknown.
+ * @param map Pointer to a RegMap object.
+ * @param values Storage for register values, @b count bytes.
+ * @param dirty Storage for dirty flags, @b REGMAP_WORDS(count) words.
+ * @param first Address of the first register.
+ * @param count Number of registers.
+ * @param gap Maximum number of clean registers between dirty ones that
+ * are rewritten to join two runs into a single transfer.
+ */
+void regmapInit(struct RegMap *map, uint8_t *values, uint32_t *dirty,
+    uint8_t first, size_t count, size_t gap)
+{
+  assert(count > 0 && first + count <= 256);
+  assert(gap <= UINT8_MAX);
+
+  map->values = values;
+  map->dirty = dirty;
+  map->first = first;
+  map->gap = (uint8_t)gap;
+  map->count = (uint16_t)count;
+
+  memset(values, 0, count);
+  markRange(map, 0, count, true);
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Mark registers as dirty. Should be called when the state of the device
+ * becomes unknown, for example after a bus error, or for registers
+ * that should be rewritten even when their values are unchanged.
+ * @param map Pointer to a RegMap object.
+ * @param address Address of the first register.
+ * @param count Number of registers.
+ */
+void regmapInvalidate(struct RegMap *map, uint8_t address, size_t count)
+{
+  assert(address >= map->first);
+  assert(address - map->first + count <= map->count);
+
+  markRange(map, address - map->first, count, true);
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Load reset values of the device registers. All registers are marked
+ * as clean, registers missing from the table are assumed to be zero.
+ * @param map Pointer to a RegMap object.
+ * @param table Table with register reset values.
+ * @param count Number of table entries.
+ */
+void regmapLoad(struct RegMap *map, const struct RegMapDefault *table,
+    size_t count)
+{
+  memset(map->values, 0, map->count);
+
+  for (size_t index = 0; index < count; ++index)
+  {
+    assert(table[index].address >= map->first);
+    assert(table[index].address - map->first < map->count);
+
+    map->values[table[index].address - map->first] = table[index].value;
+  }
+
+  markRange(map, 0, map->count, false);
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Prepare a write transfer for the lowest run of dirty registers.
+ * The buffer is filled with the address of the first register followed
+ * by register values, dirty flags of the registers are cleared.
+ * @param map Pointer to a RegMap object.
+ * @param buffer Output buffer.
+ * @param capacity Size of the output buffer, at least two bytes.
+ * @return Length of the transfer or zero when all registers are clean.
+ */
+size_t regmapPrepare(struct RegMap *map, uint8_t *buffer, size_t capacity)
+{
+  assert(capacity >= 2);
+
+  const size_t start = findFirstDirty(map);
+
+  if (start == map->count)
+    return 0;
+
+  const size_t limit = MIN(map->count, start + capacity - 1);
+  size_t end = start + 1;
+  size_t clean = 0;
+
+  for (size_t index = end; index < limit; ++index)
+  {
+    if (isDirty(map, index))
+    {
+      end = index + 1;
+      clean = 0;
+    }
+    else if (++clean > map->gap)
+      break;
+  }
+
+  markRange(map, start, end - start, false);
+
+  buffer[0] = (uint8_t)(map->first + start);
+  memcpy(buffer + 1, map->values + start, end - start);
+
+  return 1 + end - start;
+}
+/*----------------------------------------------------------------------------*/
+uint8_t regmapRead(const struct RegMap *map, uint8_t address)
+{
+  assert(address >= map->first && address - map->first < map->count);
+  return map->values[address - map->first];
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Update selected bits of a register.
+ * @param map Pointer to a RegMap object.
+ * @param address Register address.
+ * @param mask Bit mask of the updated bits.
+ * @param value New values of the bits.
+ * @return @b true when the register value was changed.
+ */
+bool regmapUpdate(struct RegMap *map, uint8_t address, uint8_t mask,
+    uint8_t value)
+{
+  const uint8_t previous = regmapRead(map, address);
+  return regmapWrite(map, address, (previous & ~mask) | (value & mask));
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Write a register value to the shadow, the register is marked as dirty
+ * only when the value differs from the cached one.
+ * @param map Pointer to a RegMap object.
+ * @param address Register address.
+ * @param value New register value.
+ * @return @b true when the register value was changed.
+ */
+bool regmapWrite(struct RegMap *map, uint8_t address, uint8_t value)
+{
+  assert(address >= map->first && address - map->first < map->count);
+
+  const size_t position = address - map->first;
+
+  if (map->values[position] != value)
+  {
+    map->values[position] = value;
+    markRange(map, position, 1, true);
+    return true;
+  }
+  else
+    return false;
+}
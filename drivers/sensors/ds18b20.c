@@ -5,34 +5,13 @@
  */
 
 #include <dpm/sensors/ds18b20.h>
+#include <dpm/sensors/ds18b20_defs.h>
 #include <halm/timer.h>
 #include <xcore/atomic.h>
 #include <xcore/crc/crc8_maxim.h>
 #include <xcore/interface.h>
 #include <assert.h>
 /*----------------------------------------------------------------------------*/
-#define CRC8_INITIAL            0x00
-
-#define LENGTH_READ_SCRATCHPAD  1
-#define LENGTH_SCRATCHPAD       9
-#define LENGTH_START_CONVERSION 1
-#define LENGTH_WRITE_SCRATCHPAD 4
-
-enum
-{
-  CMD_READ_SCRATCHPAD   = 0xBE,
-  CMD_START_CONVERSION  = 0x44,
-  CMD_WRITE_SCRATCHPAD  = 0x4E
-};
-
-enum
-{
-  FLAG_RESET  = 0x01,
-  FLAG_READY  = 0x02,
-  FLAG_LOOP   = 0x04,
-  FLAG_SAMPLE = 0x08
-};
-
 enum State
 {
   STATE_IDLE,
@@ -63,6 +42,7 @@ static void startTemperatureRequest(struct DS18B20 *);
 
 static enum Result dsInit(void *, const void *);
 static void dsDeinit(void *);
+static const struct SensorDescriptor *dsGetDescriptor(const void *);
 static const char *dsGetFormat(const void *);
 static enum SensorStatus dsGetStatus(const void *);
 static uint64_t dsGetTimestamp(const void *);
@@ -83,6 +63,7 @@ const struct SensorClass * const DS18B20 = &(const struct SensorClass){
     .init = dsInit,
     .deinit = dsDeinit,
 
+    .getDescriptor = dsGetDescriptor,
     .getFormat = dsGetFormat,
     .getStatus = dsGetStatus,
     .getTimestamp = dsGetTimestamp,
@@ -313,6 +294,18 @@ static void dsDeinit(void *object)
   timerSetCallback(sensor->timer, NULL, NULL);
 }
 /*----------------------------------------------------------------------------*/
+static const struct SensorDescriptor *dsGetDescriptor(const void *)
+{
+  static const struct SensorDescriptor descriptor = {
+      .type = SENSOR_TYPE_INT32,
+      .count = 1,
+      .exponent = -8,
+      .unit = SENSOR_UNIT_CELSIUS
+  };
+
+  return &descriptor;
+}
+/*----------------------------------------------------------------------------*/
 static const char *dsGetFormat(const void *)
 {
   return "i24q8";
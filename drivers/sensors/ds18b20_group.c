@@ -0,0 +1,553 @@
+/*
+ * ds18b20_group.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#include <dpm/sensors/ds18b20_defs.h>
+#include <dpm/sensors/ds18b20_group.h>
+#include <halm/timer.h>
+#include <xcore/atomic.h>
+#include <xcore/crc/crc8_maxim.h>
+#include <xcore/interface.h>
+#include <assert.h>
+#include <stdlib.h>
+/*----------------------------------------------------------------------------*/
+enum State
+{
+  STATE_IDLE,
+  STATE_CONFIG_WRITE,
+  STATE_CONFIG_WRITE_WAIT,
+  STATE_CONVERSION,
+  STATE_CONVERSION_WAIT,
+  STATE_WAIT_START,
+  STATE_WAIT,
+  STATE_NEXT,
+  STATE_REQUEST,
+  STATE_REQUEST_WAIT,
+  STATE_READ,
+  STATE_READ_WAIT,
+  STATE_PROCESS,
+
+  STATE_ERROR_INTERFACE,
+  STATE_ERROR_TIMEOUT
+};
+/*----------------------------------------------------------------------------*/
+static void busInit(struct DS18B20Group *, uint64_t);
+static inline uint32_t calcBusTimeout(const struct Timer *);
+static void calcTemperature(struct DS18B20Group *,
+    struct DS18B20GroupSensor *);
+static struct DS18B20GroupSensor *findNextSensor(struct DS18B20Group *);
+static void invokeUpdate(struct DS18B20Group *);
+static bool isSamplingRequired(const struct DS18B20Group *);
+static void onBusEvent(void *);
+static void onTimerEvent(void *);
+static inline uint8_t resolutionToConfig(const struct DS18B20Group *);
+static inline uint32_t resolutionToTime(const struct DS18B20Group *);
+static void startConfigWrite(struct DS18B20Group *);
+static void startScratchpadRead(struct DS18B20Group *);
+static void startScratchpadRequest(struct DS18B20Group *, uint64_t);
+static void startTemperatureConversion(struct DS18B20Group *);
+
+static enum Result groupInit(void *, const void *);
+static void groupDeinit(void *);
+/*----------------------------------------------------------------------------*/
+const struct EntityClass * const DS18B20Group = &(const struct EntityClass){
+    .size = sizeof(struct DS18B20Group),
+    .init = groupInit,
+    .deinit = groupDeinit
+};
+/*----------------------------------------------------------------------------*/
+static void busInit(struct DS18B20Group *group, uint64_t address)
+{
+  /* Lock the interface */
+  ifSetParam(group->bus, IF_ACQUIRE, NULL);
+
+  /* Zero address selects all devices on the bus with SKIP ROM command */
+  ifSetParam(group->bus, IF_ADDRESS_64, &address);
+  ifSetParam(group->bus, IF_ZEROCOPY, NULL);
+  ifSetCallback(group->bus, onBusEvent, group);
+
+  /* Start bus watchdog */
+  timerSetOverflow(group->timer, calcBusTimeout(group->timer));
+  timerSetValue(group->timer, 0);
+  timerEnable(group->timer);
+}
+/*----------------------------------------------------------------------------*/
+static inline uint32_t calcBusTimeout(const struct Timer *timer)
+{
+  /* Longest transfer with a reset pulse takes about 7 ms */
+  static const uint32_t busTimeoutFreq = 10; /* Hz */
+  return (timerGetFrequency(timer) + (busTimeoutFreq - 1)) / busTimeoutFreq;
+}
+/*----------------------------------------------------------------------------*/
+static void calcTemperature(struct DS18B20Group *group,
+    struct DS18B20GroupSensor *sensor)
+{
+  const uint8_t * const buffer = group->buffer;
+  const uint8_t checksum = crc8MaximUpdate(CRC8_INITIAL,
+      buffer, LENGTH_SCRATCHPAD - 1);
+
+  if (checksum == buffer[LENGTH_SCRATCHPAD - 1])
+  {
+    const uint16_t value = (buffer[1] << 8) | buffer[0];
+    const int32_t result = (int32_t)((int16_t)value * 16);
+
+    sensor->onResultCallback(sensor->callbackArgument, &result, sizeof(result));
+  }
+  else
+  {
+    if (sensor->onErrorCallback != NULL)
+      sensor->onErrorCallback(sensor->callbackArgument, SENSOR_DATA_ERROR);
+  }
+}
+/*----------------------------------------------------------------------------*/
+static struct DS18B20GroupSensor *findNextSensor(struct DS18B20Group *group)
+{
+  while (group->position < group->count)
+  {
+    struct DS18B20GroupSensor * const sensor = group->sensors[group->position];
+
+    if (atomicLoad(&sensor->flags) & (FLAG_LOOP | FLAG_SAMPLE))
+      return sensor;
+
+    ++group->position;
+  }
+
+  return NULL;
+}
+/*----------------------------------------------------------------------------*/
+static void invokeUpdate(struct DS18B20Group *group)
+{
+  struct DS18B20GroupSensor * const sensor = group->active;
+
+  if (sensor != NULL && sensor->onUpdateCallback != NULL)
+    sensor->onUpdateCallback(sensor->callbackArgument);
+}
+/*----------------------------------------------------------------------------*/
+static bool isSamplingRequired(const struct DS18B20Group *group)
+{
+  for (size_t index = 0; index < group->count; ++index)
+  {
+    if (atomicLoad(&group->sensors[index]->flags) & (FLAG_LOOP | FLAG_SAMPLE))
+      return true;
+  }
+
+  return false;
+}
+/*----------------------------------------------------------------------------*/
+static void onBusEvent(void *object)
+{
+  struct DS18B20Group * const group = object;
+  bool release = true;
+
+  timerDisable(group->timer);
+
+  if (ifGetParam(group->bus, IF_STATUS, NULL) != E_OK)
+    group->state = STATE_ERROR_INTERFACE;
+
+  switch (group->state)
+  {
+    case STATE_CONFIG_WRITE_WAIT:
+      atomicFetchOr(&group->flags, FLAG_READY);
+      group->state = STATE_IDLE;
+      break;
+
+    case STATE_CONVERSION_WAIT:
+      group->state = STATE_WAIT_START;
+      break;
+
+    case STATE_REQUEST_WAIT:
+      group->state = STATE_READ;
+      release = false;
+      break;
+
+    case STATE_READ_WAIT:
+      group->state = STATE_PROCESS;
+      break;
+
+    default:
+      break;
+  }
+
+  if (release)
+  {
+    ifSetCallback(group->bus, NULL, NULL);
+    ifSetParam(group->bus, IF_RELEASE, NULL);
+  }
+
+  invokeUpdate(group);
+}
+/*----------------------------------------------------------------------------*/
+static void onTimerEvent(void *object)
+{
+  struct DS18B20Group * const group = object;
+
+  if (group->state == STATE_WAIT)
+  {
+    /* Conversion is finished */
+    group->position = 0;
+    group->state = STATE_NEXT;
+  }
+  else
+  {
+    ifSetCallback(group->bus, NULL, NULL);
+    ifSetParam(group->bus, IF_RELEASE, NULL);
+    group->state = STATE_ERROR_TIMEOUT;
+  }
+
+  invokeUpdate(group);
+}
+/*----------------------------------------------------------------------------*/
+static inline uint8_t resolutionToConfig(const struct DS18B20Group *group)
+{
+  uint8_t config = 0x7F;
+
+  switch (group->resolution)
+  {
+    case DS18B20_RESOLUTION_9BIT:
+      config = 0x1F;
+      break;
+
+    case DS18B20_RESOLUTION_10BIT:
+      config = 0x3F;
+      break;
+
+    case DS18B20_RESOLUTION_11BIT:
+      config = 0x5F;
+      break;
+
+    default:
+      break;
+  }
+
+  return config;
+}
+/*----------------------------------------------------------------------------*/
+static inline uint32_t resolutionToTime(const struct DS18B20Group *group)
+{
+  const uint32_t frequency = timerGetFrequency(group->timer);
+  uint64_t overflow;
+
+  switch (group->resolution)
+  {
+    case DS18B20_RESOLUTION_9BIT:
+      /* 93.75 ms */
+      overflow = frequency * ((9375 * (1ULL << 32)) / 100000);
+      break;
+
+    case DS18B20_RESOLUTION_10BIT:
+      /* 187.5 ms */
+      overflow = frequency * ((18750 * (1ULL << 32)) / 100000);
+      break;
+
+    case DS18B20_RESOLUTION_11BIT:
+      /* 375 ms */
+      overflow = frequency * ((37500 * (1ULL << 32)) / 100000);
+      break;
+
+    default:
+      /* Default overflow period is 750 ms */
+      overflow = frequency * ((75000 * (1ULL << 32)) / 100000);
+      break;
+  }
+
+  return (overflow + ((1ULL << 32) - 1)) >> 32;
+}
+/*----------------------------------------------------------------------------*/
+static void startConfigWrite(struct DS18B20Group *group)
+{
+  group->buffer[0] = CMD_WRITE_SCRATCHPAD;
+  group->buffer[1] = -55;
+  group->buffer[2] = 125;
+  group->buffer[3] = resolutionToConfig(group);
+
+  /* Configure all devices at once */
+  busInit(group, 0);
+  ifWrite(group->bus, group->buffer, LENGTH_WRITE_SCRATCHPAD);
+}
+/*----------------------------------------------------------------------------*/
+static void startScratchpadRead(struct DS18B20Group *group)
+{
+  /* Continue interface read */
+  ifRead(group->bus, group->buffer, LENGTH_SCRATCHPAD);
+}
+/*----------------------------------------------------------------------------*/
+static void startScratchpadRequest(struct DS18B20Group *group,
+    uint64_t address)
+{
+  group->buffer[0] = CMD_READ_SCRATCHPAD;
+
+  busInit(group, address);
+  ifWrite(group->bus, group->buffer, LENGTH_READ_SCRATCHPAD);
+}
+/*----------------------------------------------------------------------------*/
+static void startTemperatureConversion(struct DS18B20Group *group)
+{
+  group->buffer[0] = CMD_START_CONVERSION;
+
+  /* Start conversion on all devices at once */
+  busInit(group, 0);
+  ifWrite(group->bus, group->buffer, LENGTH_START_CONVERSION);
+}
+/*----------------------------------------------------------------------------*/
+static enum Result groupInit(void *object, const void *configBase)
+{
+  const struct DS18B20GroupConfig * const config = configBase;
+  assert(config != NULL);
+  assert(config->bus != NULL);
+  assert(config->timer != NULL);
+  assert(config->capacity > 0);
+
+  struct DS18B20Group * const group = object;
+
+  group->sensors = malloc(sizeof(struct DS18B20GroupSensor *)
+      * config->capacity);
+  if (group->sensors == NULL)
+    return E_MEMORY;
+
+  group->active = NULL;
+  group->bus = config->bus;
+  group->timer = config->timer;
+
+  group->capacity = config->capacity;
+  group->count = 0;
+  group->position = 0;
+
+  group->flags = 0;
+  group->state = STATE_IDLE;
+
+  if (config->resolution != DS18B20_RESOLUTION_DEFAULT)
+    group->resolution = (uint8_t)config->resolution;
+  else
+    group->resolution = DS18B20_RESOLUTION_12BIT;
+
+  timerSetAutostop(group->timer, true);
+  timerSetCallback(group->timer, onTimerEvent, group);
+
+  return E_OK;
+}
+/*----------------------------------------------------------------------------*/
+static void groupDeinit(void *object)
+{
+  struct DS18B20Group * const group = object;
+
+  timerDisable(group->timer);
+  timerSetCallback(group->timer, NULL, NULL);
+
+  for (size_t index = 0; index < group->count; ++index)
+    deinit(group->sensors[index]);
+
+  free(group->sensors);
+}
+/*----------------------------------------------------------------------------*/
+enum SensorStatus ds18b20GroupGetStatus(const struct DS18B20Group *group)
+{
+  return group->state == STATE_IDLE ? SENSOR_IDLE : SENSOR_BUSY;
+}
+/*----------------------------------------------------------------------------*/
+void ds18b20GroupReset(struct DS18B20Group *group,
+    struct DS18B20GroupSensor *sensor)
+{
+  /* Proxy that owns a running operation is notified about the request */
+  if (group->state == STATE_IDLE)
+    group->active = sensor;
+
+  atomicFetchOr(&group->flags, FLAG_RESET);
+  invokeUpdate(group);
+}
+/*----------------------------------------------------------------------------*/
+void ds18b20GroupSample(struct DS18B20Group *group,
+    struct DS18B20GroupSensor *sensor)
+{
+  if (group->state == STATE_IDLE)
+    group->active = sensor;
+
+  invokeUpdate(group);
+}
+/*----------------------------------------------------------------------------*/
+void ds18b20GroupStart(struct DS18B20Group *group,
+    struct DS18B20GroupSensor *sensor)
+{
+  if (group->state == STATE_IDLE)
+    group->active = sensor;
+
+  invokeUpdate(group);
+}
+/*----------------------------------------------------------------------------*/
+void ds18b20GroupStop(struct DS18B20Group *group)
+{
+  invokeUpdate(group);
+}
+/*----------------------------------------------------------------------------*/
+bool ds18b20GroupUpdate(struct DS18B20Group *group,
+    struct DS18B20GroupSensor *sensor)
+{
+  bool busy;
+  bool updated;
+
+  /*
+   * Operations are driven by the proxy that started them. Requests of other
+   * proxies stay in their flags and are served by the next conversion.
+   */
+  if (group->state != STATE_IDLE && group->active != sensor)
+    return false;
+
+  do
+  {
+    busy = false;
+    updated = false;
+
+    switch ((enum State)group->state)
+    {
+      case STATE_IDLE:
+      {
+        const uint8_t flags = atomicLoad(&group->flags);
+
+        if (flags & FLAG_RESET)
+        {
+          group->active = sensor;
+          group->state = STATE_CONFIG_WRITE;
+          updated = true;
+        }
+        else if ((flags & FLAG_READY) && isSamplingRequired(group))
+        {
+          group->active = sensor;
+          group->state = STATE_CONVERSION;
+          updated = true;
+        }
+        break;
+      }
+
+      case STATE_CONFIG_WRITE:
+        group->state = STATE_CONFIG_WRITE_WAIT;
+        atomicFetchAnd(&group->flags, ~(FLAG_RESET | FLAG_READY));
+        startConfigWrite(group);
+        busy = true;
+        break;
+
+      case STATE_CONFIG_WRITE_WAIT:
+        busy = true;
+        break;
+
+      case STATE_CONVERSION:
+        group->state = STATE_CONVERSION_WAIT;
+        startTemperatureConversion(group);
+        busy = true;
+        break;
+
+      case STATE_CONVERSION_WAIT:
+        busy = true;
+        break;
+
+      case STATE_WAIT_START:
+        group->state = STATE_WAIT;
+
+        timerSetOverflow(group->timer, resolutionToTime(group));
+        timerSetValue(group->timer, 0);
+        timerEnable(group->timer);
+        break;
+
+      case STATE_WAIT:
+        break;
+
+      case STATE_NEXT:
+      {
+        const struct DS18B20GroupSensor * const sensor =
+            findNextSensor(group);
+
+        group->state = sensor != NULL ? STATE_REQUEST : STATE_IDLE;
+        updated = true;
+        break;
+      }
+
+      case STATE_REQUEST:
+        group->state = STATE_REQUEST_WAIT;
+        startScratchpadRequest(group,
+            group->sensors[group->position]->address);
+        busy = true;
+        break;
+
+      case STATE_REQUEST_WAIT:
+        busy = true;
+        break;
+
+      case STATE_READ:
+        group->state = STATE_READ_WAIT;
+        startScratchpadRead(group);
+        busy = true;
+        break;
+
+      case STATE_READ_WAIT:
+        busy = true;
+        break;
+
+      case STATE_PROCESS:
+      {
+        struct DS18B20GroupSensor * const sensor =
+            group->sensors[group->position++];
+
+        calcTemperature(group, sensor);
+        atomicFetchAnd(&sensor->flags, ~FLAG_SAMPLE);
+
+        group->state = STATE_NEXT;
+        updated = true;
+        break;
+      }
+
+      case STATE_ERROR_INTERFACE:
+      case STATE_ERROR_TIMEOUT:
+        if (group->active->onErrorCallback != NULL)
+        {
+          group->active->onErrorCallback(group->active->callbackArgument,
+              group->state == STATE_ERROR_INTERFACE ?
+                  SENSOR_INTERFACE_ERROR : SENSOR_INTERFACE_TIMEOUT);
+        }
+
+        group->state = STATE_IDLE;
+        updated = true;
+        break;
+    }
+  }
+  while (updated);
+
+  return busy;
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Create a sensor proxy for a device on the bus of the group.
+ * @param group Pointer to a DS18B20Group object.
+ * @param address Device address.
+ * @return Pointer to a sensor proxy on success or @b NULL when the group
+ * is full or the proxy could not be created.
+ */
+struct DS18B20GroupSensor *ds18b20GroupMakeSensor(struct DS18B20Group *group,
+    uint64_t address)
+{
+  assert(address != 0);
+
+  for (size_t index = 0; index < group->count; ++index)
+  {
+    if (group->sensors[index]->address == address)
+      return group->sensors[index];
+  }
+
+  if (group->count == group->capacity)
+    return NULL;
+
+  const struct DS18B20GroupSensorConfig config = {
+      .parent = group,
+      .address = address
+  };
+  struct DS18B20GroupSensor * const sensor = init(DS18B20GroupSensor, &config);
+
+  if (sensor != NULL)
+  {
+    group->sensors[group->count++] = sensor;
+
+    if (group->active == NULL)
+      group->active = sensor;
+  }
+
+  return sensor;
+}
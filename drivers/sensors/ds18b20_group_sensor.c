@@ -0,0 +1,177 @@
+/*
+ * ds18b20_group_sensor.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#include <dpm/sensors/ds18b20_defs.h>
+#include <dpm/sensors/ds18b20_group.h>
+#include <xcore/atomic.h>
+#include <assert.h>
+/*----------------------------------------------------------------------------*/
+static enum Result proxyInit(void *, const void *);
+static void proxyDeinit(void *);
+static const struct SensorDescriptor *proxyGetDescriptor(const void *);
+static const char *proxyGetFormat(const void *);
+static enum SensorStatus proxyGetStatus(const void *);
+static uint64_t proxyGetTimestamp(const void *);
+static void proxySetCallbackArgument(void *, void *);
+static void proxySetErrorCallback(void *, void (*)(void *, enum SensorResult));
+static void proxySetResultCallback(void *,
+    void (*)(void *, const void *, size_t));
+static void proxySetUpdateCallback(void *, void (*)(void *));
+static void proxyReset(void *);
+static void proxySample(void *);
+static void proxyStart(void *);
+static void proxyStop(void *);
+static void proxySuspend(void *);
+static bool proxyUpdate(void *);
+/*----------------------------------------------------------------------------*/
+const struct SensorClass * const DS18B20GroupSensor =
+    &(const struct SensorClass){
+    .size = sizeof(struct DS18B20GroupSensor),
+    .init = proxyInit,
+    .deinit = proxyDeinit,
+
+    .getDescriptor = proxyGetDescriptor,
+    .getFormat = proxyGetFormat,
+    .getStatus = proxyGetStatus,
+    .getTimestamp = proxyGetTimestamp,
+    .setCallbackArgument = proxySetCallbackArgument,
+    .setErrorCallback = proxySetErrorCallback,
+    .setResultCallback = proxySetResultCallback,
+    .setUpdateCallback = proxySetUpdateCallback,
+    .reset = proxyReset,
+    .sample = proxySample,
+    .start = proxyStart,
+    .stop = proxyStop,
+    .suspend = proxySuspend,
+    .update = proxyUpdate
+};
+/*----------------------------------------------------------------------------*/
+static enum Result proxyInit(void *object, const void *configBase)
+{
+  const struct DS18B20GroupSensorConfig * const config = configBase;
+  assert(config != NULL);
+  assert(config->parent != NULL);
+
+  struct DS18B20GroupSensor * const proxy = object;
+
+  proxy->callbackArgument = NULL;
+  proxy->onErrorCallback = NULL;
+  proxy->onResultCallback = NULL;
+  proxy->onUpdateCallback = NULL;
+  proxy->parent = config->parent;
+  proxy->address = config->address;
+  proxy->flags = 0;
+
+  return E_OK;
+}
+/*----------------------------------------------------------------------------*/
+static void proxyDeinit(void *)
+{
+}
+/*----------------------------------------------------------------------------*/
+static const struct SensorDescriptor *proxyGetDescriptor(const void *)
+{
+  static const struct SensorDescriptor descriptor = {
+      .type = SENSOR_TYPE_INT32,
+      .count = 1,
+      .exponent = -8,
+      .unit = SENSOR_UNIT_CELSIUS
+  };
+
+  return &descriptor;
+}
+/*----------------------------------------------------------------------------*/
+static const char *proxyGetFormat(const void *)
+{
+  return "i24q8";
+}
+/*----------------------------------------------------------------------------*/
+static enum SensorStatus proxyGetStatus(const void *object)
+{
+  const struct DS18B20GroupSensor * const proxy = object;
+  return ds18b20GroupGetStatus(proxy->parent);
+}
+/*----------------------------------------------------------------------------*/
+static uint64_t proxyGetTimestamp(const void *)
+{
+  return 0;
+}
+/*----------------------------------------------------------------------------*/
+static void proxySetCallbackArgument(void *object, void *argument)
+{
+  struct DS18B20GroupSensor * const proxy = object;
+  proxy->callbackArgument = argument;
+}
+/*----------------------------------------------------------------------------*/
+static void proxySetErrorCallback(void *object,
+    void (*callback)(void *, enum SensorResult))
+{
+  struct DS18B20GroupSensor * const proxy = object;
+  proxy->onErrorCallback = callback;
+}
+/*----------------------------------------------------------------------------*/
+static void proxySetResultCallback(void *object,
+    void (*callback)(void *, const void *, size_t))
+{
+  struct DS18B20GroupSensor * const proxy = object;
+  proxy->onResultCallback = callback;
+}
+/*----------------------------------------------------------------------------*/
+static void proxySetUpdateCallback(void *object, void (*callback)(void *))
+{
+  struct DS18B20GroupSensor * const proxy = object;
+  proxy->onUpdateCallback = callback;
+}
+/*----------------------------------------------------------------------------*/
+static void proxyReset(void *object)
+{
+  struct DS18B20GroupSensor * const proxy = object;
+  ds18b20GroupReset(proxy->parent, proxy);
+}
+/*----------------------------------------------------------------------------*/
+static void proxySample(void *object)
+{
+  struct DS18B20GroupSensor * const proxy = object;
+
+  assert(proxy->onResultCallback != NULL);
+  assert(proxy->onUpdateCallback != NULL);
+
+  atomicFetchOr(&proxy->flags, FLAG_SAMPLE);
+  ds18b20GroupSample(proxy->parent, proxy);
+}
+/*----------------------------------------------------------------------------*/
+static void proxyStart(void *object)
+{
+  struct DS18B20GroupSensor * const proxy = object;
+
+  assert(proxy->onResultCallback != NULL);
+  assert(proxy->onUpdateCallback != NULL);
+
+  atomicFetchOr(&proxy->flags, FLAG_LOOP);
+  ds18b20GroupStart(proxy->parent, proxy);
+}
+/*----------------------------------------------------------------------------*/
+static void proxyStop(void *object)
+{
+  struct DS18B20GroupSensor * const proxy = object;
+
+  atomicFetchAnd(&proxy->flags, ~(FLAG_LOOP | FLAG_SAMPLE));
+  ds18b20GroupStop(proxy->parent);
+}
+/*----------------------------------------------------------------------------*/
+static void proxySuspend(void *object)
+{
+  struct DS18B20GroupSensor * const proxy = object;
+
+  atomicFetchAnd(&proxy->flags, ~(FLAG_LOOP | FLAG_SAMPLE));
+  ds18b20GroupStop(proxy->parent);
+}
+/*----------------------------------------------------------------------------*/
+static bool proxyUpdate(void *object)
+{
+  struct DS18B20GroupSensor * const proxy = object;
+  return ds18b20GroupUpdate(proxy->parent, proxy);
+}
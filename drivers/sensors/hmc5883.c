@@ -14,7 +14,9 @@
 #include <assert.h>
 #include <string.h>
 /*----------------------------------------------------------------------------*/
-#define LENGTH_CONFIG 3
+#define FREQUENCY_SINGLE  (HMC5883_FREQUENCY_160HZ - 1)
+#define LENGTH_CONFIG     3
+#define LENGTH_DATA       6
 
 enum State
 {
@@ -33,6 +35,9 @@ enum State
   STATE_REQUEST_WAIT,
   STATE_READ,
   STATE_READ_WAIT,
+  STATE_STREAM_READ,
+  STATE_TRIGGER,
+  STATE_TRIGGER_WAIT,
 
   STATE_PROCESS,
 
@@ -46,17 +51,19 @@ static void busInit(struct HMC5883 *, bool);
 static inline uint32_t calcResetTimeout(const struct Timer *);
 static void calcValues(struct HMC5883 *);
 static int32_t gainToScale(const struct HMC5883 *);
-static void makeConfig(const struct HMC5883 *, uint8_t *);
+static void makeConfig(struct HMC5883 *);
 static void onBusEvent(void *);
 static void onPinEvent(void *);
 static void onTimerEvent(void *);
 static void startConfigWrite(struct HMC5883 *);
+static void startMeasurementTrigger(struct HMC5883 *);
 static void startSampleRead(struct HMC5883 *);
 static void startSampleRequest(struct HMC5883 *);
 static void startSuspendSequence(struct HMC5883 *);
 
 static enum Result hmcInit(void *, const void *);
 static void hmcDeinit(void *);
+static const struct SensorDescriptor *hmcGetDescriptor(const void *);
 static const char *hmcGetFormat(const void *);
 static enum SensorStatus hmcGetStatus(const void *);
 static uint64_t hmcGetTimestamp(const void *);
@@ -77,6 +84,7 @@ const struct SensorClass * const HMC5883 = &(const struct SensorClass){
     .init = hmcInit,
     .deinit = hmcDeinit,
 
+    .getDescriptor = hmcGetDescriptor,
     .getFormat = hmcGetFormat,
     .getStatus = hmcGetStatus,
     .getTimestamp = hmcGetTimestamp,
@@ -123,12 +131,26 @@ static inline uint32_t calcResetTimeout(const struct Timer *timer)
 /*----------------------------------------------------------------------------*/
 static void calcValues(struct HMC5883 *sensor)
 {
+  const int32_t * const matrix = sensor->correction.matrix;
+  const int16_t * const offset = sensor->correction.offset;
   const int32_t scale = gainToScale(sensor);
   int32_t magnitude[3];
+  int32_t raw[3];
 
-  magnitude[0] = (int16_t)((sensor->buffer[0] << 8) | sensor->buffer[1]);
-  magnitude[1] = (int16_t)((sensor->buffer[4] << 8) | sensor->buffer[5]);
-  magnitude[2] = (int16_t)((sensor->buffer[2] << 8) | sensor->buffer[3]);
+  raw[0] = (int16_t)((sensor->buffer[0] << 8) | sensor->buffer[1]);
+  raw[1] = (int16_t)((sensor->buffer[4] << 8) | sensor->buffer[5]);
+  raw[2] = (int16_t)((sensor->buffer[2] << 8) | sensor->buffer[3]);
+
+  /* Remove hard-iron offsets and apply soft-iron correction matrix */
+  for (size_t index = 0; index < 3; ++index)
+  {
+    const int32_t * const row = matrix + index * 3;
+    const int64_t value = (int64_t)row[0] * (raw[0] - offset[0])
+        + (int64_t)row[1] * (raw[1] - offset[1])
+        + (int64_t)row[2] * (raw[2] - offset[2]);
+
+    magnitude[index] = (int32_t)(value >> 16);
+  }
 
   /* Convert from raw data to temporary form of i8q24 and then to i16q16 */
   magnitude[0] = (magnitude[0] * scale) >> 8;
@@ -155,11 +177,12 @@ static int32_t gainToScale(const struct HMC5883 *sensor)
   return scaleMap[sensor->gain];
 }
 /*----------------------------------------------------------------------------*/
-static void makeConfig(const struct HMC5883 *sensor, uint8_t *config)
+static void makeConfig(struct HMC5883 *sensor)
 {
-  uint8_t configA = CONFIG_A_DO(sensor->frequency);
+  const bool single = sensor->frequency == FREQUENCY_SINGLE;
+  uint8_t configA = CONFIG_A_DO(single ? DO_75_HZ : sensor->frequency);
   const uint8_t configB = CONFIG_B_GN(sensor->gain);
-  const uint8_t mode = MODE_MD(MD_CONTINUOUS);
+  const uint8_t mode = MODE_MD(single ? MD_SINGLE : MD_CONTINUOUS);
 
   if (sensor->calibration == CAL_NEG_OFFSET)
     configA |= CONFIG_A_MS(MS_NEGATIVE_BIAS);
@@ -168,9 +191,17 @@ static void makeConfig(const struct HMC5883 *sensor, uint8_t *config)
   else
     configA |= CONFIG_A_MS(MS_NORMAL) | CONFIG_A_MA(sensor->oversampling);
 
-  config[0] = configA;
-  config[1] = configB;
-  config[2] = mode;
+  regmapWrite(&sensor->regmap, REG_CONFIG_A, configA);
+  regmapWrite(&sensor->regmap, REG_CONFIG_B, configB);
+  regmapWrite(&sensor->regmap, REG_MODE, mode);
+
+  /*
+   * Mode register is always written: it starts a new measurement and
+   * moves the register pointer to the first data register. Unchanged
+   * configuration registers between dirty ones are merged into the
+   * same transfer, therefore a single write is always enough.
+   */
+  regmapInvalidate(&sensor->regmap, REG_MODE, 1);
 }
 /*----------------------------------------------------------------------------*/
 static void onBusEvent(void *object)
@@ -182,7 +213,8 @@ static void onBusEvent(void *object)
 
   if (ifGetParam(sensor->bus, IF_STATUS, NULL) != E_OK)
   {
-    /* I2C bus */
+    /* I2C bus, register pointer of the sensor is unknown */
+    atomicFetchAnd(&sensor->flags, ~FLAG_POINTER);
     sensor->state = STATE_ERROR_WAIT;
 
     timerSetOverflow(sensor->timer, calcResetTimeout(sensor->timer));
@@ -206,6 +238,19 @@ static void onBusEvent(void *object)
       break;
 
     case STATE_READ_WAIT:
+      /* Register pointer wraps from the last data register to the first */
+      atomicFetchOr(&sensor->flags, FLAG_POINTER);
+
+      if (sensor->frequency == FREQUENCY_SINGLE)
+      {
+        sensor->state = STATE_TRIGGER;
+        release = false;
+      }
+      else
+        sensor->state = STATE_PROCESS;
+      break;
+
+    case STATE_TRIGGER_WAIT:
       sensor->state = STATE_PROCESS;
       break;
 
@@ -246,6 +291,7 @@ static void onTimerEvent(void *object)
     default:
       ifSetCallback(sensor->bus, NULL, NULL);
       ifSetParam(sensor->bus, IF_RELEASE, NULL);
+      atomicFetchAnd(&sensor->flags, ~FLAG_POINTER);
       sensor->state = STATE_ERROR_TIMEOUT;
       break;
   }
@@ -255,16 +301,27 @@ static void onTimerEvent(void *object)
 /*----------------------------------------------------------------------------*/
 static void startConfigWrite(struct HMC5883 *sensor)
 {
-  sensor->buffer[0] = REG_CONFIG_A;
-  makeConfig(sensor, sensor->buffer + 1);
+  makeConfig(sensor);
+
+  const size_t length = regmapPrepare(&sensor->regmap, sensor->buffer,
+      sizeof(sensor->buffer));
 
   busInit(sensor, false);
-  ifWrite(sensor->bus, sensor->buffer, 1 + LENGTH_CONFIG);
+  ifWrite(sensor->bus, sensor->buffer, length);
+}
+/*----------------------------------------------------------------------------*/
+static void startMeasurementTrigger(struct HMC5883 *sensor)
+{
+  /* Sample data is stored at the beginning of the buffer */
+  sensor->buffer[LENGTH_DATA] = REG_MODE;
+  sensor->buffer[LENGTH_DATA + 1] = MODE_MD(MD_SINGLE);
+
+  ifWrite(sensor->bus, sensor->buffer + LENGTH_DATA, 2);
 }
 /*----------------------------------------------------------------------------*/
 static void startSampleRead(struct HMC5883 *sensor)
 {
-  ifRead(sensor->bus, sensor->buffer, sizeof(sensor->buffer));
+  ifRead(sensor->bus, sensor->buffer, LENGTH_DATA);
 }
 /*----------------------------------------------------------------------------*/
 static void startSampleRequest(struct HMC5883 *sensor)
@@ -310,6 +367,10 @@ static enum Result hmcInit(void *object, const void *configBase)
   sensor->flags = 0;
   sensor->state = STATE_IDLE;
 
+  regmapInit(&sensor->regmap, sensor->registers, sensor->dirty,
+      REG_CONFIG_A, LENGTH_CONFIG, LENGTH_CONFIG - 2);
+  hmc5883SetCorrection(sensor, (const int16_t []){0, 0, 0}, NULL);
+
   if (config->frequency != HMC5883_FREQUENCY_DEFAULT)
   {
     if (config->frequency >= HMC5883_FREQUENCY_END)
@@ -337,6 +398,17 @@ static enum Result hmcInit(void *object, const void *configBase)
   else
     sensor->oversampling = HMC5883_OVERSAMPLING_NONE;
 
+  if (sensor->frequency == FREQUENCY_SINGLE)
+  {
+    /* Rate of 160 Hz is reachable only without oversampling */
+    if (config->oversampling != HMC5883_OVERSAMPLING_DEFAULT
+        && config->oversampling != HMC5883_OVERSAMPLING_NONE)
+    {
+      return E_VALUE;
+    }
+    sensor->oversampling = HMC5883_OVERSAMPLING_NONE - 1;
+  }
+
   interruptSetCallback(sensor->event, onPinEvent, sensor);
   timerSetAutostop(sensor->timer, true);
   timerSetCallback(sensor->timer, onTimerEvent, sensor);
@@ -355,6 +427,18 @@ static void hmcDeinit(void *object)
   interruptSetCallback(sensor->event, NULL, NULL);
 }
 /*----------------------------------------------------------------------------*/
+static const struct SensorDescriptor *hmcGetDescriptor(const void *)
+{
+  static const struct SensorDescriptor descriptor = {
+      .type = SENSOR_TYPE_INT32,
+      .count = 3,
+      .exponent = -16,
+      .unit = SENSOR_UNIT_GAUSS
+  };
+
+  return &descriptor;
+}
+/*----------------------------------------------------------------------------*/
 static const char *hmcGetFormat(const void *)
 {
   return "i16q16i16q16i16q16";
@@ -507,7 +591,7 @@ static bool hmcUpdate(void *object)
 
       case STATE_CONFIG_WRITE:
         sensor->state = STATE_CONFIG_WRITE_WAIT;
-        atomicFetchAnd(&sensor->flags, ~FLAG_READY);
+        atomicFetchAnd(&sensor->flags, ~(FLAG_READY | FLAG_POINTER));
         startConfigWrite(sensor);
         busy = true;
         break;
@@ -520,7 +604,9 @@ static bool hmcUpdate(void *object)
         sensor->timestamp = 0;
         sensor->state = STATE_IDLE;
         atomicFetchAnd(&sensor->flags, ~(FLAG_RESET | FLAG_EVENT));
-        atomicFetchOr(&sensor->flags, FLAG_READY);
+
+        /* Register pointer points to the first data register after writes */
+        atomicFetchOr(&sensor->flags, FLAG_POINTER | FLAG_READY);
         updated = true;
         break;
 
@@ -560,7 +646,9 @@ static bool hmcUpdate(void *object)
           }
           else
           {
-            sensor->state = STATE_REQUEST;
+            /* Timestamp of the data ready event is used in streaming mode */
+            sensor->state = (flags & FLAG_POINTER) ?
+                STATE_STREAM_READ : STATE_REQUEST;
             atomicFetchAnd(&sensor->flags, ~FLAG_EVENT);
           }
 
@@ -597,6 +685,23 @@ static bool hmcUpdate(void *object)
         busy = true;
         break;
 
+      case STATE_STREAM_READ:
+        sensor->state = STATE_READ_WAIT;
+        busInit(sensor, false);
+        startSampleRead(sensor);
+        busy = true;
+        break;
+
+      case STATE_TRIGGER:
+        sensor->state = STATE_TRIGGER_WAIT;
+        startMeasurementTrigger(sensor);
+        busy = true;
+        break;
+
+      case STATE_TRIGGER_WAIT:
+        busy = true;
+        break;
+
       case STATE_PROCESS:
         calcValues(sensor);
 
@@ -619,6 +724,9 @@ static bool hmcUpdate(void *object)
                   SENSOR_INTERFACE_ERROR : SENSOR_INTERFACE_TIMEOUT);
         }
 
+        /* State of the device is unknown, rewrite all registers */
+        regmapInvalidate(&sensor->regmap, REG_CONFIG_A, LENGTH_CONFIG);
+
         sensor->timestamp = 0;
         sensor->state = STATE_IDLE;
         updated = true;
@@ -650,3 +758,28 @@ void hmc5883EnableNormalMode(struct HMC5883 *sensor)
   atomicFetchOr(&sensor->flags, FLAG_RESET);
   sensor->onUpdateCallback(sensor->callbackArgument);
 }
+/*----------------------------------------------------------------------------*/
+/**
+ * Set hard-iron and soft-iron correction. Corrected sample is calculated
+ * as a product of the matrix and the difference of the raw sample and
+ * offsets.
+ * @param sensor Pointer to an HMC5883 object.
+ * @param offset Array of three hard-iron offsets in raw units of the
+ * configured gain, axes are in X, Y, Z order.
+ * @param matrix Row-major 3x3 soft-iron correction matrix in Q16.16 format,
+ * an identity matrix is used when the pointer is null.
+ */
+void hmc5883SetCorrection(struct HMC5883 *sensor, const int16_t *offset,
+    const int32_t *matrix)
+{
+  for (size_t index = 0; index < 3; ++index)
+    sensor->correction.offset[index] = offset[index];
+
+  for (size_t index = 0; index < 9; ++index)
+  {
+    if (matrix != NULL)
+      sensor->correction.matrix[index] = matrix[index];
+    else
+      sensor->correction.matrix[index] = index % 4 ? 0 : (1L << 16);
+  }
+}
@@ -12,6 +12,17 @@
 #include <halm/timer.h>
 #include <xcore/atomic.h>
 #include <assert.h>
+#include <stdlib.h>
+/*----------------------------------------------------------------------------*/
+/*
+ * Clean registers inside the block of offset registers are merged into
+ * a single transfer, reserved registers before FIFO_EN are never written.
+ */
+#define GAP_REGISTERS     4
+#define LENGTH_OFFSETS    6
+
+static_assert(SHADOW_LENGTH == MPU60XX_SHADOW_LENGTH,
+    "Incorrect length of the register shadow");
 /*----------------------------------------------------------------------------*/
 enum ConfigState
 {
@@ -27,12 +38,8 @@ enum ConfigState
   CONFIG_USER_CTRL,
   CONFIG_STARTUP_WAIT,
   CONFIG_PWR_MGMT_WAKEUP,
-  CONFIG_GYRO,
-  CONFIG_ACCEL,
-  CONFIG_BANDWIDTH,
-  CONFIG_RATE,
-  CONFIG_INT_PIN,
-  CONFIG_INT_ENABLE,
+  CONFIG_REGISTERS,
+  CONFIG_FIFO_CTRL,
   CONFIG_READY_WAIT,
   CONFIG_END
 };
@@ -60,30 +67,73 @@ enum State
 
   STATE_PROCESS,
 
+  STATE_FIFO_REQUEST,
+  STATE_FIFO_REQUEST_WAIT,
+  STATE_FIFO_COUNT,
+  STATE_FIFO_COUNT_WAIT,
+  STATE_FIFO_DATA_REQUEST,
+  STATE_FIFO_DATA_REQUEST_WAIT,
+  STATE_FIFO_DATA,
+  STATE_FIFO_DATA_WAIT,
+  STATE_FIFO_PROCESS,
+  STATE_FIFO_RESET,
+  STATE_FIFO_RESET_WAIT,
+
+  STATE_OFFSET_WRITE,
+  STATE_OFFSET_WRITE_WAIT,
+
   STATE_ERROR_WAIT,
   STATE_ERROR_DEVICE,
   STATE_ERROR_INTERFACE,
+  STATE_ERROR_OVERFLOW,
   STATE_ERROR_TIMEOUT
 };
 /*----------------------------------------------------------------------------*/
 static void busInit(struct MPU60XX *, bool);
+static uint32_t calcDrainTimeout(const struct MPU60XX *);
+static void calcGyroOffload(struct MPU60XX *, const int16_t *);
+static int32_t calcHalfAngle(const struct MPU60XX *, int32_t);
+static void calcOrientation(struct MPU60XX *, const int32_t *,
+    const int32_t *);
 static inline uint32_t calcResetTimeout(const struct Timer *);
-static void calcValues(struct MPU60XX *);
-static void fetchAccelSample(const struct MPU60XX *, int16_t *);
-static void fetchGyroSample(const struct MPU60XX *, int16_t *);
-static int16_t fetchThermoSample(const struct MPU60XX *);
+static uint32_t calcSquareRoot(uint64_t);
+static void calcTimestamps(struct MPU60XX *, size_t);
+static void calcValues(struct MPU60XX *, const uint8_t *, size_t);
+static void correctAccelSample(const struct MPU60XX *, const int16_t *,
+    int32_t *);
+static void correctGyroSample(const struct MPU60XX *, const int16_t *,
+    int32_t *);
+static void fetchAccelSample(const uint8_t *, int16_t *);
+static void fetchGyroSample(const uint8_t *, int16_t *);
+static int16_t fetchThermoSample(const uint8_t *);
 static inline uint8_t makeAccelConfig(const struct MPU60XX *);
 static inline int32_t makeAccelMul(const struct MPU60XX *);
+static inline uint8_t makeBandwidthConfig(const struct MPU60XX *);
+static inline uint8_t makeFifoControl(const struct MPU60XX *);
+static inline uint8_t makeFifoEnable(const struct MPU60XX *);
 static inline uint8_t makeGyroConfig(const struct MPU60XX *);
 static inline int32_t makeGyroDiv(const struct MPU60XX *);
 static inline int32_t makeGyroMul(void);
+static inline uint8_t makeInterruptEnable(const struct MPU60XX *);
+static inline uint8_t makeRateDivider(const struct MPU60XX *);
+static inline int32_t mulQ30(int32_t, int32_t);
+static bool normalizeVector(int32_t *, size_t);
 static void onBusEvent(void *);
 static void onPinEvent(void *);
 static void onTimerEvent(void *);
+static void resetOrientation(struct MPU60XX *);
 static bool startConfigUpdate(struct MPU60XX *, bool *);
+static void startDrainTimer(struct MPU60XX *);
+static void startFifoDataRead(struct MPU60XX *);
+static void startFifoReset(struct MPU60XX *);
+static bool startOffsetWrite(struct MPU60XX *);
+static void startRegisterRequest(struct MPU60XX *, uint8_t);
 static void startSampleRead(struct MPU60XX *);
 static void startSampleRequest(struct MPU60XX *);
 static void startSuspendSequence(struct MPU60XX *);
+static void updateGyroBias(struct MPU60XX *, const uint8_t *);
+static void writeConfigRegisters(struct MPU60XX *);
+static void writeOffsetRegisters(struct MPU60XX *);
 
 static enum Result mpuInit(void *, const void *);
 static void mpuDeinit(void *);
@@ -127,39 +177,203 @@ static void busInit(struct MPU60XX *sensor, bool read)
   }
 }
 /*----------------------------------------------------------------------------*/
+static uint32_t calcDrainTimeout(const struct MPU60XX *sensor)
+{
+  const uint64_t ticks = (uint64_t)timerGetFrequency(sensor->timer)
+      * sensor->fifo.depth * sensor->rateDivider;
+
+  return (uint32_t)((ticks + sensor->baseRate - 1) / sensor->baseRate);
+}
+/*----------------------------------------------------------------------------*/
+static void calcGyroOffload(struct MPU60XX *sensor, const int16_t *bias)
+{
+  /*
+   * Offset registers have a resolution of 4 LSB at 250 dps scale,
+   * the residual part of the bias is corrected in software.
+   */
+  const int32_t scale = 1L << (sensor->gyroScale - 1);
+
+  for (size_t index = 0; index < 3; ++index)
+  {
+    const int32_t delta = -(int32_t)bias[index] * scale / 4;
+
+    sensor->calibration.registers[index] += (int16_t)delta;
+    sensor->calibration.bias[index] = (int16_t)(bias[index]
+        + delta * 4 / scale);
+  }
+}
+/*----------------------------------------------------------------------------*/
+static int32_t calcHalfAngle(const struct MPU60XX *sensor, int32_t raw)
+{
+  /*
+   * Angular rate in Q16.16 rad/s multiplied by a half of the sample period
+   * and converted to Q2.30 format. Half of the rotation angle per sample
+   * is limited to 1 rad.
+   */
+  const int64_t value = (int64_t)raw * makeGyroMul() * 8192
+      * sensor->rateDivider
+      / ((int64_t)makeGyroDiv(sensor) * sensor->baseRate);
+
+  return (int32_t)MAX(MIN(value, 1L << 30), -(1L << 30));
+}
+/*----------------------------------------------------------------------------*/
+static void calcOrientation(struct MPU60XX *sensor, const int32_t *accel,
+    const int32_t *gyro)
+{
+  const int32_t * const q = sensor->fusion.quaternion;
+  int32_t a[3] = {accel[0], accel[1], accel[2]};
+  int32_t h[3];
+  int32_t s[4];
+  bool correction;
+
+  for (size_t index = 0; index < ARRAY_SIZE(h); ++index)
+    h[index] = calcHalfAngle(sensor, gyro[index]);
+
+  /* Gradient of the gravity error function, Q4.28 format */
+  correction = normalizeVector(a, ARRAY_SIZE(a));
+
+  if (correction)
+  {
+    const int32_t f0 = ((mulQ30(q[1], q[3]) - mulQ30(q[0], q[2])) >> 1)
+        - (a[0] >> 2);
+    const int32_t f1 = ((mulQ30(q[0], q[1]) + mulQ30(q[2], q[3])) >> 1)
+        - (a[1] >> 2);
+    const int32_t f2 = (1L << 28)
+        - ((mulQ30(q[1], q[1]) + mulQ30(q[2], q[2])) >> 1) - (a[2] >> 2);
+
+    s[0] = mulQ30(q[1], f1) - mulQ30(q[2], f0);
+    s[1] = mulQ30(q[3], f0) + mulQ30(q[0], f1) - 2 * mulQ30(q[1], f2);
+    s[2] = mulQ30(q[3], f1) - mulQ30(q[0], f0) - 2 * mulQ30(q[2], f2);
+    s[3] = mulQ30(q[1], f0) + mulQ30(q[2], f1);
+
+    correction = normalizeVector(s, ARRAY_SIZE(s));
+  }
+
+  /* Integrate the rate of change, the result is stored in Q3.29 format */
+  const int64_t delta[4] = {
+      -(int64_t)mulQ30(q[1], h[0]) - mulQ30(q[2], h[1]) - mulQ30(q[3], h[2]),
+      (int64_t)mulQ30(q[0], h[0]) + mulQ30(q[2], h[2]) - mulQ30(q[3], h[1]),
+      (int64_t)mulQ30(q[0], h[1]) - mulQ30(q[1], h[2]) + mulQ30(q[3], h[0]),
+      (int64_t)mulQ30(q[0], h[2]) + mulQ30(q[1], h[1]) - mulQ30(q[2], h[0])
+  };
+  int32_t result[4];
+
+  for (size_t index = 0; index < ARRAY_SIZE(result); ++index)
+  {
+    int64_t value = q[index] + delta[index];
+
+    if (correction)
+      value -= mulQ30(sensor->fusion.step, s[index]);
+
+    result[index] = (int32_t)(value >> 1);
+  }
+
+  if (normalizeVector(result, ARRAY_SIZE(result)))
+  {
+    for (size_t index = 0; index < ARRAY_SIZE(result); ++index)
+      sensor->fusion.quaternion[index] = result[index];
+  }
+}
+/*----------------------------------------------------------------------------*/
 static inline uint32_t calcResetTimeout(const struct Timer *timer)
 {
   static const uint32_t resetRequestFreq = 10; /* Hz */
   return (timerGetFrequency(timer) + (resetRequestFreq - 1)) / resetRequestFreq;
 }
 /*----------------------------------------------------------------------------*/
-static void calcValues(struct MPU60XX *sensor)
+static uint32_t calcSquareRoot(uint64_t value)
+{
+  uint64_t bit = 1ULL << 62;
+  uint64_t result = 0;
+
+  while (bit > value)
+    bit >>= 2;
+
+  while (bit)
+  {
+    if (value >= result + bit)
+    {
+      value -= result + bit;
+      result = (result >> 1) + bit;
+    }
+    else
+      result >>= 1;
+
+    bit >>= 2;
+  }
+
+  return (uint32_t)result;
+}
+/*----------------------------------------------------------------------------*/
+static void calcTimestamps(struct MPU60XX *sensor, size_t count)
+{
+  if (sensor->chrono == NULL)
+    return;
+
+  /*
+   * The newest sample in the FIFO was acquired approximately when the FIFO
+   * counter was requested. Timestamps of consecutive bursts are kept
+   * continuous while the estimation error is below a half of the period.
+   */
+  const uint32_t period = (uint32_t)((uint64_t)timerGetFrequency(sensor->chrono)
+      * sensor->rateDivider / sensor->baseRate);
+  const size_t total = sensor->fifo.available / FIFO_FRAME_SIZE;
+  const uint64_t estimated = sensor->timestamp - (total - 1) * period;
+  const uint64_t expected = sensor->fifo.expected;
+
+  if (expected != 0 && expected - estimated + period / 2 <= period)
+    sensor->timestamp = expected;
+  else
+    sensor->timestamp = estimated;
+
+  sensor->fifo.expected = sensor->timestamp + count * period;
+}
+/*----------------------------------------------------------------------------*/
+static void calcValues(struct MPU60XX *sensor, const uint8_t *frames,
+    size_t count)
 {
   const uint16_t flags = atomicLoad(&sensor->flags);
+  int32_t local[4];
+  int32_t * const result = count > 1 ? sensor->fifo.results : local;
+
+  if (sensor->calibration.window)
+  {
+    for (size_t index = 0; index < count; ++index)
+      updateGyroBias(sensor, frames + index * FIFO_FRAME_SIZE);
+  }
 
   if (flags & (FLAG_THERMO_LOOP | FLAG_THERMO_SAMPLE))
   {
-    const int16_t raw = fetchThermoSample(sensor);
-    const int32_t result = (int32_t)raw * 256 / 340 + 9352;
+    for (size_t index = 0; index < count; ++index)
+    {
+      const int16_t raw = fetchThermoSample(frames + index * FIFO_FRAME_SIZE);
+      result[index] = (int32_t)raw * 256 / 340 + 9352;
+    }
 
     sensor->thermometer->onResultCallback(
-        sensor->thermometer->callbackArgument, &result, sizeof(result));
+        sensor->thermometer->callbackArgument, result,
+        sizeof(int32_t) * count);
   }
 
   if (flags & (FLAG_ACCEL_LOOP | FLAG_ACCEL_SAMPLE))
   {
     const int32_t mul = makeAccelMul(sensor);
 
-    int16_t raw[3];
-    int32_t result[3];
-
-    fetchAccelSample(sensor, raw);
-    result[0] = (int32_t)raw[0] * mul;
-    result[1] = (int32_t)raw[1] * mul;
-    result[2] = (int32_t)raw[2] * mul;
+    for (size_t index = 0; index < count; ++index)
+    {
+      int32_t * const sample = result + index * 3;
+      int16_t raw[3];
+
+      fetchAccelSample(frames + index * FIFO_FRAME_SIZE, raw);
+      correctAccelSample(sensor, raw, sample);
+      sample[0] *= mul;
+      sample[1] *= mul;
+      sample[2] *= mul;
+    }
 
     sensor->accelerometer->onResultCallback(
-        sensor->accelerometer->callbackArgument, result, sizeof(result));
+        sensor->accelerometer->callbackArgument, result,
+        sizeof(int32_t) * 3 * count);
   }
 
   if (flags & (FLAG_GYRO_LOOP | FLAG_GYRO_SAMPLE))
@@ -167,42 +381,100 @@ static void calcValues(struct MPU60XX *sensor)
     const int32_t div = makeGyroDiv(sensor);
     const int32_t mul = makeGyroMul();
 
-    int16_t raw[3];
-    int32_t result[3];
-
-    fetchGyroSample(sensor, raw);
-    result[0] = (int32_t)raw[0] * mul / div;
-    result[1] = (int32_t)raw[1] * mul / div;
-    result[2] = (int32_t)raw[2] * mul / div;
+    for (size_t index = 0; index < count; ++index)
+    {
+      int32_t * const sample = result + index * 3;
+      int16_t raw[3];
+
+      fetchGyroSample(frames + index * FIFO_FRAME_SIZE, raw);
+      correctGyroSample(sensor, raw, sample);
+      sample[0] = sample[0] * mul / div;
+      sample[1] = sample[1] * mul / div;
+      sample[2] = sample[2] * mul / div;
+    }
 
     sensor->gyroscope->onResultCallback(
-        sensor->gyroscope->callbackArgument, result, sizeof(result));
+        sensor->gyroscope->callbackArgument, result,
+        sizeof(int32_t) * 3 * count);
+  }
+
+  if (flags & (FLAG_ORIENT_LOOP | FLAG_ORIENT_SAMPLE))
+  {
+    for (size_t index = 0; index < count; ++index)
+    {
+      const uint8_t * const frame = frames + index * FIFO_FRAME_SIZE;
+      int32_t * const sample = result + index * 4;
+      int32_t accel[3];
+      int32_t gyro[3];
+      int16_t raw[3];
+
+      fetchAccelSample(frame, raw);
+      correctAccelSample(sensor, raw, accel);
+      fetchGyroSample(frame, raw);
+      correctGyroSample(sensor, raw, gyro);
+      calcOrientation(sensor, accel, gyro);
+
+      sample[0] = sensor->fusion.quaternion[0];
+      sample[1] = sensor->fusion.quaternion[1];
+      sample[2] = sensor->fusion.quaternion[2];
+      sample[3] = sensor->fusion.quaternion[3];
+    }
+
+    sensor->orientation->onResultCallback(
+        sensor->orientation->callbackArgument, result,
+        sizeof(int32_t) * 4 * count);
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void correctAccelSample(const struct MPU60XX *sensor,
+    const int16_t *raw, int32_t *result)
+{
+  const int32_t * const matrix = sensor->calibration.matrix;
+  const int16_t * const offset = sensor->calibration.offset;
+  const int32_t x = raw[0] - offset[0];
+  const int32_t y = raw[1] - offset[1];
+  const int32_t z = raw[2] - offset[2];
+
+  for (size_t index = 0; index < 3; ++index)
+  {
+    const int32_t * const row = matrix + index * 3;
+    const int64_t value = (int64_t)row[0] * x + (int64_t)row[1] * y
+        + (int64_t)row[2] * z;
+
+    result[index] = (int32_t)(value >> 16);
   }
 }
 /*----------------------------------------------------------------------------*/
-static void fetchAccelSample(const struct MPU60XX *sensor, int16_t *result)
+static void correctGyroSample(const struct MPU60XX *sensor,
+    const int16_t *raw, int32_t *result)
 {
-  const uint8_t * const buffer = sensor->buffer;
+  const int16_t * const bias = sensor->calibration.bias;
 
+  /* Limit values to the range of raw samples to avoid overflow in scaling */
+  for (size_t index = 0; index < 3; ++index)
+  {
+    const int32_t value = raw[index] - bias[index];
+    result[index] = MAX(MIN(value, INT16_MAX), INT16_MIN);
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void fetchAccelSample(const uint8_t *buffer, int16_t *result)
+{
   result[0] = (int16_t)((buffer[0] << 8) | buffer[1]);
   result[1] = (int16_t)((buffer[2] << 8) | buffer[3]);
   result[2] = (int16_t)((buffer[4] << 8) | buffer[5]);
 }
 /*----------------------------------------------------------------------------*/
-static void fetchGyroSample(const struct MPU60XX *sensor, int16_t *result)
+static void fetchGyroSample(const uint8_t *buffer, int16_t *result)
 {
-  const uint8_t * const buffer = sensor->buffer;
-
   result[0] = (int16_t)((buffer[8] << 8) | buffer[9]);
   result[1] = (int16_t)((buffer[10] << 8) | buffer[11]);
   result[2] = (int16_t)((buffer[12] << 8) | buffer[13]);
 }
 /*----------------------------------------------------------------------------*/
-static int16_t fetchThermoSample(const struct MPU60XX *sensor)
+static int16_t fetchThermoSample(const uint8_t *buffer)
 {
-  const uint8_t * const buffer = sensor->buffer;
   const int16_t result = (int16_t)((buffer[6] << 8) | buffer[7]);
-
   return result;
 }
 /*----------------------------------------------------------------------------*/
@@ -216,6 +488,32 @@ static inline int32_t makeAccelMul(const struct MPU60XX *sensor)
   return 256 >> (sensor->accelScale - 1);
 }
 /*----------------------------------------------------------------------------*/
+static inline uint8_t makeBandwidthConfig(const struct MPU60XX *sensor)
+{
+  if (sensor->baseRate == SMPLRT_DIV_MAX_DLPF_OFF)
+    return CONFIG_DLPF_CFG(DLPF_CFG_ACCEL_260_GYRO_256);
+  else
+    return CONFIG_DLPF_CFG(DLPF_CFG_ACCEL_184_GYRO_188);
+}
+/*----------------------------------------------------------------------------*/
+static inline uint8_t makeFifoControl(const struct MPU60XX *sensor)
+{
+  return USER_CTRL_FIFO_EN | USER_CTRL_FIFO_RESET
+      | (pinValid(sensor->gpio) ? USER_CTRL_I2C_IF_DIS : 0);
+}
+/*----------------------------------------------------------------------------*/
+static inline uint8_t makeFifoEnable(const struct MPU60XX *sensor)
+{
+  /* Frame layout matches the layout of the data registers */
+  if (sensor->fifo.depth)
+  {
+    return FIFO_EN_ACCEL_FIFO_EN | FIFO_EN_TEMP_FIFO_EN
+        | FIFO_EN_XG_FIFO_EN | FIFO_EN_YG_FIFO_EN | FIFO_EN_ZG_FIFO_EN;
+  }
+  else
+    return 0;
+}
+/*----------------------------------------------------------------------------*/
 static inline uint8_t makeGyroConfig(const struct MPU60XX *sensor)
 {
   return GYRO_CONFIG_FS_SEL(sensor->gyroScale - 1);
@@ -231,6 +529,41 @@ static inline int32_t makeGyroMul(void)
   return 35744;
 }
 /*----------------------------------------------------------------------------*/
+static inline uint8_t makeInterruptEnable(const struct MPU60XX *sensor)
+{
+  /* Data ready interrupt is not used in FIFO mode */
+  return sensor->fifo.depth ? 0 : INT_ENABLE_DATA_RDY_EN;
+}
+/*----------------------------------------------------------------------------*/
+static inline uint8_t makeRateDivider(const struct MPU60XX *sensor)
+{
+  return (uint8_t)(sensor->rateDivider - 1);
+}
+/*----------------------------------------------------------------------------*/
+static inline int32_t mulQ30(int32_t a, int32_t b)
+{
+  return (int32_t)(((int64_t)a * b) >> 30);
+}
+/*----------------------------------------------------------------------------*/
+static bool normalizeVector(int32_t *vector, size_t length)
+{
+  uint64_t sum = 0;
+
+  for (size_t index = 0; index < length; ++index)
+    sum += (uint64_t)((int64_t)vector[index] * vector[index]);
+
+  const uint32_t norm = calcSquareRoot(sum);
+
+  if (!norm)
+    return false;
+
+  /* Result is in Q2.30 format */
+  for (size_t index = 0; index < length; ++index)
+    vector[index] = (int32_t)((int64_t)vector[index] * (1L << 30) / norm);
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
 static void onBusEvent(void *object)
 {
   struct MPU60XX * const sensor = object;
@@ -272,6 +605,32 @@ static void onBusEvent(void *object)
       sensor->state = STATE_PROCESS;
       break;
 
+    case STATE_FIFO_REQUEST_WAIT:
+      sensor->state = STATE_FIFO_COUNT;
+      release = false;
+      break;
+
+    case STATE_FIFO_COUNT_WAIT:
+      sensor->state = STATE_FIFO_DATA_REQUEST;
+      break;
+
+    case STATE_FIFO_DATA_REQUEST_WAIT:
+      sensor->state = STATE_FIFO_DATA;
+      release = false;
+      break;
+
+    case STATE_FIFO_DATA_WAIT:
+      sensor->state = STATE_FIFO_PROCESS;
+      break;
+
+    case STATE_FIFO_RESET_WAIT:
+      sensor->state = STATE_ERROR_OVERFLOW;
+      break;
+
+    case STATE_OFFSET_WRITE_WAIT:
+      sensor->state = STATE_IDLE;
+      break;
+
     default:
       break;
   }
@@ -315,6 +674,11 @@ static void onTimerEvent(void *object)
       sensor->state = STATE_ERROR_INTERFACE;
       break;
 
+    case STATE_EVENT_WAIT:
+      /* FIFO drain timer */
+      atomicFetchOr(&sensor->flags, FLAG_EVENT);
+      break;
+
     default:
       if (pinValid(sensor->gpio))
         pinSet(sensor->gpio);
@@ -328,12 +692,22 @@ static void onTimerEvent(void *object)
   proxy->onUpdateCallback(proxy->callbackArgument);
 }
 /*----------------------------------------------------------------------------*/
+static void resetOrientation(struct MPU60XX *sensor)
+{
+  sensor->fusion.quaternion[0] = 1L << 30;
+  sensor->fusion.quaternion[1] = 0;
+  sensor->fusion.quaternion[2] = 0;
+  sensor->fusion.quaternion[3] = 0;
+}
+/*----------------------------------------------------------------------------*/
 static bool startConfigUpdate(struct MPU60XX *sensor, bool *busy)
 {
   uint32_t timeout = 0;
+  size_t length = 2;
   bool error = false;
   bool read = false;
   bool response = false;
+  bool skip = false;
 
   switch (sensor->step)
   {
@@ -349,6 +723,9 @@ static bool startConfigUpdate(struct MPU60XX *sensor, bool *busy)
       break;
 
     case CONFIG_PWR_MGMT_RESET:
+      /* All registers of the map are cleared by the device reset */
+      regmapLoad(&sensor->regmap, NULL, 0);
+
       sensor->buffer[0] = REG_PWR_MGMT_1;
       sensor->buffer[1] = PWR_MGMT_1_DEVICE_RESET;
       break;
@@ -400,43 +777,42 @@ static bool startConfigUpdate(struct MPU60XX *sensor, bool *busy)
       sensor->buffer[1] = PWR_MGMT_1_CLKSEL(CLKSEL_XG);
       break;
 
-    case CONFIG_GYRO:
-      sensor->buffer[0] = REG_GYRO_CONFIG;
-      sensor->buffer[1] = makeGyroConfig(sensor);
+    case CONFIG_REGISTERS:
+      /*
+       * Scale, bandwidth and sample rate should be configured after
+       * clearing sleep bit. Only registers that differ from reset values
+       * are written, the step is repeated until the map is clean.
+       */
+      writeConfigRegisters(sensor);
+
+      length = regmapPrepare(&sensor->regmap, sensor->buffer,
+          sizeof(sensor->buffer));
+      if (!length)
+        skip = true;
       break;
 
-    case CONFIG_ACCEL:
-      sensor->buffer[0] = REG_ACCEL_CONFIG;
-      sensor->buffer[1] = makeAccelConfig(sensor);
-      break;
-
-    case CONFIG_BANDWIDTH:
-      /* Bandwidth should be configured after clearing sleep bit */
-      sensor->buffer[0] = REG_CONFIG;
-      sensor->buffer[1] = CONFIG_DLPF_CFG(DLPF_CFG_ACCEL_184_GYRO_188);
-      break;
-
-    case CONFIG_RATE:
-      /* Sample rate should be configured after clearing sleep bit */
-      sensor->buffer[0] = REG_SMPLRT_DIV;
-      sensor->buffer[1] = 1000 / sensor->sampleRate - 1;
-      break;
-
-    case CONFIG_INT_PIN:
-      sensor->buffer[0] = REG_INT_PIN_CFG;
-      sensor->buffer[1] = 0;
-      break;
+    case CONFIG_FIFO_CTRL:
+      if (!sensor->fifo.depth)
+      {
+        skip = true;
+        break;
+      }
 
-    case CONFIG_INT_ENABLE:
-      sensor->buffer[0] = REG_INT_ENABLE;
-      sensor->buffer[1] = INT_ENABLE_DATA_RDY_EN;
+      sensor->buffer[0] = REG_USER_CTRL;
+      sensor->buffer[1] = makeFifoControl(sensor);
       break;
 
     default:
       return false;
   }
 
-  if (error)
+  if (skip)
+  {
+    sensor->state = STATE_CONFIG_END;
+    *busy = false;
+    return true;
+  }
+  else if (error)
   {
     sensor->state = STATE_ERROR_DEVICE;
   }
@@ -467,7 +843,7 @@ static bool startConfigUpdate(struct MPU60XX *sensor, bool *busy)
         sensor->buffer[0] |= 0x80;
       }
 
-      ifWrite(sensor->bus, sensor->buffer, read ? 1 : 2);
+      ifWrite(sensor->bus, sensor->buffer, read ? 1 : length);
     }
 
     *busy = true;
@@ -478,6 +854,57 @@ static bool startConfigUpdate(struct MPU60XX *sensor, bool *busy)
   return error;
 }
 /*----------------------------------------------------------------------------*/
+static void startDrainTimer(struct MPU60XX *sensor)
+{
+  timerSetOverflow(sensor->timer, calcDrainTimeout(sensor));
+  timerSetValue(sensor->timer, 0);
+  timerEnable(sensor->timer);
+}
+/*----------------------------------------------------------------------------*/
+static void startFifoDataRead(struct MPU60XX *sensor)
+{
+  const size_t frames = MIN(sensor->fifo.available / FIFO_FRAME_SIZE,
+      sensor->fifo.depth);
+
+  ifRead(sensor->bus, sensor->fifo.buffer, frames * FIFO_FRAME_SIZE);
+}
+/*----------------------------------------------------------------------------*/
+static void startFifoReset(struct MPU60XX *sensor)
+{
+  sensor->buffer[0] = REG_USER_CTRL;
+  sensor->buffer[1] = makeFifoControl(sensor);
+
+  busInit(sensor, false);
+  ifWrite(sensor->bus, sensor->buffer, 2);
+}
+/*----------------------------------------------------------------------------*/
+static bool startOffsetWrite(struct MPU60XX *sensor)
+{
+  writeOffsetRegisters(sensor);
+
+  /* Offset registers are contiguous and fit in a single transfer */
+  const size_t length = regmapPrepare(&sensor->regmap, sensor->buffer,
+      sizeof(sensor->buffer));
+
+  if (length)
+  {
+    busInit(sensor, false);
+    ifWrite(sensor->bus, sensor->buffer, length);
+    return true;
+  }
+  else
+    return false;
+}
+/*----------------------------------------------------------------------------*/
+static void startRegisterRequest(struct MPU60XX *sensor, uint8_t address)
+{
+  /* Add read bit in case of SPI interface */
+  sensor->buffer[0] = pinValid(sensor->gpio) ? (address | 0x80) : address;
+
+  busInit(sensor, true);
+  ifWrite(sensor->bus, sensor->buffer, 1);
+}
+/*----------------------------------------------------------------------------*/
 static void startSampleRead(struct MPU60XX *sensor)
 {
   ifRead(sensor->bus, sensor->buffer, sizeof(sensor->buffer));
@@ -500,6 +927,101 @@ static void startSuspendSequence(struct MPU60XX *sensor)
   ifWrite(sensor->bus, sensor->buffer, 2);
 }
 /*----------------------------------------------------------------------------*/
+static void updateGyroBias(struct MPU60XX *sensor, const uint8_t *frame)
+{
+  /* Accelerometer deviation limit is 1/16 g */
+  const int32_t accelThreshold = 1024 >> (sensor->accelScale - 1);
+  int16_t * const reference = sensor->calibration.reference;
+  int32_t * const sum = sensor->calibration.sum;
+  int16_t accel[3];
+  int16_t gyro[3];
+  bool still = sensor->calibration.count > 0;
+
+  fetchAccelSample(frame, accel);
+  fetchGyroSample(frame, gyro);
+
+  for (size_t index = 0; still && index < 3; ++index)
+  {
+    const int32_t accelDelta = accel[index] - reference[index];
+    const int32_t gyroDelta = gyro[index] - reference[index + 3];
+
+    if (accelDelta > accelThreshold || accelDelta < -accelThreshold)
+      still = false;
+    if (gyroDelta > sensor->calibration.threshold
+        || gyroDelta < -sensor->calibration.threshold)
+      still = false;
+  }
+
+  if (!still)
+  {
+    /* Start a new interval from the current sample */
+    for (size_t index = 0; index < 3; ++index)
+    {
+      reference[index] = accel[index];
+      reference[index + 3] = gyro[index];
+      sum[index] = gyro[index];
+    }
+
+    sensor->calibration.count = 1;
+    return;
+  }
+
+  for (size_t index = 0; index < 3; ++index)
+    sum[index] += gyro[index];
+
+  if (++sensor->calibration.count == sensor->calibration.window)
+  {
+    const int32_t window = sensor->calibration.window;
+    int16_t mean[3];
+
+    for (size_t index = 0; index < 3; ++index)
+      mean[index] = (int16_t)(sum[index] / window);
+
+    if (sensor->calibration.offload)
+    {
+      /* Samples already include register offsets, the mean is a residual */
+      calcGyroOffload(sensor, mean);
+      atomicFetchOr(&sensor->flags, FLAG_OFFSET);
+    }
+    else
+    {
+      sensor->calibration.bias[0] = mean[0];
+      sensor->calibration.bias[1] = mean[1];
+      sensor->calibration.bias[2] = mean[2];
+    }
+
+    sensor->calibration.count = 0;
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void writeConfigRegisters(struct MPU60XX *sensor)
+{
+  /* Offloaded gyroscope bias is restored after the device reset */
+  writeOffsetRegisters(sensor);
+
+  regmapWrite(&sensor->regmap, REG_SMPLRT_DIV, makeRateDivider(sensor));
+  regmapWrite(&sensor->regmap, REG_CONFIG, makeBandwidthConfig(sensor));
+  regmapWrite(&sensor->regmap, REG_GYRO_CONFIG, makeGyroConfig(sensor));
+  regmapWrite(&sensor->regmap, REG_ACCEL_CONFIG, makeAccelConfig(sensor));
+  regmapWrite(&sensor->regmap, REG_FIFO_EN, makeFifoEnable(sensor));
+  regmapWrite(&sensor->regmap, REG_INT_PIN_CFG, 0);
+  regmapWrite(&sensor->regmap, REG_INT_ENABLE, makeInterruptEnable(sensor));
+}
+/*----------------------------------------------------------------------------*/
+static void writeOffsetRegisters(struct MPU60XX *sensor)
+{
+  const int16_t * const registers = sensor->calibration.registers;
+
+  for (size_t index = 0; index < 3; ++index)
+  {
+    const uint8_t address = (uint8_t)(REG_XG_OFFS_USRH + index * 2);
+
+    regmapWrite(&sensor->regmap, address,
+        (uint8_t)((uint16_t)registers[index] >> 8));
+    regmapWrite(&sensor->regmap, address + 1, (uint8_t)registers[index]);
+  }
+}
+/*----------------------------------------------------------------------------*/
 static enum Result mpuInit(void *object, const void *configBase)
 {
   const struct MPU60XXConfig * const config = configBase;
@@ -513,6 +1035,7 @@ static enum Result mpuInit(void *object, const void *configBase)
   sensor->active = NULL;
   sensor->accelerometer = NULL;
   sensor->gyroscope = NULL;
+  sensor->orientation = NULL;
   sensor->thermometer = NULL;
 
   sensor->bus = config->bus;
@@ -526,15 +1049,32 @@ static enum Result mpuInit(void *object, const void *configBase)
   sensor->state = STATE_IDLE;
   sensor->step = CONFIG_BEGIN;
 
+  regmapInit(&sensor->regmap, sensor->registers, sensor->dirty,
+      SHADOW_FIRST, SHADOW_LENGTH, GAP_REGISTERS);
+
+  sensor->fifo.buffer = NULL;
+  sensor->fifo.results = NULL;
+  sensor->fifo.expected = 0;
+  sensor->fifo.available = 0;
+  sensor->fifo.depth = 0;
+
   // TODO Bandwidth setup, DLPF settings
 
   /* Scale and rate settings */
 
-  if (config->sampleRate > 0 && config->sampleRate <= SMPLRT_DIV_MAX)
-    sensor->sampleRate = config->sampleRate;
-  else
+  if (!config->sampleRate || config->sampleRate > SMPLRT_DIV_MAX_DLPF_OFF)
     return E_VALUE;
 
+  /* Gyroscope output rate is 8 kHz when the low pass filter is disabled */
+  sensor->baseRate = config->sampleRate > SMPLRT_DIV_MAX ?
+      SMPLRT_DIV_MAX_DLPF_OFF : SMPLRT_DIV_MAX;
+  /*
+   * Requested rate is rounded to the nearest rate produced by the integer
+   * divider, the real rate is used for timestamps and the orientation filter.
+   */
+  sensor->rateDivider = (uint16_t)MIN((sensor->baseRate
+      + config->sampleRate / 2) / config->sampleRate, SMPLRT_DIV_RANGE);
+
   if (config->accelScale != MPU60XX_ACCEL_DEFAULT)
   {
     if (config->accelScale >= MPU60XX_ACCEL_END)
@@ -553,6 +1093,39 @@ static enum Result mpuInit(void *object, const void *configBase)
   else
     sensor->gyroScale = MPU60XX_GYRO_2000;
 
+  /* Orientation filter settings */
+
+  static const uint16_t defaultFusionGain = 6554; /* 0.1 rad/s */
+  const uint16_t fusionGain = config->fusionGain ?
+      config->fusionGain : defaultFusionGain;
+
+  sensor->fusion.step = (int32_t)(((int64_t)fusionGain << 14)
+      * sensor->rateDivider / sensor->baseRate);
+  resetOrientation(sensor);
+
+  /* Calibration settings */
+
+  static const uint16_t defaultBiasThreshold = 1000; /* mdps */
+  const uint32_t biasThreshold = config->biasThreshold ?
+      config->biasThreshold : defaultBiasThreshold;
+
+  for (size_t index = 0; index < 9; ++index)
+    sensor->calibration.matrix[index] = index % 4 ? 0 : (1L << 16);
+
+  for (size_t index = 0; index < 3; ++index)
+  {
+    sensor->calibration.offset[index] = 0;
+    sensor->calibration.bias[index] = 0;
+    sensor->calibration.registers[index] = 0;
+  }
+
+  /* Gyroscope sensitivity is 131 LSB/dps at 250 dps scale */
+  sensor->calibration.threshold = (uint16_t)(biasThreshold * 131
+      / (1000UL << (sensor->gyroScale - 1)));
+  sensor->calibration.window = config->biasWindow;
+  sensor->calibration.count = 0;
+  sensor->calibration.offload = config->biasOffload;
+
   /* Peripheral interface configuration */
 
   if (config->cs)
@@ -570,6 +1143,28 @@ static enum Result mpuInit(void *object, const void *configBase)
     sensor->gpio = pinStub();
   }
 
+  /* FIFO configuration */
+
+  if (config->fifoDepth)
+  {
+    if (config->fifoDepth > FIFO_MAX_FRAMES)
+      return E_VALUE;
+
+    sensor->fifo.buffer = malloc(FIFO_FRAME_SIZE * config->fifoDepth);
+    if (sensor->fifo.buffer == NULL)
+      return E_MEMORY;
+
+    /* Buffer is shared by all proxies, proxies are served sequentially */
+    sensor->fifo.results = malloc(sizeof(int32_t) * 4 * config->fifoDepth);
+    if (sensor->fifo.results == NULL)
+    {
+      free(sensor->fifo.buffer);
+      return E_MEMORY;
+    }
+
+    sensor->fifo.depth = config->fifoDepth;
+  }
+
   interruptSetCallback(sensor->event, onPinEvent, sensor);
   timerSetAutostop(sensor->timer, true);
   timerSetCallback(sensor->timer, onTimerEvent, sensor);
@@ -593,8 +1188,14 @@ static void mpuDeinit(void *object)
   if (sensor->gyroscope != NULL)
     deinit(sensor->gyroscope);
 
+  if (sensor->orientation != NULL)
+    deinit(sensor->orientation);
+
   if (sensor->thermometer != NULL)
     deinit(sensor->thermometer);
+
+  free(sensor->fifo.results);
+  free(sensor->fifo.buffer);
 }
 /*----------------------------------------------------------------------------*/
 enum SensorStatus mpu60xxGetStatus(const struct MPU60XX *sensor)
@@ -683,14 +1284,33 @@ bool mpu60xxUpdate(struct MPU60XX *sensor)
           sensor->state = STATE_SUSPEND_START;
           updated = true;
         }
+        else if ((flags & FLAG_OFFSET) && (flags & FLAG_READY))
+        {
+          sensor->state = STATE_OFFSET_WRITE;
+          updated = true;
+        }
         else if (flags & (FLAG_LOOP | FLAG_SAMPLE))
         {
           if (flags & FLAG_READY)
           {
             if (flags & FLAG_LOOP)
             {
-              sensor->state = STATE_EVENT_WAIT;
-              interruptEnable(sensor->event);
+              if (sensor->fifo.depth && (flags & FLAG_EVENT))
+              {
+                /* Drain the backlog without waiting for the timer */
+                sensor->state = STATE_FIFO_REQUEST;
+                atomicFetchAnd(&sensor->flags, ~FLAG_EVENT);
+                updated = true;
+              }
+              else
+              {
+                sensor->state = STATE_EVENT_WAIT;
+
+                if (sensor->fifo.depth)
+                  startDrainTimer(sensor);
+                else
+                  interruptEnable(sensor->event);
+              }
             }
             else
             {
@@ -730,8 +1350,18 @@ bool mpu60xxUpdate(struct MPU60XX *sensor)
         break;
 
       case STATE_CONFIG_END:
-        if (++sensor->step == CONFIG_END)
+        /* Register map may require several transfers */
+        if (sensor->step != CONFIG_REGISTERS
+            || !regmapIsDirty(&sensor->regmap))
+        {
+          ++sensor->step;
+        }
+
+        if (sensor->step == CONFIG_END)
         {
+          resetOrientation(sensor);
+          sensor->calibration.count = 0;
+
           sensor->timestamp = 0;
           sensor->state = STATE_IDLE;
 
@@ -782,7 +1412,8 @@ bool mpu60xxUpdate(struct MPU60XX *sensor)
           }
           else
           {
-            sensor->state = STATE_REQUEST;
+            sensor->state = sensor->fifo.depth ?
+                STATE_FIFO_REQUEST : STATE_REQUEST;
             atomicFetchAnd(&sensor->flags, ~FLAG_EVENT);
           }
 
@@ -793,6 +1424,10 @@ bool mpu60xxUpdate(struct MPU60XX *sensor)
           sensor->state = STATE_IDLE;
           updated = true;
         }
+
+        /* Drain timer is used for bus timeouts in other states */
+        if (updated && sensor->fifo.depth)
+          timerDisable(sensor->timer);
         break;
       }
 
@@ -820,7 +1455,7 @@ bool mpu60xxUpdate(struct MPU60XX *sensor)
         break;
 
       case STATE_PROCESS:
-        calcValues(sensor);
+        calcValues(sensor, sensor->buffer, 1);
 
         sensor->state = STATE_IDLE;
         atomicFetchAnd(&sensor->flags, ~FLAG_SAMPLE);
@@ -828,11 +1463,105 @@ bool mpu60xxUpdate(struct MPU60XX *sensor)
         updated = true;
         break;
 
+      case STATE_FIFO_REQUEST:
+        if (sensor->chrono != NULL)
+          sensor->timestamp = timerGetValue64(sensor->chrono);
+
+        sensor->state = STATE_FIFO_REQUEST_WAIT;
+        startRegisterRequest(sensor, REG_FIFO_COUNTH);
+        busy = true;
+        break;
+
+      case STATE_FIFO_COUNT:
+        sensor->state = STATE_FIFO_COUNT_WAIT;
+        ifRead(sensor->bus, sensor->buffer, 2);
+        busy = true;
+        break;
+
+      case STATE_FIFO_DATA_REQUEST:
+        sensor->fifo.available = (sensor->buffer[0] << 8) | sensor->buffer[1];
+
+        if (sensor->fifo.available >= FIFO_SIZE
+            || sensor->fifo.available % FIFO_FRAME_SIZE)
+        {
+          /* FIFO overflow or frame misalignment */
+          sensor->state = STATE_FIFO_RESET;
+          updated = true;
+        }
+        else if (sensor->fifo.available)
+        {
+          sensor->state = STATE_FIFO_DATA_REQUEST_WAIT;
+          startRegisterRequest(sensor, REG_FIFO_R_W);
+          busy = true;
+        }
+        else
+        {
+          sensor->state = STATE_IDLE;
+          updated = true;
+        }
+        break;
+
+      case STATE_FIFO_DATA:
+        sensor->state = STATE_FIFO_DATA_WAIT;
+        startFifoDataRead(sensor);
+        busy = true;
+        break;
+
+      case STATE_FIFO_PROCESS:
+      {
+        const size_t total = sensor->fifo.available / FIFO_FRAME_SIZE;
+        const size_t count = MIN(total, sensor->fifo.depth);
+
+        calcTimestamps(sensor, count);
+        calcValues(sensor, sensor->fifo.buffer, count);
+
+        /* Drain the rest of samples without waiting for the timer */
+        if (total - count >= sensor->fifo.depth)
+          atomicFetchOr(&sensor->flags, FLAG_EVENT);
+
+        sensor->state = STATE_IDLE;
+        updated = true;
+        break;
+      }
+
+      case STATE_FIFO_RESET:
+        sensor->fifo.expected = 0;
+        sensor->state = STATE_FIFO_RESET_WAIT;
+        startFifoReset(sensor);
+        busy = true;
+        break;
+
+      case STATE_OFFSET_WRITE:
+        atomicFetchAnd(&sensor->flags, ~FLAG_OFFSET);
+
+        if (startOffsetWrite(sensor))
+        {
+          sensor->state = STATE_OFFSET_WRITE_WAIT;
+          busy = true;
+        }
+        else
+        {
+          /* Offset registers already hold the requested values */
+          sensor->state = STATE_IDLE;
+          updated = true;
+        }
+        break;
+
+      case STATE_OFFSET_WRITE_WAIT:
+      case STATE_FIFO_REQUEST_WAIT:
+      case STATE_FIFO_COUNT_WAIT:
+      case STATE_FIFO_DATA_REQUEST_WAIT:
+      case STATE_FIFO_DATA_WAIT:
+      case STATE_FIFO_RESET_WAIT:
+        busy = true;
+        break;
+
       case STATE_ERROR_WAIT:
         break;
 
       case STATE_ERROR_DEVICE:
       case STATE_ERROR_INTERFACE:
+      case STATE_ERROR_OVERFLOW:
       case STATE_ERROR_TIMEOUT:
         if (sensor->active->onErrorCallback != NULL)
         {
@@ -842,6 +1571,8 @@ bool mpu60xxUpdate(struct MPU60XX *sensor)
             result = SENSOR_CALIBRATION_ERROR;
           else if (sensor->state == STATE_ERROR_INTERFACE)
             result = SENSOR_INTERFACE_ERROR;
+          else if (sensor->state == STATE_ERROR_OVERFLOW)
+            result = SENSOR_DATA_OVERFLOW;
           else
             result = SENSOR_INTERFACE_TIMEOUT;
 
@@ -849,6 +1580,9 @@ bool mpu60xxUpdate(struct MPU60XX *sensor)
               result);
         }
 
+        /* Offset registers may be out of sync with the register map */
+        regmapInvalidate(&sensor->regmap, REG_XG_OFFS_USRH, LENGTH_OFFSETS);
+
         sensor->timestamp = 0;
         sensor->state = STATE_IDLE;
         updated = true;
@@ -892,6 +1626,22 @@ struct MPU60XXProxy *mpu60xxMakeGyroscope(struct MPU60XX *sensor)
   return sensor->gyroscope;
 }
 /*----------------------------------------------------------------------------*/
+struct MPU60XXProxy *mpu60xxMakeOrientation(struct MPU60XX *sensor)
+{
+  if (sensor->orientation == NULL)
+  {
+    const struct MPU60XXProxyConfig config = {
+        .parent = sensor
+    };
+
+    sensor->orientation = init(MPU60XXOrientation, &config);
+    if (sensor->active == NULL)
+      sensor->active = sensor->orientation;
+  }
+
+  return sensor->orientation;
+}
+/*----------------------------------------------------------------------------*/
 struct MPU60XXProxy *mpu60xxMakeThermometer(struct MPU60XX *sensor)
 {
   if (sensor->thermometer == NULL)
@@ -907,3 +1657,72 @@ struct MPU60XXProxy *mpu60xxMakeThermometer(struct MPU60XX *sensor)
 
   return sensor->thermometer;
 }
+/*----------------------------------------------------------------------------*/
+/**
+ * Get the gyroscope bias.
+ * @param sensor Pointer to an MPU60XX object.
+ * @param bias Array of three values in raw units of the configured scale,
+ * the bias includes the part written into offset registers.
+ */
+void mpu60xxGetGyroBias(const struct MPU60XX *sensor, int16_t *bias)
+{
+  const int32_t scale = 1L << (sensor->gyroScale - 1);
+
+  for (size_t index = 0; index < 3; ++index)
+  {
+    bias[index] = (int16_t)(sensor->calibration.bias[index]
+        - sensor->calibration.registers[index] * 4 / scale);
+  }
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Set the accelerometer calibration. Corrected sample is calculated as
+ * a product of the matrix and the difference of the raw sample and offsets.
+ * @param sensor Pointer to an MPU60XX object.
+ * @param offset Array of three offsets in raw units of the configured scale.
+ * @param matrix Row-major 3x3 matrix in Q16.16 format, an identity matrix
+ * is used when the pointer is null.
+ */
+void mpu60xxSetAccelCalibration(struct MPU60XX *sensor, const int16_t *offset,
+    const int32_t *matrix)
+{
+  for (size_t index = 0; index < 3; ++index)
+    sensor->calibration.offset[index] = offset[index];
+
+  for (size_t index = 0; index < 9; ++index)
+  {
+    if (matrix != NULL)
+      sensor->calibration.matrix[index] = matrix[index];
+    else
+      sensor->calibration.matrix[index] = index % 4 ? 0 : (1L << 16);
+  }
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Set the gyroscope bias, for example a value restored from the non-volatile
+ * memory. The bias is written into offset registers when offloading
+ * is enabled.
+ * @param sensor Pointer to an MPU60XX object.
+ * @param bias Array of three values in raw units of the configured scale.
+ */
+void mpu60xxSetGyroBias(struct MPU60XX *sensor, const int16_t *bias)
+{
+  if (sensor->calibration.offload)
+  {
+    for (size_t index = 0; index < 3; ++index)
+      sensor->calibration.registers[index] = 0;
+
+    calcGyroOffload(sensor, bias);
+    atomicFetchOr(&sensor->flags, FLAG_OFFSET);
+
+    if (sensor->active != NULL && sensor->active->onUpdateCallback != NULL)
+      sensor->active->onUpdateCallback(sensor->active->callbackArgument);
+  }
+  else
+  {
+    for (size_t index = 0; index < 3; ++index)
+      sensor->calibration.bias[index] = bias[index];
+  }
+
+  sensor->calibration.count = 0;
+}
@@ -13,6 +13,7 @@ enum
 {
   PROXY_TYPE_ACCEL,
   PROXY_TYPE_GYRO,
+  PROXY_TYPE_ORIENT,
   PROXY_TYPE_THERMO
 };
 /*----------------------------------------------------------------------------*/
@@ -20,11 +21,13 @@ static void baseProxyInit(struct MPU60XXProxy *,
     const struct MPU60XXProxyConfig *);
 static enum Result accelProxyInit(void *, const void *);
 static enum Result gyroProxyInit(void *, const void *);
+static enum Result orientProxyInit(void *, const void *);
 static enum Result thermoProxyInit(void *, const void *);
 static inline uint16_t typeToLoopConstant(const struct MPU60XXProxy *);
 static inline uint16_t typeToSampleConstant(const struct MPU60XXProxy *);
 
 static void proxyDeinit(void *);
+static const struct SensorDescriptor *proxyGetDescriptor(const void *);
 static const char *proxyGetFormat(const void *);
 static enum SensorStatus proxyGetStatus(const void *);
 static uint64_t proxyGetTimestamp(const void *);
@@ -46,6 +49,7 @@ const struct SensorClass * const MPU60XXAccelerometer =
     .init = accelProxyInit,
     .deinit = proxyDeinit,
 
+    .getDescriptor = proxyGetDescriptor,
     .getFormat = proxyGetFormat,
     .getStatus = proxyGetStatus,
     .getTimestamp = proxyGetTimestamp,
@@ -67,6 +71,29 @@ const struct SensorClass * const MPU60XXGyroscope =
     .init = gyroProxyInit,
     .deinit = proxyDeinit,
 
+    .getDescriptor = proxyGetDescriptor,
+    .getFormat = proxyGetFormat,
+    .getStatus = proxyGetStatus,
+    .getTimestamp = proxyGetTimestamp,
+    .setCallbackArgument = proxySetCallbackArgument,
+    .setErrorCallback = proxySetErrorCallback,
+    .setResultCallback = proxySetResultCallback,
+    .setUpdateCallback = proxySetUpdateCallback,
+    .reset = proxyReset,
+    .sample = proxySample,
+    .start = proxyStart,
+    .stop = proxyStop,
+    .suspend = proxySuspend,
+    .update = proxyUpdate
+};
+
+const struct SensorClass * const MPU60XXOrientation =
+    &(const struct SensorClass){
+    .size = sizeof(struct MPU60XXProxy),
+    .init = orientProxyInit,
+    .deinit = proxyDeinit,
+
+    .getDescriptor = proxyGetDescriptor,
     .getFormat = proxyGetFormat,
     .getStatus = proxyGetStatus,
     .getTimestamp = proxyGetTimestamp,
@@ -88,6 +115,7 @@ const struct SensorClass * const MPU60XXThermometer =
     .init = thermoProxyInit,
     .deinit = proxyDeinit,
 
+    .getDescriptor = proxyGetDescriptor,
     .getFormat = proxyGetFormat,
     .getStatus = proxyGetStatus,
     .getTimestamp = proxyGetTimestamp,
@@ -138,6 +166,17 @@ static enum Result gyroProxyInit(void *object, const void *configBase)
   return E_OK;
 }
 /*----------------------------------------------------------------------------*/
+static enum Result orientProxyInit(void *object, const void *configBase)
+{
+  const struct MPU60XXProxyConfig * const config = configBase;
+  struct MPU60XXProxy * const proxy = object;
+
+  baseProxyInit(proxy, config);
+  proxy->type = PROXY_TYPE_ORIENT;
+
+  return E_OK;
+}
+/*----------------------------------------------------------------------------*/
 static enum Result thermoProxyInit(void *object, const void *configBase)
 {
   const struct MPU60XXProxyConfig * const config = configBase;
@@ -159,6 +198,9 @@ static inline uint16_t typeToLoopConstant(const struct MPU60XXProxy *proxy)
     case PROXY_TYPE_GYRO:
       return FLAG_GYRO_LOOP;
 
+    case PROXY_TYPE_ORIENT:
+      return FLAG_ORIENT_LOOP;
+
     default:
       return FLAG_THERMO_LOOP;
   }
@@ -174,6 +216,9 @@ static inline uint16_t typeToSampleConstant(const struct MPU60XXProxy *proxy)
     case PROXY_TYPE_GYRO:
       return FLAG_GYRO_SAMPLE;
 
+    case PROXY_TYPE_ORIENT:
+      return FLAG_ORIENT_SAMPLE;
+
     default:
       return FLAG_THERMO_SAMPLE;
   }
@@ -183,10 +228,54 @@ static void proxyDeinit(void *)
 {
 }
 /*----------------------------------------------------------------------------*/
+static const struct SensorDescriptor *proxyGetDescriptor(const void *object)
+{
+  static const struct SensorDescriptor descriptors[] = {
+      [PROXY_TYPE_ACCEL] = {
+          .type = SENSOR_TYPE_INT32,
+          .count = 3,
+          .exponent = -16,
+          .unit = SENSOR_UNIT_G
+      },
+      [PROXY_TYPE_GYRO] = {
+          .type = SENSOR_TYPE_INT32,
+          .count = 3,
+          .exponent = -16,
+          .unit = SENSOR_UNIT_RADIAN_PER_SECOND
+      },
+      [PROXY_TYPE_ORIENT] = {
+          .type = SENSOR_TYPE_INT32,
+          .count = 4,
+          .exponent = -30,
+          .unit = SENSOR_UNIT_NONE
+      },
+      [PROXY_TYPE_THERMO] = {
+          .type = SENSOR_TYPE_INT32,
+          .count = 1,
+          .exponent = -8,
+          .unit = SENSOR_UNIT_CELSIUS
+      }
+  };
+
+  const struct MPU60XXProxy * const proxy = object;
+  return &descriptors[proxy->type];
+}
+/*----------------------------------------------------------------------------*/
 static const char *proxyGetFormat(const void *object)
 {
   const struct MPU60XXProxy * const proxy = object;
-  return proxy->type == PROXY_TYPE_THERMO ? "i24q8" : "i16q16i16q16i16q16";
+
+  switch (proxy->type)
+  {
+    case PROXY_TYPE_ORIENT:
+      return "i2q30i2q30i2q30i2q30";
+
+    case PROXY_TYPE_THERMO:
+      return "i24q8";
+
+    default:
+      return "i16q16i16q16i16q16";
+  }
 }
 /*----------------------------------------------------------------------------*/
 static enum SensorStatus proxyGetStatus(const void *object)
@@ -17,6 +17,15 @@
 #define LENGTH_PROM_ENTRY 2
 #define LENGTH_SAMPLE     3
 
+#define SEA_LEVEL_PRESSURE 101325
+
+enum
+{
+  PENDING_NONE,
+  PENDING_PRESSURE,
+  PENDING_TEMPERATURE
+};
+
 enum State
 {
   STATE_IDLE,
@@ -35,6 +44,7 @@ enum State
   STATE_P_REQUEST_WAIT,
   STATE_P_READ,
   STATE_P_READ_WAIT,
+  STATE_P_NEXT,
 
   STATE_T_START,
   STATE_T_START_WAIT,
@@ -43,6 +53,7 @@ enum State
   STATE_T_REQUEST_WAIT,
   STATE_T_READ,
   STATE_T_READ_WAIT,
+  STATE_T_NEXT,
 
   STATE_PROCESS,
 
@@ -51,27 +62,33 @@ enum State
   STATE_ERROR_TIMEOUT
 };
 /*----------------------------------------------------------------------------*/
+static int32_t calcAltitude(uint32_t, int32_t);
 static void calcOffSens5607(const uint16_t *, int32_t, int64_t *, int64_t *);
 static void calcOffSens5611(const uint16_t *, int32_t, int64_t *, int64_t *);
 static inline uint32_t calcResetTimeout(const struct Timer *);
+static inline uint32_t calcSeaLevelScale(uint32_t);
 static bool checkCrc4(const uint16_t *);
-static void getCompensatedResults(const struct MS56XX *, int32_t *, int32_t *);
 static void makeTemperatureCompensation5607(int32_t, int32_t, int64_t *,
     int32_t *, int64_t *);
 static void makeTemperatureCompensation5611(int32_t, int32_t, int64_t *,
     int32_t *, int64_t *);
 
 static void busInit(struct MS56XX *, bool);
-static void calcPressure(struct MS56XX *);
+static void calcCompensation(struct MS56XX *);
+static int32_t calcPressure(const struct MS56XX *);
 static void calReadNext(struct MS56XX *);
 static void calRequestNext(struct MS56XX *);
 static void calReset(struct MS56XX *);
 static uint16_t fetchParameter(const struct MS56XX *);
 static uint32_t fetchSample(const struct MS56XX *);
+static bool isTemperatureRequired(const struct MS56XX *);
 static void onBusEvent(void *);
 static void onTimerEvent(void *);
 static inline uint8_t oversamplingToMode(const struct MS56XX *);
 static uint32_t oversamplingToTime(const struct MS56XX *);
+static void processResults(struct MS56XX *);
+static void startBusWatchdog(struct MS56XX *);
+static void startNextConversion(struct MS56XX *, uint8_t);
 static void startPressureConversion(struct MS56XX *);
 static void startSampleRead(struct MS56XX *);
 static void startSampleRequest(struct MS56XX *);
@@ -79,6 +96,7 @@ static void startTemperatureConversion(struct MS56XX *);
 
 static enum Result msInit(void *, const void *);
 static void msDeinit(void *);
+static const struct SensorDescriptor *msGetDescriptor(const void *);
 static const char *msGetFormat(const void *);
 static enum SensorStatus msGetStatus(const void *);
 static uint64_t msGetTimestamp(const void *);
@@ -99,6 +117,7 @@ const struct SensorClass * const MS56XX = &(const struct SensorClass){
     .init = msInit,
     .deinit = msDeinit,
 
+    .getDescriptor = msGetDescriptor,
     .getFormat = msGetFormat,
     .getStatus = msGetStatus,
     .getTimestamp = msGetTimestamp,
@@ -114,6 +133,49 @@ const struct SensorClass * const MS56XX = &(const struct SensorClass){
     .update = msUpdate
 };
 /*----------------------------------------------------------------------------*/
+static int32_t calcAltitude(uint32_t scale, int32_t pressure)
+{
+  /*
+   * Altitude in m * 2^8 for pressure ratios from 0.25 to 1.125 with 1/64
+   * step, calculated as 44330.77 * (1 - ratio ^ 0.190263) * 2^8.
+   */
+  static const int32_t ALTITUDE_TABLE[] = {
+      2631106, 2529970, 2433542, 2341359, 2253024, 2168196, 2086579, 2007912,
+      1931968, 1858545, 1787462, 1718560, 1651694, 1586735, 1523564, 1462077,
+      1402175, 1343771, 1286782, 1231135, 1176760, 1123595, 1071582, 1020665,
+      970794, 921923, 874008, 827008, 780885, 735603, 691129, 647430,
+      604479, 562245, 520704, 479831, 439601, 399993, 360986, 322559,
+      284694, 247372, 210577, 174292, 138502, 103191, 68346, 33953,
+      0, -33527, -66638, -99346, -131661, -163593, -195152, -226349,
+      -257192
+  };
+  static const uint32_t RATIO_MIN = 1UL << 14;
+  static const uint32_t RATIO_STEP = 10;
+
+  if (pressure <= 0)
+    return ALTITUDE_TABLE[0];
+
+  /* Ratio between actual and sea level pressure in Q16.16 format */
+  const uint32_t ratio =
+      (uint32_t)(((uint64_t)pressure * scale) >> (40 - 16 + 8));
+
+  if (ratio < RATIO_MIN)
+    return ALTITUDE_TABLE[0];
+
+  const uint32_t position = ratio - RATIO_MIN;
+  const size_t index = position >> RATIO_STEP;
+
+  if (index >= ARRAY_SIZE(ALTITUDE_TABLE) - 1)
+    return ALTITUDE_TABLE[ARRAY_SIZE(ALTITUDE_TABLE) - 1];
+
+  /* Linear interpolation between neighboring table entries */
+  const int32_t lower = ALTITUDE_TABLE[index];
+  const int32_t upper = ALTITUDE_TABLE[index + 1];
+  const uint32_t fraction = position & ((1UL << RATIO_STEP) - 1);
+
+  return lower + (int32_t)(((int64_t)(upper - lower) * fraction) >> RATIO_STEP);
+}
+/*----------------------------------------------------------------------------*/
 static void calcOffSens5607(const uint16_t *prom, int32_t dt, int64_t *off,
     int64_t *sens)
 {
@@ -140,6 +202,11 @@ static inline uint32_t calcResetTimeout(const struct Timer *timer)
   return (timerGetFrequency(timer) + (resetRequestFreq - 1)) / resetRequestFreq;
 }
 /*----------------------------------------------------------------------------*/
+static inline uint32_t calcSeaLevelScale(uint32_t pressure)
+{
+  return (uint32_t)(((1ULL << 40) + (pressure >> 1)) / pressure);
+}
+/*----------------------------------------------------------------------------*/
 static bool checkCrc4(const uint16_t *prom)
 {
   const uint16_t expected = prom[7] & 0x000F;
@@ -173,45 +240,6 @@ static bool checkCrc4(const uint16_t *prom)
   return remainder == expected;
 }
 /*----------------------------------------------------------------------------*/
-static void getCompensatedResults(const struct MS56XX *sensor,
-    int32_t *pressure, int32_t *temperature)
-{
-  if (sensor->temperature != 0 && sensor->pressure != 0)
-  {
-    /* Difference between actual and reference temperature */
-    const int32_t dt =
-        (int32_t)sensor->temperature - ((int32_t)sensor->prom[PROM_TREF] << 8);
-
-    /* Actual temperature */
-    int32_t TEMP = 2000 + (((int64_t)dt * sensor->prom[PROM_TEMPSENS]) >> 23);
-
-    /* Calculate offset and sensitivity at actual temperature */
-    int64_t OFF;
-    int64_t SENS;
-    sensor->calculate(sensor->prom, dt, &OFF, &SENS);
-
-    /* Make temperature compensation */
-    int64_t OFF2;
-    int32_t TEMP2;
-    int64_t SENS2;
-    sensor->compensate(TEMP, dt, &OFF2, &TEMP2, &SENS2);
-
-    OFF = OFF - OFF2;
-    SENS = SENS - SENS2;
-
-    /* Compensated pressure, Pa * 2^8 */
-    const int32_t P =
-        ((((int64_t)sensor->pressure * SENS) >> 21) - OFF) >> (15 - 8);
-
-    /* Compensated temperature, C * 2^8 */
-    const int32_t T =
-        ((TEMP - TEMP2) * 83886) >> (23 - 8);
-
-    *pressure = P;
-    *temperature = T;
-  }
-}
-/*----------------------------------------------------------------------------*/
 static void makeTemperatureCompensation5607(int32_t temperature, int32_t dT,
     int64_t *OFF2, int32_t *T2, int64_t *SENS2)
 {
@@ -284,28 +312,43 @@ static void busInit(struct MS56XX *sensor, bool read)
     if (read)
       ifSetParam(sensor->bus, IF_I2C_REPEATED_START, NULL);
 
-    /* Start bus watchdog */
-    timerSetOverflow(sensor->timer, calcResetTimeout(sensor->timer));
-    timerSetValue(sensor->timer, 0);
-    timerEnable(sensor->timer);
+    startBusWatchdog(sensor);
   }
 }
 /*----------------------------------------------------------------------------*/
-static void calcPressure(struct MS56XX *sensor)
+static void calcCompensation(struct MS56XX *sensor)
 {
-  int32_t pressure;
-  int32_t temperature;
-
-  getCompensatedResults(sensor, &pressure, &temperature);
-
-  sensor->onResultCallback(sensor->callbackArgument,
-      &pressure, sizeof(pressure));
-
-  if (atomicLoad(&sensor->flags) & (FLAG_THERMO_LOOP | FLAG_THERMO_SAMPLE))
-  {
-    sensor->thermometer->onResultCallback(sensor->thermometer->callbackArgument,
-        &temperature, sizeof(temperature));
-  }
+  /* Difference between actual and reference temperature */
+  const int32_t dt =
+      (int32_t)sensor->temperature - ((int32_t)sensor->prom[PROM_TREF] << 8);
+
+  /* Actual temperature */
+  const int32_t TEMP =
+      2000 + (((int64_t)dt * sensor->prom[PROM_TEMPSENS]) >> 23);
+
+  /* Calculate offset and sensitivity at actual temperature */
+  int64_t OFF;
+  int64_t SENS;
+  sensor->calculate(sensor->prom, dt, &OFF, &SENS);
+
+  /* Make temperature compensation */
+  int64_t OFF2;
+  int32_t TEMP2;
+  int64_t SENS2;
+  sensor->compensate(TEMP, dt, &OFF2, &TEMP2, &SENS2);
+
+  sensor->compensation.off = OFF - OFF2;
+  sensor->compensation.sens = SENS - SENS2;
+
+  /* Compensated temperature, C * 2^8 */
+  sensor->compensation.temperature = ((TEMP - TEMP2) * 83886) >> (23 - 8);
+}
+/*----------------------------------------------------------------------------*/
+static int32_t calcPressure(const struct MS56XX *sensor)
+{
+  /* Compensated pressure, Pa * 2^8 */
+  return (int32_t)(((((int64_t)sensor->pressure * sensor->compensation.sens)
+      >> 21) - sensor->compensation.off) >> (15 - 8));
 }
 /*----------------------------------------------------------------------------*/
 static void calReadNext(struct MS56XX *sensor)
@@ -325,6 +368,9 @@ static void calReset(struct MS56XX *sensor)
 {
   memset(sensor->prom, 0, sizeof(sensor->prom));
   sensor->parameter = 0;
+  sensor->pressure = 0;
+  sensor->temperature = 0;
+  sensor->cycle = 0;
 
   atomicFetchAnd(&sensor->flags, ~FLAG_READY);
 }
@@ -345,6 +391,12 @@ static uint32_t fetchSample(const struct MS56XX *sensor)
   return value;
 }
 /*----------------------------------------------------------------------------*/
+static bool isTemperatureRequired(const struct MS56XX *sensor)
+{
+  return sensor->cycle == 0 || sensor->temperature == 0
+      || (atomicLoad(&sensor->flags) & FLAG_THERMO_SAMPLE);
+}
+/*----------------------------------------------------------------------------*/
 static void onBusEvent(void *object)
 {
   struct MS56XX * const sensor = object;
@@ -379,7 +431,7 @@ static void onBusEvent(void *object)
 
     case STATE_P_START_WAIT:
       if (sensor->chrono != NULL)
-        sensor->timestamp = timerGetValue64(sensor->chrono);
+        sensor->started = timerGetValue64(sensor->chrono);
 
       sensor->state = STATE_P_WAIT;
       timerSetOverflow(sensor->timer, oversamplingToTime(sensor));
@@ -394,12 +446,26 @@ static void onBusEvent(void *object)
 
     case STATE_P_READ_WAIT:
       sensor->pressure = fetchSample(sensor);
-      sensor->state = STATE_T_START;
+      sensor->pending = PENDING_PRESSURE;
+      sensor->timestamp = sensor->started;
 
-      release = true;
+      if ((atomicLoad(&sensor->flags) & (FLAG_RESET | FLAG_LOOP)) == FLAG_LOOP)
+      {
+        /* Keep the bus and start the next conversion immediately */
+        sensor->state = isTemperatureRequired(sensor) ?
+            STATE_T_NEXT : STATE_P_NEXT;
+      }
+      else
+      {
+        sensor->state = STATE_PROCESS;
+        release = true;
+      }
       break;
 
     case STATE_T_START_WAIT:
+      if (sensor->chrono != NULL)
+        sensor->started = timerGetValue64(sensor->chrono);
+
       sensor->state = STATE_T_WAIT;
       timerSetOverflow(sensor->timer, oversamplingToTime(sensor));
 
@@ -412,10 +478,10 @@ static void onBusEvent(void *object)
       break;
 
     case STATE_T_READ_WAIT:
+      /* Pressure conversion always follows temperature conversion */
       sensor->temperature = fetchSample(sensor);
-      sensor->state = STATE_PROCESS;
-
-      release = true;
+      sensor->pending = PENDING_TEMPERATURE;
+      sensor->state = STATE_P_NEXT;
       break;
 
     default:
@@ -512,6 +578,75 @@ static uint32_t oversamplingToTime(const struct MS56XX *sensor)
   return (overflow + ((1ULL << 32) - 1)) >> 32;
 }
 /*----------------------------------------------------------------------------*/
+static void processResults(struct MS56XX *sensor)
+{
+  const uint8_t pending = sensor->pending;
+  const uint8_t flags = atomicLoad(&sensor->flags);
+
+  sensor->pending = PENDING_NONE;
+
+  if (pending == PENDING_TEMPERATURE)
+  {
+    calcCompensation(sensor);
+
+    if (flags & (FLAG_THERMO_LOOP | FLAG_THERMO_SAMPLE))
+    {
+      const int32_t temperature = sensor->compensation.temperature;
+
+      sensor->thermometer->onResultCallback(
+          sensor->thermometer->callbackArgument,
+          &temperature, sizeof(temperature));
+    }
+
+    atomicFetchAnd(&sensor->flags, ~FLAG_THERMO_SAMPLE);
+  }
+  else if (pending == PENDING_PRESSURE)
+  {
+    if (sensor->pressure != 0 && sensor->temperature != 0)
+    {
+      const int32_t pressure = calcPressure(sensor);
+
+      sensor->onResultCallback(sensor->callbackArgument,
+          &pressure, sizeof(pressure));
+
+      if (flags & (FLAG_ALT_LOOP | FLAG_ALT_SAMPLE))
+      {
+        const int32_t altitude = calcAltitude(sensor->seaLevelScale, pressure);
+
+        sensor->altimeter->onResultCallback(
+            sensor->altimeter->callbackArgument,
+            &altitude, sizeof(altitude));
+      }
+    }
+
+    atomicFetchAnd(&sensor->flags, ~(FLAG_SAMPLE | FLAG_ALT_SAMPLE));
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void startBusWatchdog(struct MS56XX *sensor)
+{
+  timerSetOverflow(sensor->timer, calcResetTimeout(sensor->timer));
+  timerSetValue(sensor->timer, 0);
+  timerEnable(sensor->timer);
+}
+/*----------------------------------------------------------------------------*/
+static void startNextConversion(struct MS56XX *sensor, uint8_t command)
+{
+  /* Interface is still locked after the previous sample read */
+  sensor->buffer[0] = command;
+
+  if (pinValid(sensor->gpio))
+  {
+    /* Toggle chip select to begin a new command */
+    pinSet(sensor->gpio);
+    pinReset(sensor->gpio);
+  }
+  else
+    startBusWatchdog(sensor);
+
+  ifWrite(sensor->bus, sensor->buffer, LENGTH_COMMAND);
+}
+/*----------------------------------------------------------------------------*/
 static void startPressureConversion(struct MS56XX *sensor)
 {
   sensor->buffer[0] = CMD_CONVERT_D1(oversamplingToMode(sensor));
@@ -555,6 +690,7 @@ static enum Result msInit(void *object, const void *configBase)
   sensor->onResultCallback = NULL;
   sensor->onUpdateCallback = NULL;
 
+  sensor->altimeter = NULL;
   sensor->thermometer = NULL;
   sensor->bus = config->bus;
   sensor->chrono = config->chrono;
@@ -562,8 +698,11 @@ static enum Result msInit(void *object, const void *configBase)
   sensor->rate = config->rate;
 
   sensor->timestamp = 0;
-  sensor->pressure = 0;
-  sensor->temperature = 0;
+  sensor->started = 0;
+  sensor->seaLevelScale = calcSeaLevelScale(config->seaLevelPressure ?
+      config->seaLevelPressure : SEA_LEVEL_PRESSURE);
+  sensor->period = config->temperaturePeriod ? config->temperaturePeriod : 1;
+  sensor->pending = PENDING_NONE;
   sensor->flags = 0;
   sensor->state = STATE_IDLE;
 
@@ -621,6 +760,20 @@ static void msDeinit(void *object)
 
   if (sensor->thermometer != NULL)
     deinit(sensor->thermometer);
+  if (sensor->altimeter != NULL)
+    deinit(sensor->altimeter);
+}
+/*----------------------------------------------------------------------------*/
+static const struct SensorDescriptor *msGetDescriptor(const void *)
+{
+  static const struct SensorDescriptor descriptor = {
+      .type = SENSOR_TYPE_INT32,
+      .count = 1,
+      .exponent = -8,
+      .unit = SENSOR_UNIT_PASCAL
+  };
+
+  return &descriptor;
 }
 /*----------------------------------------------------------------------------*/
 static const char *msGetFormat(const void *)
@@ -748,7 +901,8 @@ static bool msUpdate(void *object)
         {
           if (flags & FLAG_READY)
           {
-            sensor->state = STATE_P_START;
+            sensor->state = isTemperatureRequired(sensor) ?
+                STATE_T_START : STATE_P_START;
             updated = true;
           }
         }
@@ -814,6 +968,7 @@ static bool msUpdate(void *object)
         break;
 
       case STATE_P_START:
+        --sensor->cycle;
         sensor->state = STATE_P_START_WAIT;
         startPressureConversion(sensor);
         busy = true;
@@ -824,9 +979,12 @@ static bool msUpdate(void *object)
         break;
 
       case STATE_P_WAIT:
+        processResults(sensor);
         break;
 
       case STATE_P_REQUEST:
+        processResults(sensor);
+
         sensor->state = STATE_P_REQUEST_WAIT;
         startSampleRequest(sensor);
         busy = true;
@@ -846,7 +1004,16 @@ static bool msUpdate(void *object)
         busy = true;
         break;
 
+      case STATE_P_NEXT:
+        --sensor->cycle;
+        sensor->state = STATE_P_START_WAIT;
+        startNextConversion(sensor,
+            CMD_CONVERT_D1(oversamplingToMode(sensor)));
+        busy = true;
+        break;
+
       case STATE_T_START:
+        sensor->cycle = sensor->period;
         sensor->state = STATE_T_START_WAIT;
         startTemperatureConversion(sensor);
         busy = true;
@@ -857,9 +1024,12 @@ static bool msUpdate(void *object)
         break;
 
       case STATE_T_WAIT:
+        processResults(sensor);
         break;
 
       case STATE_T_REQUEST:
+        processResults(sensor);
+
         sensor->state = STATE_T_REQUEST_WAIT;
         startSampleRequest(sensor);
         busy = true;
@@ -879,12 +1049,18 @@ static bool msUpdate(void *object)
         busy = true;
         break;
 
+      case STATE_T_NEXT:
+        sensor->cycle = sensor->period;
+        sensor->state = STATE_T_START_WAIT;
+        startNextConversion(sensor,
+            CMD_CONVERT_D2(oversamplingToMode(sensor)));
+        busy = true;
+        break;
+
       case STATE_PROCESS:
-        calcPressure(sensor);
+        processResults(sensor);
 
         sensor->state = STATE_IDLE;
-        atomicFetchAnd(&sensor->flags, ~(FLAG_SAMPLE | FLAG_THERMO_SAMPLE));
-
         updated = true;
         break;
 
@@ -900,6 +1076,7 @@ static bool msUpdate(void *object)
                   SENSOR_INTERFACE_ERROR : SENSOR_INTERFACE_TIMEOUT);
         }
 
+        sensor->pending = PENDING_NONE;
         sensor->timestamp = 0;
         sensor->state = STATE_IDLE;
         updated = true;
@@ -911,6 +1088,20 @@ static bool msUpdate(void *object)
   return busy;
 }
 /*----------------------------------------------------------------------------*/
+struct MS56XXAltimeter *ms56xxMakeAltimeter(struct MS56XX *sensor)
+{
+  if (sensor->altimeter == NULL)
+  {
+    const struct MS56XXAltimeterConfig config = {
+        .parent = sensor
+    };
+
+    sensor->altimeter = init(MS56XXAltimeter, &config);
+  }
+
+  return sensor->altimeter;
+}
+/*----------------------------------------------------------------------------*/
 struct MS56XXThermometer *ms56xxMakeThermometer(struct MS56XX *sensor)
 {
   if (sensor->thermometer == NULL)
@@ -924,3 +1115,14 @@ struct MS56XXThermometer *ms56xxMakeThermometer(struct MS56XX *sensor)
 
   return sensor->thermometer;
 }
+/*----------------------------------------------------------------------------*/
+/**
+ * Set sea level pressure used for altitude calculation.
+ * @param sensor Pointer to an MS56XX object.
+ * @param pressure Sea level pressure in Pa.
+ */
+void ms56xxSetSeaLevelPressure(struct MS56XX *sensor, uint32_t pressure)
+{
+  assert(pressure > 0);
+  sensor->seaLevelScale = calcSeaLevelScale(pressure);
+}
@@ -0,0 +1,164 @@
+/*
+ * ms56xx_altimeter.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#include <dpm/sensors/ms56xx.h>
+#include <dpm/sensors/ms56xx_defs.h>
+#include <xcore/atomic.h>
+#include <assert.h>
+/*----------------------------------------------------------------------------*/
+static enum Result altInit(void *, const void *);
+static void altDeinit(void *);
+static const struct SensorDescriptor *altGetDescriptor(const void *);
+static const char *altGetFormat(const void *);
+static enum SensorStatus altGetStatus(const void *);
+static uint64_t altGetTimestamp(const void *);
+static void altSetCallbackArgument(void *, void *);
+static void altSetErrorCallback(void *, void (*)(void *, enum SensorResult));
+static void altSetResultCallback(void *,
+    void (*)(void *, const void *, size_t));
+static void altSetUpdateCallback(void *, void (*)(void *));
+static void altReset(void *);
+static void altSample(void *);
+static void altStart(void *);
+static void altStop(void *);
+static void altSuspend(void *);
+static bool altUpdate(void *);
+/*----------------------------------------------------------------------------*/
+const struct SensorClass * const MS56XXAltimeter =
+    &(const struct SensorClass){
+    .size = sizeof(struct MS56XXAltimeter),
+    .init = altInit,
+    .deinit = altDeinit,
+
+    .getDescriptor = altGetDescriptor,
+    .getFormat = altGetFormat,
+    .getStatus = altGetStatus,
+    .getTimestamp = altGetTimestamp,
+    .setCallbackArgument = altSetCallbackArgument,
+    .setErrorCallback = altSetErrorCallback,
+    .setResultCallback = altSetResultCallback,
+    .setUpdateCallback = altSetUpdateCallback,
+    .reset = altReset,
+    .sample = altSample,
+    .start = altStart,
+    .stop = altStop,
+    .suspend = altSuspend,
+    .update = altUpdate
+};
+/*----------------------------------------------------------------------------*/
+static enum Result altInit(void *object, const void *configBase)
+{
+  const struct MS56XXAltimeterConfig * const config = configBase;
+  assert(config != NULL);
+  assert(config->parent != NULL);
+
+  struct MS56XXAltimeter * const sensor = object;
+
+  sensor->callbackArgument = NULL;
+  sensor->onErrorCallback = NULL;
+  sensor->onResultCallback = NULL;
+  sensor->onUpdateCallback = NULL;
+  sensor->parent = config->parent;
+
+  return E_OK;
+}
+/*----------------------------------------------------------------------------*/
+static void altDeinit(void *)
+{
+}
+/*----------------------------------------------------------------------------*/
+static const struct SensorDescriptor *altGetDescriptor(const void *)
+{
+  static const struct SensorDescriptor descriptor = {
+      .type = SENSOR_TYPE_INT32,
+      .count = 1,
+      .exponent = -8,
+      .unit = SENSOR_UNIT_METER
+  };
+
+  return &descriptor;
+}
+/*----------------------------------------------------------------------------*/
+static const char *altGetFormat(const void *)
+{
+  return "i24q8";
+}
+/*----------------------------------------------------------------------------*/
+static enum SensorStatus altGetStatus(const void *)
+{
+  return SENSOR_IDLE;
+}
+/*----------------------------------------------------------------------------*/
+static uint64_t altGetTimestamp(const void *)
+{
+  return 0;
+}
+/*----------------------------------------------------------------------------*/
+static void altSetCallbackArgument(void *object, void *argument)
+{
+  struct MS56XXAltimeter * const sensor = object;
+  sensor->callbackArgument = argument;
+}
+/*----------------------------------------------------------------------------*/
+static void altSetErrorCallback(void *object,
+    void (*callback)(void *, enum SensorResult))
+{
+  struct MS56XXAltimeter * const sensor = object;
+  sensor->onErrorCallback = callback;
+}
+/*----------------------------------------------------------------------------*/
+static void altSetResultCallback(void *object,
+    void (*callback)(void *, const void *, size_t))
+{
+  struct MS56XXAltimeter * const sensor = object;
+  sensor->onResultCallback = callback;
+}
+/*----------------------------------------------------------------------------*/
+static void altSetUpdateCallback(void *object, void (*callback)(void *))
+{
+  struct MS56XXAltimeter * const sensor = object;
+  sensor->onUpdateCallback = callback;
+}
+/*----------------------------------------------------------------------------*/
+static void altReset(void *)
+{
+}
+/*----------------------------------------------------------------------------*/
+static void altSample(void *object)
+{
+  struct MS56XXAltimeter * const sensor = object;
+
+  assert(sensor->onResultCallback != NULL);
+  assert(sensor->onUpdateCallback != NULL);
+
+  atomicFetchOr(&sensor->parent->flags, FLAG_ALT_SAMPLE);
+}
+/*----------------------------------------------------------------------------*/
+static void altStart(void *object)
+{
+  struct MS56XXAltimeter * const sensor = object;
+
+  assert(sensor->onResultCallback != NULL);
+  assert(sensor->onUpdateCallback != NULL);
+
+  atomicFetchOr(&sensor->parent->flags, FLAG_ALT_LOOP);
+}
+/*----------------------------------------------------------------------------*/
+static void altStop(void *object)
+{
+  struct MS56XXAltimeter * const sensor = object;
+  atomicFetchAnd(&sensor->parent->flags,
+      ~(FLAG_ALT_LOOP | FLAG_ALT_SAMPLE));
+}
+/*----------------------------------------------------------------------------*/
+static void altSuspend(void *)
+{
+}
+/*----------------------------------------------------------------------------*/
+static bool altUpdate(void *)
+{
+  return false;
+}
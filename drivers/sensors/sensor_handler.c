@@ -6,18 +6,28 @@
 
 #include <dpm/sensors/sensor_handler.h>
 #include <halm/wq.h>
-#include <xcore/accel.h>
 #include <xcore/atomic.h>
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 /*----------------------------------------------------------------------------*/
+static inline size_t entryToIndex(const struct SensorHandler *,
+    const struct SHEntry *);
 static void invokeUpdate(struct SensorHandler *);
+static void pushSample(struct SensorHandler *, const struct SHEntry *,
+    const void *, size_t);
 static void shOnError(void *, enum SensorResult);
 static void shOnResult(void *, const void *, size_t);
 static void shOnUpdate(void *);
 static void shUpdate(void *);
 static void updateTask(void *);
 /*----------------------------------------------------------------------------*/
+static inline size_t entryToIndex(const struct SensorHandler *handler,
+    const struct SHEntry *entry)
+{
+  return (size_t)(entry - handler->sensors);
+}
+/*----------------------------------------------------------------------------*/
 static void invokeUpdate(struct SensorHandler *handler)
 {
   assert(handler->updateCallback != NULL || handler->wq != NULL);
@@ -35,6 +45,33 @@ static void invokeUpdate(struct SensorHandler *handler)
   }
 }
 /*----------------------------------------------------------------------------*/
+static void pushSample(struct SensorHandler *handler,
+    const struct SHEntry *entry, const void *buffer, size_t length)
+{
+  const uint32_t head = handler->batch.head;
+  const uint32_t count = head - atomicLoad(&handler->batch.tail);
+
+  if (count > handler->batch.mask)
+  {
+    ++handler->batch.dropped;
+    return;
+  }
+
+  struct SHSample * const sample = (struct SHSample *)(handler->batch.buffer
+      + (head & handler->batch.mask) * handler->batch.stride);
+
+  sample->timestamp = sensorGetTimestamp(entry->sensor);
+  sample->tag = entry->tag;
+  sample->length = (uint32_t)length;
+  memcpy(sample->data, buffer, length);
+
+  /* Publish the sample after the payload is written */
+  atomicStore(&handler->batch.head, head + 1);
+
+  if (count + 1 == handler->batch.watermark && handler->batch.callback != NULL)
+    handler->batch.callback(handler->batch.argument);
+}
+/*----------------------------------------------------------------------------*/
 static void shOnError(void *argument, enum SensorResult error)
 {
   struct SHEntry * const entry = argument;
@@ -57,7 +94,12 @@ static void shOnResult(void *argument, const void *buffer, size_t length)
   struct SHEntry * const entry = argument;
   struct SensorHandler * const handler = entry->handler;
 
-  if (handler->dataCallback != NULL)
+  /* Samples that do not fit into the ring entry are delivered directly */
+  if (handler->batch.buffer != NULL && length <= handler->batch.length)
+  {
+    pushSample(handler, entry, buffer, length);
+  }
+  else if (handler->dataCallback != NULL)
   {
     handler->dataCallback(handler->dataCallbackArgument,
         entry->tag, buffer, length);
@@ -69,7 +111,8 @@ static void shOnUpdate(void *argument)
   struct SHEntry * const entry = argument;
   struct SensorHandler * const handler = entry->handler;
 
-  const uint32_t updating = atomicFetchOr(&handler->updating, entry->mask);
+  const bool empty = bitmapSet(&handler->updating,
+      entryToIndex(handler, entry));
   bool invoke = false;
 
   if (handler->busy)
@@ -79,7 +122,7 @@ static void shOnUpdate(void *argument)
   }
   else
   {
-    if (updating == 0)
+    if (empty)
       invoke = true;
   }
 
@@ -93,7 +136,7 @@ static void shUpdate(void *argument)
 
   if (handler->current != NULL)
   {
-    atomicFetchAnd(&handler->updating, ~handler->current->mask);
+    bitmapClear(&handler->updating, entryToIndex(handler, handler->current));
     handler->busy = sensorUpdate(handler->current->sensor);
 
     if (!handler->busy)
@@ -102,9 +145,10 @@ static void shUpdate(void *argument)
 
   if (!handler->busy)
   {
-    while (handler->detaching)
+    size_t index;
+
+    while ((index = bitmapFindLast(&handler->detaching)) != BITMAP_NONE)
     {
-      const uint32_t index = 31 - countLeadingZeros32(handler->detaching);
       struct SHEntry * const entry = &handler->sensors[index];
 
       sensorSetErrorCallback(entry->sensor, NULL);
@@ -113,18 +157,22 @@ static void shUpdate(void *argument)
       sensorSetCallbackArgument(entry->sensor, NULL);
       entry->sensor = NULL;
 
-      atomicFetchAnd(&handler->detaching, ~entry->mask);
-      atomicFetchAnd(&handler->updating, ~entry->mask);
-      atomicFetchOr(&handler->pool, entry->mask);
+      bitmapClear(&handler->detaching, index);
+      bitmapClear(&handler->updating, index);
+      bitmapSet(&handler->pool, index);
     }
   }
 
-  while (!handler->busy && handler->updating != 0)
+  while (!handler->busy)
   {
-    const uint32_t index = 31 - countLeadingZeros32(handler->updating);
+    const size_t index = bitmapFindLast(&handler->updating);
+
+    if (index == BITMAP_NONE)
+      break;
+
     struct SHEntry * const entry = &handler->sensors[index];
 
-    atomicFetchAnd(&handler->updating, ~entry->mask);
+    bitmapClear(&handler->updating, index);
     handler->busy = sensorUpdate(entry->sensor);
 
     if (handler->busy)
@@ -147,21 +195,48 @@ static void updateTask(void *argument)
 /*----------------------------------------------------------------------------*/
 bool shInit(struct SensorHandler *handler, size_t capacity)
 {
-  handler->sensors = malloc(sizeof(struct SHEntry) * capacity);
-  if (handler->sensors == NULL)
+  assert(capacity > 0 && capacity <= BITMAP_MAX_SIZE);
+
+  struct SHEntry * const sensors = malloc(sizeof(struct SHEntry) * capacity
+      + sizeof(uint32_t) * BITMAP_WORDS(capacity) * 3);
+
+  if (sensors == NULL)
     return false;
 
+  shInitStatic(handler, sensors, (uint32_t *)(sensors + capacity), capacity);
+  handler->allocated = true;
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Initialize the sensor handler using caller-provided storage.
+ * @param handler Pointer to a SensorHandler object.
+ * @param sensors Array of entries with @b capacity elements.
+ * @param words Array for sensor bitmaps with a size of at least
+ * 3 * BITMAP_WORDS(capacity) elements.
+ * @param capacity Maximum number of attached sensors.
+ */
+void shInitStatic(struct SensorHandler *handler, struct SHEntry *sensors,
+    uint32_t *words, size_t capacity)
+{
+  assert(capacity > 0 && capacity <= BITMAP_MAX_SIZE);
+
+  const size_t count = BITMAP_WORDS(capacity);
+
+  handler->sensors = sensors;
   for (size_t index = 0; index < capacity; ++index)
   {
     handler->sensors[index].handler = handler;
     handler->sensors[index].sensor = NULL;
-    handler->sensors[index].mask = 1UL << index;
   }
 
+  bitmapInit(&handler->pool, words, capacity, true);
+  bitmapInit(&handler->detaching, words + count, capacity, false);
+  bitmapInit(&handler->updating, words + count * 2, capacity, false);
+
   handler->capacity = capacity;
-  handler->pool = (1UL << capacity) - 1;
-  handler->detaching = 0;
-  handler->updating = 0;
+  handler->allocated = false;
   handler->busy = false;
   handler->pending = false;
 
@@ -173,30 +248,38 @@ bool shInit(struct SensorHandler *handler, size_t capacity)
   handler->failureCallback = NULL;
   handler->failureCallbackArgument = NULL;
 
+  handler->batch.buffer = NULL;
+  handler->batch.callback = NULL;
+  handler->batch.argument = NULL;
+  handler->batch.length = 0;
+  handler->batch.stride = 0;
+  handler->batch.head = 0;
+  handler->batch.tail = 0;
+  handler->batch.mask = 0;
+  handler->batch.watermark = 0;
+  handler->batch.dropped = 0;
+
   handler->errorCallback = NULL;
   handler->errorCallbackArgument = NULL;
   handler->idleCallback = NULL;
   handler->idleCallbackArgument = NULL;
   handler->updateCallback = NULL;
   handler->updateCallbackArgument = NULL;
-
-  return true;
 }
 /*----------------------------------------------------------------------------*/
 void shDeinit(struct SensorHandler *handler)
 {
-  free(handler->sensors);
+  if (handler->allocated)
+    free(handler->sensors);
 }
 /*----------------------------------------------------------------------------*/
 bool shAttach(struct SensorHandler *handler, void *sensor, int tag)
 {
-  while (handler->pool)
-  {
-    const unsigned int channel = 31 - countLeadingZeros32(handler->pool);
-    const uint32_t mask = 1UL << channel;
-    const uint32_t pool = atomicFetchAnd(&handler->pool, ~mask);
+  size_t channel;
 
-    if (!(pool & mask))
+  while ((channel = bitmapFindLast(&handler->pool)) != BITMAP_NONE)
+  {
+    if (!bitmapClear(&handler->pool, channel))
       continue;
 
     struct SHEntry * const entry = &handler->sensors[channel];
@@ -228,7 +311,7 @@ void shDetach(struct SensorHandler *handler, void *sensor)
 
     if (entry->sensor == sensor)
     {
-      atomicFetchOr(&handler->detaching, entry->mask);
+      bitmapSet(&handler->detaching, index);
       invokeUpdate(handler);
       break;
     }
@@ -249,6 +332,92 @@ void shSetFailureCallback(struct SensorHandler *handler,
   handler->failureCallback = callback;
 }
 /*----------------------------------------------------------------------------*/
+/**
+ * Enable batch delivery of measurement results. Results are copied into
+ * a ring buffer together with sensor tags and timestamps instead of calling
+ * the data callback for each sample. Results are produced in the context
+ * of the sensor handler executor, the ring should be drained by a single
+ * consumer.
+ * @param handler Pointer to a SensorHandler object.
+ * @param buffer Ring buffer of @b size elements of SH_SAMPLE_SIZE(length)
+ * bytes, aligned to 8 bytes. Pass NULL to disable batch delivery.
+ * @param size Number of elements in the buffer, must be a power of two.
+ * @param length Maximum payload length. Array results of sensors in FIFO
+ * mode are stored as a single sample when they fit, longer results
+ * are delivered with the data callback.
+ * @param watermark Number of buffered samples that triggers
+ * the batch callback.
+ */
+void shSetBatchBuffer(struct SensorHandler *handler, void *buffer,
+    size_t size, size_t length, size_t watermark)
+{
+  assert(buffer == NULL || (size > 0 && !(size & (size - 1))));
+  assert(buffer == NULL || (watermark > 0 && watermark <= size));
+  assert(buffer == NULL || length > 0);
+
+  handler->batch.buffer = NULL;
+  handler->batch.length = (uint32_t)length;
+  handler->batch.stride = (uint32_t)SH_SAMPLE_SIZE(length);
+  handler->batch.head = 0;
+  handler->batch.tail = 0;
+  handler->batch.mask = (uint32_t)size - 1;
+  handler->batch.watermark = (uint32_t)watermark;
+  handler->batch.dropped = 0;
+  handler->batch.buffer = buffer;
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Set the callback that is invoked when the number of buffered samples
+ * reaches the watermark. The callback is invoked once per crossing,
+ * the consumer should drain the buffer below the watermark to receive
+ * further notifications.
+ * @param handler Pointer to a SensorHandler object.
+ * @param callback Callback function.
+ * @param argument Callback argument.
+ */
+void shSetBatchCallback(struct SensorHandler *handler,
+    void (*callback)(void *), void *argument)
+{
+  handler->batch.argument = argument;
+  handler->batch.callback = callback;
+}
+/*----------------------------------------------------------------------------*/
+uint32_t shGetDroppedSamples(const struct SensorHandler *handler)
+{
+  return handler->batch.dropped;
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Get a contiguous block of buffered samples without copying. Samples
+ * of the block are iterated with shNextSample.
+ * @param handler Pointer to a SensorHandler object.
+ * @param samples Pointer to the first sample of the block.
+ * @return Number of samples in the block. The block may be shorter than
+ * the number of buffered samples when the ring wraps around.
+ */
+size_t shGetSamples(struct SensorHandler *handler,
+    const struct SHSample **samples)
+{
+  const uint32_t tail = handler->batch.tail;
+  const uint32_t count = atomicLoad(&handler->batch.head) - tail;
+  const uint32_t position = tail & handler->batch.mask;
+  const uint32_t available = handler->batch.mask + 1 - position;
+
+  *samples = (const struct SHSample *)(handler->batch.buffer
+      + position * handler->batch.stride);
+  return MIN(count, available);
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Release samples obtained with shGetSamples.
+ * @param handler Pointer to a SensorHandler object.
+ * @param count Number of processed samples.
+ */
+void shReleaseSamples(struct SensorHandler *handler, size_t count)
+{
+  atomicStore(&handler->batch.tail, handler->batch.tail + (uint32_t)count);
+}
+/*----------------------------------------------------------------------------*/
 void shSetErrorCallback(void *object, void (*callback)(void *), void *argument)
 {
   struct SensorHandler * const handler = object;
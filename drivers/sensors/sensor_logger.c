@@ -0,0 +1,606 @@
+/*
+ * sensor_logger.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#include <dpm/sensors/sensor_logger.h>
+#include <halm/generic/flash.h>
+#include <halm/irq.h>
+#include <halm/timer.h>
+#include <xcore/atomic.h>
+#include <xcore/interface.h>
+#include <xcore/memory.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+/*----------------------------------------------------------------------------*/
+#define BUFFER_NONE       0xFF
+#define MIN_PAGE_SIZE     128
+#define RECORD_DEFINITION 0x80
+
+enum State
+{
+  STATE_IDLE,
+  STATE_ERASE,
+  STATE_WRITE
+};
+/*----------------------------------------------------------------------------*/
+static bool acquireBuffer(struct SensorLogger *);
+static void advancePosition(struct SensorLogger *);
+static uint64_t calcElementDelta(const uint8_t *, const uint8_t *, size_t);
+static void drainSamples(struct SensorLogger *);
+static bool encodeSample(struct SensorLogger *, size_t, uint64_t,
+    const uint8_t *);
+static uint8_t *encodeVarint(uint8_t *, const uint8_t *, uint64_t);
+static void finishTransfer(struct SensorLogger *, bool);
+static inline uint64_t getTime(const struct SensorLogger *);
+static void logSample(struct SensorLogger *, int, uint64_t, const uint8_t *,
+    size_t);
+static void onBatchReady(void *);
+static void onMemoryEvent(void *);
+static void onSensorData(void *, int, const void *, size_t);
+static bool readBlockSequence(struct SensorLogger *, uint32_t, uint32_t *);
+static void restorePosition(struct SensorLogger *);
+static void startTransfer(struct SensorLogger *);
+static void submitBuffer(struct SensorLogger *);
+static inline uint64_t zigzagEncode(int64_t);
+/*----------------------------------------------------------------------------*/
+static bool acquireBuffer(struct SensorLogger *logger)
+{
+  const uint8_t busy = atomicLoad(&logger->busy);
+
+  for (uint8_t index = 0; index < 2; ++index)
+  {
+    if (busy & (1 << index))
+      continue;
+
+    /* Unused space of the page keeps the erased state */
+    memset(logger->buffers[index], 0xFF, logger->pageSize);
+
+    logger->active = index;
+    logger->length = SL_BLOCK_HEADER_SIZE;
+    logger->records[index] = 0;
+    logger->timestamp = 0;
+
+    /* Each block is decoded independently */
+    for (size_t stream = 0; stream < logger->count; ++stream)
+    {
+      memset(logger->streams[stream].previous, 0,
+          sizeof(logger->streams[stream].previous));
+      logger->streams[stream].defined = false;
+    }
+
+    return true;
+  }
+
+  return false;
+}
+/*----------------------------------------------------------------------------*/
+static void advancePosition(struct SensorLogger *logger)
+{
+  logger->position += logger->pageSize;
+
+  /* Oldest data is overwritten when the end of the region is reached */
+  if (logger->position - logger->offset >= logger->size)
+    logger->position = logger->offset;
+}
+/*----------------------------------------------------------------------------*/
+static uint64_t calcElementDelta(const uint8_t *current,
+    const uint8_t *previous, size_t width)
+{
+  /* Difference is truncated to the element width and then sign-extended */
+  switch (width)
+  {
+    case 1:
+      return zigzagEncode((int8_t)(uint8_t)(*current - *previous));
+
+    case 2:
+    {
+      uint16_t a;
+      uint16_t b;
+
+      memcpy(&a, current, sizeof(a));
+      memcpy(&b, previous, sizeof(b));
+      return zigzagEncode((int16_t)(uint16_t)(a - b));
+    }
+
+    case 4:
+    {
+      uint32_t a;
+      uint32_t b;
+
+      memcpy(&a, current, sizeof(a));
+      memcpy(&b, previous, sizeof(b));
+      return zigzagEncode((int32_t)(a - b));
+    }
+
+    default:
+    {
+      uint64_t a;
+      uint64_t b;
+
+      memcpy(&a, current, sizeof(a));
+      memcpy(&b, previous, sizeof(b));
+      return zigzagEncode((int64_t)(a - b));
+    }
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void drainSamples(struct SensorLogger *logger)
+{
+  const struct SHSample *sample;
+  size_t count;
+
+  if (logger->handler->batch.buffer == NULL)
+    return;
+
+  while ((count = shGetSamples(logger->handler, &sample)) > 0)
+  {
+    for (size_t index = 0; index < count; ++index)
+    {
+      /* Time of the logging is used when the sensor has no timestamps */
+      const uint64_t timestamp = sample->timestamp ?
+          sample->timestamp : getTime(logger);
+
+      logSample(logger, sample->tag, timestamp, sample->data, sample->length);
+      sample = shNextSample(logger->handler, sample);
+    }
+
+    shReleaseSamples(logger->handler, count);
+  }
+}
+/*----------------------------------------------------------------------------*/
+static bool encodeSample(struct SensorLogger *logger, size_t index,
+    uint64_t timestamp, const uint8_t *data)
+{
+  struct SLStream * const stream = &logger->streams[index];
+  uint8_t * const buffer = logger->buffers[logger->active];
+  const uint8_t * const end = buffer + logger->pageSize;
+  const size_t width = sensorElementSize(&stream->descriptor);
+  uint8_t *cursor = buffer + logger->length;
+
+  if (cursor == end)
+    return false;
+
+  /* Record is written in place and committed only when it fits */
+  if (!stream->defined)
+  {
+    *cursor++ = (uint8_t)index | RECORD_DEFINITION;
+
+    cursor = encodeVarint(cursor, end, zigzagEncode(stream->tag));
+    if (cursor == NULL || end - cursor < 4)
+      return false;
+
+    *cursor++ = stream->descriptor.type;
+    *cursor++ = stream->descriptor.count;
+    *cursor++ = (uint8_t)stream->descriptor.exponent;
+    *cursor++ = stream->descriptor.unit;
+  }
+  else
+    *cursor++ = (uint8_t)index;
+
+  cursor = encodeVarint(cursor, end,
+      zigzagEncode((int64_t)(timestamp - logger->timestamp)));
+
+  for (size_t element = 0; element < stream->descriptor.count; ++element)
+  {
+    const size_t offset = element * width;
+
+    cursor = encodeVarint(cursor, end,
+        calcElementDelta(data + offset, stream->previous + offset, width));
+  }
+
+  if (cursor == NULL)
+    return false;
+
+  memcpy(stream->previous, data, width * stream->descriptor.count);
+  stream->defined = true;
+
+  logger->length = (uint32_t)(cursor - buffer);
+  logger->timestamp = timestamp;
+  ++logger->records[logger->active];
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+static uint8_t *encodeVarint(uint8_t *cursor, const uint8_t *end,
+    uint64_t value)
+{
+  if (cursor == NULL)
+    return NULL;
+
+  do
+  {
+    if (cursor == end)
+      return NULL;
+
+    *cursor++ = (uint8_t)(value & 0x7F) | (value > 0x7F ? 0x80 : 0);
+    value >>= 7;
+  }
+  while (value);
+
+  return cursor;
+}
+/*----------------------------------------------------------------------------*/
+static void finishTransfer(struct SensorLogger *logger, bool success)
+{
+  /* Failed pages are skipped to avoid retrying a damaged location */
+  if (!success)
+    atomicFetchAdd(&logger->dropped, logger->records[logger->current]);
+
+  advancePosition(logger);
+
+  const uint8_t next = logger->current ^ 1;
+  const uint8_t busy = atomicFetchAnd(&logger->busy,
+      ~(1 << logger->current));
+
+  if (busy & (1 << next))
+  {
+    logger->current = next;
+    startTransfer(logger);
+  }
+  else
+    logger->state = STATE_IDLE;
+}
+/*----------------------------------------------------------------------------*/
+static void onMemoryEvent(void *argument)
+{
+  struct SensorLogger * const logger = argument;
+  const enum Result res = ifGetParam(logger->memory, IF_STATUS, NULL);
+
+  if (res == E_BUSY)
+    return;
+
+  if (res == E_OK && logger->state == STATE_ERASE)
+  {
+    logger->state = STATE_WRITE;
+
+    ifSetParam(logger->memory, IF_POSITION, &logger->position);
+    ifWrite(logger->memory, logger->buffers[logger->current],
+        logger->pageSize);
+    return;
+  }
+
+  finishTransfer(logger, res == E_OK);
+}
+/*----------------------------------------------------------------------------*/
+static inline uint64_t getTime(const struct SensorLogger *logger)
+{
+  return logger->chrono != NULL ? timerGetValue64(logger->chrono) : 0;
+}
+/*----------------------------------------------------------------------------*/
+static void logSample(struct SensorLogger *logger, int tag,
+    uint64_t timestamp, const uint8_t *data, size_t length)
+{
+  size_t index = 0;
+
+  while (index < logger->count && logger->streams[index].tag != tag)
+    ++index;
+
+  if (index == logger->count)
+    return;
+
+  const struct SensorDescriptor * const descriptor =
+      &logger->streams[index].descriptor;
+  const size_t frame = sensorElementSize(descriptor) * descriptor->count;
+
+  if (!length || length % frame)
+  {
+    atomicFetchAdd(&logger->dropped, 1);
+    return;
+  }
+
+  /* Frames of an array result share the timestamp of the first frame */
+  for (; length; length -= frame, data += frame)
+  {
+    bool written = false;
+
+    for (size_t attempt = 0; attempt < 2; ++attempt)
+    {
+      if (logger->active == BUFFER_NONE && !acquireBuffer(logger))
+        break;
+
+      if ((written = encodeSample(logger, index, timestamp, data)))
+        break;
+
+      /* Block is full, write it and continue in the next buffer */
+      submitBuffer(logger);
+    }
+
+    if (!written)
+      atomicFetchAdd(&logger->dropped, 1);
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void onBatchReady(void *argument)
+{
+  drainSamples(argument);
+}
+/*----------------------------------------------------------------------------*/
+static void onSensorData(void *argument, int tag, const void *data,
+    size_t length)
+{
+  struct SensorLogger * const logger = argument;
+  logSample(logger, tag, getTime(logger), data, length);
+}
+/*----------------------------------------------------------------------------*/
+static bool readBlockSequence(struct SensorLogger *logger, uint32_t position,
+    uint32_t *sequence)
+{
+  uint8_t header[SL_BLOCK_HEADER_SIZE];
+  uint16_t length;
+  uint16_t magic;
+  uint32_t value;
+
+  if (ifSetParam(logger->memory, IF_POSITION, &position) != E_OK)
+    return false;
+  if (ifRead(logger->memory, header, sizeof(header)) != sizeof(header))
+    return false;
+
+  memcpy(&magic, header, sizeof(magic));
+  memcpy(&length, header + 2, sizeof(length));
+  memcpy(&value, header + 4, sizeof(value));
+
+  if (fromLittleEndian16(magic) != SL_BLOCK_MAGIC)
+    return false;
+
+  length = fromLittleEndian16(length);
+  if (length < SL_BLOCK_HEADER_SIZE || length > logger->pageSize)
+    return false;
+
+  *sequence = fromLittleEndian32(value);
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+static void restorePosition(struct SensorLogger *logger)
+{
+  uint32_t last = 0;
+  uint32_t sector = 0;
+  bool found = false;
+
+  /*
+   * Sectors are erased and filled in order, therefore the newest block
+   * is located in the sector with the newest first block.
+   */
+  for (uint32_t offset = 0; offset < logger->size; offset += logger->eraseSize)
+  {
+    uint32_t sequence;
+
+    if (readBlockSequence(logger, logger->offset + offset, &sequence)
+        && (!found || sequence > last))
+    {
+      found = true;
+      last = sequence;
+      sector = offset;
+    }
+  }
+
+  if (!found)
+    return;
+
+  for (uint32_t offset = logger->pageSize; offset < logger->eraseSize;
+      offset += logger->pageSize)
+  {
+    uint32_t sequence;
+
+    if (readBlockSequence(logger, logger->offset + sector + offset, &sequence)
+        && sequence > last)
+    {
+      last = sequence;
+    }
+  }
+
+  /* New session starts in the next sector to avoid writing to used pages */
+  sector += logger->eraseSize;
+  if (sector >= logger->size)
+    sector = 0;
+
+  logger->position = logger->offset + sector;
+  logger->sequence = last + 1;
+}
+/*----------------------------------------------------------------------------*/
+static void startTransfer(struct SensorLogger *logger)
+{
+  if (logger->position % logger->eraseSize == 0)
+  {
+    logger->state = STATE_ERASE;
+
+    const enum Result res = ifSetParam(logger->memory,
+        logger->eraseParameter, &logger->position);
+
+    if (res == E_BUSY)
+      return;
+
+    if (res != E_OK)
+    {
+      finishTransfer(logger, false);
+      return;
+    }
+  }
+
+  logger->state = STATE_WRITE;
+
+  ifSetParam(logger->memory, IF_POSITION, &logger->position);
+  ifWrite(logger->memory, logger->buffers[logger->current], logger->pageSize);
+}
+/*----------------------------------------------------------------------------*/
+static void submitBuffer(struct SensorLogger *logger)
+{
+  uint8_t * const buffer = logger->buffers[logger->active];
+  const uint16_t length = toLittleEndian16((uint16_t)logger->length);
+  const uint16_t magic = toLittleEndian16(SL_BLOCK_MAGIC);
+  const uint32_t sequence = toLittleEndian32(logger->sequence++);
+
+  memcpy(buffer, &magic, sizeof(magic));
+  memcpy(buffer + 2, &length, sizeof(length));
+  memcpy(buffer + 4, &sequence, sizeof(sequence));
+
+  const IrqState state = irqSave();
+
+  atomicFetchOr(&logger->busy, 1 << logger->active);
+
+  if (logger->state == STATE_IDLE)
+  {
+    logger->current = logger->active;
+    startTransfer(logger);
+  }
+
+  irqRestore(state);
+
+  logger->active = BUFFER_NONE;
+}
+/*----------------------------------------------------------------------------*/
+static inline uint64_t zigzagEncode(int64_t value)
+{
+  return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Initialize the logger and subscribe it to the data and batch callbacks of
+ * the sensor handler. When batch delivery is enabled, the logger drains
+ * the batch buffer and uses timestamps of the samples, otherwise samples
+ * are stamped with the time of the data callback. Logging resumes in the
+ * sector after the newest block found in the log region, sequence numbers
+ * continue from that block. The memory interface is switched to zero-copy
+ * mode.
+ * @param logger Pointer to a SensorLogger object.
+ * @param config Pointer to a configuration structure.
+ * @return @b true on success or @b false when the memory is unsupported or
+ * allocation has failed.
+ */
+bool slInit(struct SensorLogger *logger,
+    const struct SensorLoggerConfig *config)
+{
+  assert(config != NULL);
+  assert(config->memory != NULL);
+  assert(config->handler != NULL);
+  assert(config->capacity > 0 && config->capacity <= SL_MAX_STREAMS);
+
+  uint32_t capacity;
+  uint32_t eraseSize;
+  uint32_t pageSize;
+
+  if (ifGetParam(config->memory, IF_FLASH_PAGE_SIZE, &pageSize) != E_OK)
+    return false;
+  if (ifGetParam(config->memory, IF_SIZE, &capacity) != E_OK)
+    return false;
+
+  if (ifGetParam(config->memory, IF_FLASH_SECTOR_SIZE, &eraseSize) == E_OK)
+  {
+    logger->eraseParameter = IF_FLASH_ERASE_SECTOR;
+  }
+  else if (ifGetParam(config->memory, IF_FLASH_BLOCK_SIZE, &eraseSize) == E_OK)
+  {
+    logger->eraseParameter = IF_FLASH_ERASE_BLOCK;
+  }
+  else
+    return false;
+
+  const uint32_t size = config->size ? config->size : capacity - config->offset;
+
+  if (pageSize < MIN_PAGE_SIZE || pageSize > UINT16_MAX)
+    return false;
+  if (config->offset % eraseSize || config->offset >= capacity)
+    return false;
+  if (size < eraseSize || size > capacity - config->offset)
+    return false;
+
+  uint8_t * const buffers = malloc(pageSize * 2
+      + sizeof(struct SLStream) * config->capacity);
+
+  if (buffers == NULL)
+    return false;
+
+  logger->memory = config->memory;
+  logger->handler = config->handler;
+  logger->chrono = config->chrono;
+  logger->buffers[0] = buffers;
+  logger->buffers[1] = buffers + pageSize;
+  logger->streams = (struct SLStream *)(buffers + pageSize * 2);
+  logger->timestamp = 0;
+  logger->eraseSize = eraseSize;
+  logger->pageSize = pageSize;
+  logger->offset = config->offset;
+  logger->size = size - size % eraseSize;
+  logger->position = config->offset;
+  logger->sequence = 0;
+  logger->length = 0;
+  logger->dropped = 0;
+  logger->capacity = config->capacity;
+  logger->count = 0;
+  logger->records[0] = 0;
+  logger->records[1] = 0;
+  logger->active = BUFFER_NONE;
+  logger->busy = 0;
+  logger->current = 0;
+  logger->state = STATE_IDLE;
+
+  ifSetParam(logger->memory, IF_BLOCKING, NULL);
+  restorePosition(logger);
+
+  ifSetParam(logger->memory, IF_ZEROCOPY, NULL);
+  ifSetCallback(logger->memory, onMemoryEvent, logger);
+  shSetBatchCallback(logger->handler, onBatchReady, logger);
+  shSetDataCallback(logger->handler, onSensorData, logger);
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+void slDeinit(struct SensorLogger *logger)
+{
+  shSetBatchCallback(logger->handler, NULL, NULL);
+  shSetDataCallback(logger->handler, NULL, NULL);
+  ifSetCallback(logger->memory, NULL, NULL);
+  free(logger->buffers[0]);
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Attach a sample stream to the logger.
+ * @param logger Pointer to a SensorLogger object.
+ * @param tag Sensor tag used in the sensor handler.
+ * @param descriptor Descriptor of the sensor results.
+ * @return @b true on success or @b false when the logger is full or
+ * the descriptor is unsupported.
+ */
+bool slAttach(struct SensorLogger *logger, int tag,
+    const struct SensorDescriptor *descriptor)
+{
+  const size_t length = sensorElementSize(descriptor) * descriptor->count;
+
+  if (!length || length > SH_SAMPLE_LENGTH)
+    return false;
+  if (logger->count == logger->capacity)
+    return false;
+
+  struct SLStream * const stream = &logger->streams[logger->count];
+
+  memset(stream->previous, 0, sizeof(stream->previous));
+  stream->descriptor = *descriptor;
+  stream->tag = tag;
+  stream->defined = false;
+
+  /* Definition of the new stream will be added to the active block */
+  ++logger->count;
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Write the partially filled block to the memory. Samples remaining in
+ * the batch buffer of the sensor handler are logged first. The function
+ * should be called from the same context as the data callback of
+ * the sensor handler.
+ * @param logger Pointer to a SensorLogger object.
+ */
+void slFlush(struct SensorLogger *logger)
+{
+  drainSamples(logger);
+
+  if (logger->active != BUFFER_NONE && logger->length > SL_BLOCK_HEADER_SIZE)
+    submitBuffer(logger);
+}
+/*----------------------------------------------------------------------------*/
+uint32_t slGetDroppedSamples(const struct SensorLogger *logger)
+{
+  return atomicLoad(&logger->dropped);
+}
@@ -0,0 +1,117 @@
+/*
+ * sensor_packer.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#include <dpm/sensors/sensor_packer.h>
+#include <xcore/memory.h>
+#include <string.h>
+/*----------------------------------------------------------------------------*/
+static void packElements(uint8_t *, const uint8_t *, size_t, size_t);
+/*----------------------------------------------------------------------------*/
+static void packElements(uint8_t *output, const uint8_t *input, size_t width,
+    size_t count)
+{
+  /* Byte order conversion is optimized out on little-endian targets */
+  switch (width)
+  {
+    case 2:
+      for (size_t index = 0; index < count; ++index)
+      {
+        uint16_t value;
+
+        memcpy(&value, input + index * 2, sizeof(value));
+        value = toLittleEndian16(value);
+        memcpy(output + index * 2, &value, sizeof(value));
+      }
+      break;
+
+    case 4:
+      for (size_t index = 0; index < count; ++index)
+      {
+        uint32_t value;
+
+        memcpy(&value, input + index * 4, sizeof(value));
+        value = toLittleEndian32(value);
+        memcpy(output + index * 4, &value, sizeof(value));
+      }
+      break;
+
+    case 8:
+      for (size_t index = 0; index < count; ++index)
+      {
+        uint64_t value;
+
+        memcpy(&value, input + index * 8, sizeof(value));
+        value = toLittleEndian64(value);
+        memcpy(output + index * 8, &value, sizeof(value));
+      }
+      break;
+
+    default:
+      memcpy(output, input, count);
+      break;
+  }
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Serialize a measurement result directly into the output buffer. Array
+ * results of sensors in FIFO mode are packed as consecutive records,
+ * one record for each frame.
+ * @param buffer Output buffer.
+ * @param capacity Size of the output buffer.
+ * @param tag User-defined tag of the record.
+ * @param descriptor Descriptor of the sensor that produced the result.
+ * @param payload Result passed to the result callback of the sensor.
+ * @param length Length of the result, should be a multiple of the frame
+ * length defined by the descriptor.
+ * @return Total length of records or zero when the buffer is too small or
+ * the result does not match the descriptor.
+ */
+size_t sensorPack(void *buffer, size_t capacity, uint8_t tag,
+    const struct SensorDescriptor *descriptor, const void *payload,
+    size_t length)
+{
+  const size_t width = sensorElementSize(descriptor);
+  const size_t frame = width * descriptor->count;
+
+  if (!frame || !length || length % frame)
+    return 0;
+
+  const size_t count = length / frame;
+  const size_t total = (SENSOR_PACK_HEADER_SIZE + frame) * count;
+  const uint8_t *input = payload;
+  uint8_t *output = buffer;
+
+  if (total > capacity)
+    return 0;
+
+  for (size_t index = 0; index < count; ++index)
+  {
+    output[0] = tag;
+    output[1] = descriptor->type;
+    output[2] = descriptor->count;
+    output[3] = (uint8_t)descriptor->exponent;
+    output[4] = descriptor->unit;
+
+    packElements(output + SENSOR_PACK_HEADER_SIZE, input, width,
+        descriptor->count);
+
+    input += frame;
+    output += SENSOR_PACK_HEADER_SIZE + frame;
+  }
+
+  return total;
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Calculate the length of a packed record.
+ * @param descriptor Descriptor of the sensor.
+ * @return Length of the record including the header.
+ */
+size_t sensorPackLength(const struct SensorDescriptor *descriptor)
+{
+  return SENSOR_PACK_HEADER_SIZE
+      + sensorElementSize(descriptor) * descriptor->count;
+}
@@ -7,6 +7,7 @@
 #include <dpm/sensors/sht2x.h>
 #include <dpm/sensors/sht2x_defs.h>
 #include <halm/timer.h>
+#include <xcore/accel.h>
 #include <xcore/atomic.h>
 #include <xcore/bits.h>
 #include <xcore/interface.h>
@@ -16,6 +17,8 @@
 #define LENGTH_COMMAND  1
 #define LENGTH_CONFIG   2
 
+#define POLL_COUNT      8
+
 enum State
 {
   STATE_IDLE,
@@ -29,6 +32,7 @@ enum State
   STATE_H_READ,
   STATE_H_READ_WAIT,
 
+  STATE_T_NEXT,
   STATE_T_START,
   STATE_T_START_WAIT,
   STATE_T_WAIT,
@@ -43,14 +47,20 @@ enum State
 };
 /*----------------------------------------------------------------------------*/
 static void busInit(struct SHT2X *);
+static int32_t calcDewPoint(int32_t, int32_t);
+static inline uint32_t calcFirstReadTime(const struct SHT2X *, uint32_t);
 static void calcHumidity(struct SHT2X *);
+static int32_t calcLogarithm(uint32_t);
 static inline uint32_t calcResetTimeout(const struct Timer *);
 static uint16_t fetchSample(const struct SHT2X *);
+static inline bool isPollAllowed(const struct SHT2X *);
 static void onBusEvent(void *);
 static void onTimerEvent(void *);
 static uint8_t resolutionToConfig(const struct SHT2X *);
 static uint32_t resolutionToHumidityTime(const struct SHT2X *);
 static uint32_t resolutionToTemperatureTime(const struct SHT2X *);
+static void startBusWatchdog(struct SHT2X *);
+static void startChainedConversion(struct SHT2X *);
 static void startConfigWrite(struct SHT2X *);
 static void startHumidityConversion(struct SHT2X *);
 static void startSampleRead(struct SHT2X *);
@@ -58,6 +68,7 @@ static void startTemperatureConversion(struct SHT2X *);
 
 static enum Result shtInit(void *, const void *);
 static void shtDeinit(void *);
+static const struct SensorDescriptor *shtGetDescriptor(const void *);
 static const char *shtGetFormat(const void *);
 static enum SensorStatus shtGetStatus(const void *);
 static uint64_t shtGetTimestamp(const void *);
@@ -78,6 +89,7 @@ const struct SensorClass * const SHT2X = &(const struct SensorClass){
     .init = shtInit,
     .deinit = shtDeinit,
 
+    .getDescriptor = shtGetDescriptor,
     .getFormat = shtGetFormat,
     .getStatus = shtGetStatus,
     .getTimestamp = shtGetTimestamp,
@@ -105,10 +117,30 @@ static void busInit(struct SHT2X *sensor)
   if (sensor->rate)
     ifSetParam(sensor->bus, IF_RATE, &sensor->rate);
 
-  /* Start bus watchdog */
-  timerSetOverflow(sensor->timer, calcResetTimeout(sensor->timer));
-  timerSetValue(sensor->timer, 0);
-  timerEnable(sensor->timer);
+  startBusWatchdog(sensor);
+}
+/*----------------------------------------------------------------------------*/
+static int32_t calcDewPoint(int32_t temperature, int32_t humidity)
+{
+  /* Magnus formula coefficients: b = 17.62 in Q16.16, c = 243.12 C in Q24.8 */
+  static const int64_t b = 1154744;
+  static const int64_t c = 62239;
+
+  /* Relative humidity as a fraction in Q16.16 format */
+  const uint32_t ratio = (uint32_t)MAX(humidity, 1) * 256 / 100;
+  /* Gamma = ln(RH) + b * T / (c + T) in Q16.16 format */
+  const int64_t gamma = calcLogarithm(ratio)
+      + b * temperature / (c + temperature);
+
+  /* Dew point = c * gamma / (b - gamma) in Q24.8 format */
+  return (int32_t)(c * gamma / (b - gamma));
+}
+/*----------------------------------------------------------------------------*/
+static inline uint32_t calcFirstReadTime(const struct SHT2X *sensor,
+    uint32_t time)
+{
+  /* Typical conversion time is about 3/4 of the maximum conversion time */
+  return sensor->poll ? time - (time >> 2) : time;
 }
 /*----------------------------------------------------------------------------*/
 static void calcHumidity(struct SHT2X *sensor)
@@ -121,11 +153,44 @@ static void calcHumidity(struct SHT2X *sensor)
   sensor->onResultCallback(sensor->callbackArgument,
       &humidity, sizeof(humidity));
 
-  if (atomicLoad(&sensor->flags) & (FLAG_THERMO_LOOP | FLAG_THERMO_SAMPLE))
+  const uint8_t flags = atomicLoad(&sensor->flags);
+
+  if (flags & (FLAG_THERMO_LOOP | FLAG_THERMO_SAMPLE))
   {
     sensor->thermometer->onResultCallback(sensor->thermometer->callbackArgument,
         &temperature, sizeof(temperature));
   }
+
+  if (flags & (FLAG_DEW_LOOP | FLAG_DEW_SAMPLE))
+  {
+    const int32_t dewPoint = calcDewPoint(temperature, humidity);
+
+    sensor->dewPoint->onResultCallback(sensor->dewPoint->callbackArgument,
+        &dewPoint, sizeof(dewPoint));
+  }
+}
+/*----------------------------------------------------------------------------*/
+static int32_t calcLogarithm(uint32_t value)
+{
+  /* Coefficients of log2(1 + x) approximation in Q16.16 format */
+  static const int64_t a1 = 93290;
+  static const int64_t a2 = -38519;
+  static const int64_t a3 = 10851;
+  /* Natural logarithm of 2 in Q16.16 format */
+  static const int64_t ln2 = 45426;
+
+  assert(value > 0);
+
+  const int32_t exponent = 31 - (int32_t)countLeadingZeros32(value);
+  const int64_t mantissa = exponent >= 16 ?
+      (value >> (exponent - 16)) : (value << (16 - exponent));
+  const int64_t x = mantissa - 65536;
+
+  /* Binary logarithm in Q16.16 format */
+  const int64_t fraction = ((((a3 * x >> 16) + a2) * x >> 16) + a1) * x >> 16;
+  const int64_t log2 = (exponent - 16) * 65536 + fraction;
+
+  return (int32_t)(log2 * ln2 >> 16);
 }
 /*----------------------------------------------------------------------------*/
 static inline uint32_t calcResetTimeout(const struct Timer *timer)
@@ -142,17 +207,40 @@ static uint16_t fetchSample(const struct SHT2X *sensor)
   return value;
 }
 /*----------------------------------------------------------------------------*/
+static inline bool isPollAllowed(const struct SHT2X *sensor)
+{
+  return sensor->poll && sensor->polls
+      && (sensor->state == STATE_H_READ_WAIT
+          || sensor->state == STATE_T_READ_WAIT);
+}
+/*----------------------------------------------------------------------------*/
 static void onBusEvent(void *object)
 {
   struct SHT2X * const sensor = object;
+  bool release = true;
   bool waitForTimeout = false;
 
   timerDisable(sensor->timer);
 
   if (ifGetParam(sensor->bus, IF_STATUS, NULL) != E_OK)
   {
-    sensor->state = STATE_ERROR_WAIT;
-    timerSetOverflow(sensor->timer, calcResetTimeout(sensor->timer));
+    if (isPollAllowed(sensor))
+    {
+      /* Sensor does not acknowledge the address until conversion ends */
+      const bool humidity = sensor->state == STATE_H_READ_WAIT;
+      const uint32_t time = humidity ?
+          resolutionToHumidityTime(sensor) : resolutionToTemperatureTime(sensor);
+
+      --sensor->polls;
+      sensor->state = humidity ? STATE_H_WAIT : STATE_T_WAIT;
+      timerSetOverflow(sensor->timer, MAX(time >> 4, 1));
+    }
+    else
+    {
+      sensor->state = STATE_ERROR_WAIT;
+      timerSetOverflow(sensor->timer, calcResetTimeout(sensor->timer));
+    }
+
     waitForTimeout = true;
   }
 
@@ -165,19 +253,25 @@ static void onBusEvent(void *object)
       break;
 
     case STATE_H_START_WAIT:
+      sensor->polls = POLL_COUNT;
       sensor->state = STATE_H_WAIT;
-      timerSetOverflow(sensor->timer, resolutionToHumidityTime(sensor));
+      timerSetOverflow(sensor->timer,
+          calcFirstReadTime(sensor, resolutionToHumidityTime(sensor)));
       waitForTimeout = true;
       break;
 
     case STATE_H_READ_WAIT:
-      sensor->state = STATE_T_START;
+      /* Keep the bus and trigger temperature conversion immediately */
+      sensor->state = STATE_T_NEXT;
       sensor->humidity = fetchSample(sensor);
+      release = false;
       break;
 
     case STATE_T_START_WAIT:
+      sensor->polls = POLL_COUNT;
       sensor->state = STATE_T_WAIT;
-      timerSetOverflow(sensor->timer, resolutionToTemperatureTime(sensor));
+      timerSetOverflow(sensor->timer,
+          calcFirstReadTime(sensor, resolutionToTemperatureTime(sensor)));
       waitForTimeout = true;
       break;
 
@@ -197,8 +291,12 @@ static void onBusEvent(void *object)
     timerEnable(sensor->timer);
   }
 
-  ifSetCallback(sensor->bus, NULL, NULL);
-  ifSetParam(sensor->bus, IF_RELEASE, NULL);
+  if (release)
+  {
+    ifSetCallback(sensor->bus, NULL, NULL);
+    ifSetParam(sensor->bus, IF_RELEASE, NULL);
+  }
+
   sensor->onUpdateCallback(sensor->callbackArgument);
 }
 /*----------------------------------------------------------------------------*/
@@ -317,6 +415,22 @@ static uint32_t resolutionToTemperatureTime(const struct SHT2X *sensor)
   return (overflow + ((1ULL << 32) - 1)) >> 32;
 }
 /*----------------------------------------------------------------------------*/
+static void startBusWatchdog(struct SHT2X *sensor)
+{
+  timerSetOverflow(sensor->timer, calcResetTimeout(sensor->timer));
+  timerSetValue(sensor->timer, 0);
+  timerEnable(sensor->timer);
+}
+/*----------------------------------------------------------------------------*/
+static void startChainedConversion(struct SHT2X *sensor)
+{
+  /* Interface is still locked after the humidity read */
+  sensor->buffer[0] = CMD_TRIGGER_T;
+
+  startBusWatchdog(sensor);
+  ifWrite(sensor->bus, sensor->buffer, LENGTH_COMMAND);
+}
+/*----------------------------------------------------------------------------*/
 static void startConfigWrite(struct SHT2X *sensor)
 {
   sensor->buffer[0] = CMD_WRITE_USER_REG;
@@ -362,6 +476,7 @@ static enum Result shtInit(void *object, const void *configBase)
   sensor->onResultCallback = NULL;
   sensor->onUpdateCallback = NULL;
 
+  sensor->dewPoint = NULL;
   sensor->thermometer = NULL;
   sensor->bus = config->bus;
   sensor->timer = config->timer;
@@ -371,7 +486,9 @@ static enum Result shtInit(void *object, const void *configBase)
   sensor->humidity = 0;
   sensor->temperature = 0;
   sensor->flags = 0;
+  sensor->polls = 0;
   sensor->state = STATE_IDLE;
+  sensor->poll = config->poll;
 
   if (config->resolution != SHT2X_RESOLUTION_DEFAULT)
   {
@@ -397,6 +514,20 @@ static void shtDeinit(void *object)
 
   if (sensor->thermometer != NULL)
     deinit(sensor->thermometer);
+  if (sensor->dewPoint != NULL)
+    deinit(sensor->dewPoint);
+}
+/*----------------------------------------------------------------------------*/
+static const struct SensorDescriptor *shtGetDescriptor(const void *)
+{
+  static const struct SensorDescriptor descriptor = {
+      .type = SENSOR_TYPE_INT16,
+      .count = 1,
+      .exponent = -8,
+      .unit = SENSOR_UNIT_PERCENT
+  };
+
+  return &descriptor;
 }
 /*----------------------------------------------------------------------------*/
 static const char *shtGetFormat(const void *)
@@ -564,6 +695,12 @@ static bool shtUpdate(void *object)
         busy = true;
         break;
 
+      case STATE_T_NEXT:
+        sensor->state = STATE_T_START_WAIT;
+        startChainedConversion(sensor);
+        busy = true;
+        break;
+
       case STATE_T_START:
         sensor->state = STATE_T_START_WAIT;
         startTemperatureConversion(sensor);
@@ -591,7 +728,8 @@ static bool shtUpdate(void *object)
         calcHumidity(sensor);
 
         sensor->state = STATE_IDLE;
-        atomicFetchAnd(&sensor->flags, ~(FLAG_SAMPLE | FLAG_THERMO_SAMPLE));
+        atomicFetchAnd(&sensor->flags,
+            ~(FLAG_SAMPLE | FLAG_THERMO_SAMPLE | FLAG_DEW_SAMPLE));
 
         updated = true;
         break;
@@ -618,6 +756,20 @@ static bool shtUpdate(void *object)
   return busy;
 }
 /*----------------------------------------------------------------------------*/
+struct SHT2XDewPoint *sht2xMakeDewPoint(struct SHT2X *sensor)
+{
+  if (sensor->dewPoint == NULL)
+  {
+    const struct SHT2XDewPointConfig config = {
+        .parent = sensor
+    };
+
+    sensor->dewPoint = init(SHT2XDewPoint, &config);
+  }
+
+  return sensor->dewPoint;
+}
+/*----------------------------------------------------------------------------*/
 struct SHT2XThermometer *sht2xMakeThermometer(struct SHT2X *sensor)
 {
   if (sensor->thermometer == NULL)
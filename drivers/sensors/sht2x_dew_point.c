@@ -0,0 +1,158 @@
+/*
+ * sht2x_dew_point.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#include <dpm/sensors/sht2x.h>
+#include <dpm/sensors/sht2x_defs.h>
+#include <xcore/atomic.h>
+#include <assert.h>
+/*----------------------------------------------------------------------------*/
+static enum Result dewInit(void *, const void *);
+static void dewDeinit(void *);
+static const struct SensorDescriptor *dewGetDescriptor(const void *);
+static const char *dewGetFormat(const void *);
+static enum SensorStatus dewGetStatus(const void *);
+static uint64_t dewGetTimestamp(const void *);
+static void dewSetCallbackArgument(void *, void *);
+static void dewSetErrorCallback(void *, void (*)(void *, enum SensorResult));
+static void dewSetResultCallback(void *,
+    void (*)(void *, const void *, size_t));
+static void dewSetUpdateCallback(void *, void (*)(void *));
+static void dewReset(void *);
+static void dewSample(void *);
+static void dewStart(void *);
+static void dewStop(void *);
+static bool dewUpdate(void *);
+/*----------------------------------------------------------------------------*/
+const struct SensorClass * const SHT2XDewPoint =
+    &(const struct SensorClass){
+    .size = sizeof(struct SHT2XDewPoint),
+    .init = dewInit,
+    .deinit = dewDeinit,
+
+    .getDescriptor = dewGetDescriptor,
+    .getFormat = dewGetFormat,
+    .getStatus = dewGetStatus,
+    .getTimestamp = dewGetTimestamp,
+    .setCallbackArgument = dewSetCallbackArgument,
+    .setErrorCallback = dewSetErrorCallback,
+    .setResultCallback = dewSetResultCallback,
+    .setUpdateCallback = dewSetUpdateCallback,
+    .reset = dewReset,
+    .sample = dewSample,
+    .start = dewStart,
+    .stop = dewStop,
+    .update = dewUpdate
+};
+/*----------------------------------------------------------------------------*/
+static enum Result dewInit(void *object, const void *configBase)
+{
+  const struct SHT2XDewPointConfig * const config = configBase;
+  assert(config != NULL);
+  assert(config->parent != NULL);
+
+  struct SHT2XDewPoint * const sensor = object;
+
+  sensor->callbackArgument = NULL;
+  sensor->onErrorCallback = NULL;
+  sensor->onResultCallback = NULL;
+  sensor->onUpdateCallback = NULL;
+  sensor->parent = config->parent;
+
+  return E_OK;
+}
+/*----------------------------------------------------------------------------*/
+static void dewDeinit(void *)
+{
+}
+/*----------------------------------------------------------------------------*/
+static const struct SensorDescriptor *dewGetDescriptor(const void *)
+{
+  static const struct SensorDescriptor descriptor = {
+      .type = SENSOR_TYPE_INT32,
+      .count = 1,
+      .exponent = -8,
+      .unit = SENSOR_UNIT_CELSIUS
+  };
+
+  return &descriptor;
+}
+/*----------------------------------------------------------------------------*/
+static const char *dewGetFormat(const void *)
+{
+  return "i24q8";
+}
+/*----------------------------------------------------------------------------*/
+static enum SensorStatus dewGetStatus(const void *)
+{
+  return SENSOR_IDLE;
+}
+/*----------------------------------------------------------------------------*/
+static uint64_t dewGetTimestamp(const void *)
+{
+  return 0;
+}
+/*----------------------------------------------------------------------------*/
+static void dewSetCallbackArgument(void *object, void *argument)
+{
+  struct SHT2XDewPoint * const sensor = object;
+  sensor->callbackArgument = argument;
+}
+/*----------------------------------------------------------------------------*/
+static void dewSetErrorCallback(void *object,
+    void (*callback)(void *, enum SensorResult))
+{
+  struct SHT2XDewPoint * const sensor = object;
+  sensor->onErrorCallback = callback;
+}
+/*----------------------------------------------------------------------------*/
+static void dewSetResultCallback(void *object,
+    void (*callback)(void *, const void *, size_t))
+{
+  struct SHT2XDewPoint * const sensor = object;
+  sensor->onResultCallback = callback;
+}
+/*----------------------------------------------------------------------------*/
+static void dewSetUpdateCallback(void *object, void (*callback)(void *))
+{
+  struct SHT2XDewPoint * const sensor = object;
+  sensor->onUpdateCallback = callback;
+}
+/*----------------------------------------------------------------------------*/
+static void dewReset(void *)
+{
+}
+/*----------------------------------------------------------------------------*/
+static void dewSample(void *object)
+{
+  struct SHT2XDewPoint * const sensor = object;
+
+  assert(sensor->onResultCallback != NULL);
+  assert(sensor->onUpdateCallback != NULL);
+
+  atomicFetchOr(&sensor->parent->flags, FLAG_DEW_SAMPLE);
+}
+/*----------------------------------------------------------------------------*/
+static void dewStart(void *object)
+{
+  struct SHT2XDewPoint * const sensor = object;
+
+  assert(sensor->onResultCallback != NULL);
+  assert(sensor->onUpdateCallback != NULL);
+
+  atomicFetchOr(&sensor->parent->flags, FLAG_DEW_LOOP);
+}
+/*----------------------------------------------------------------------------*/
+static void dewStop(void *object)
+{
+  struct SHT2XDewPoint * const sensor = object;
+  atomicFetchAnd(&sensor->parent->flags,
+      ~(FLAG_DEW_LOOP | FLAG_DEW_SAMPLE));
+}
+/*----------------------------------------------------------------------------*/
+static bool dewUpdate(void *)
+{
+  return false;
+}
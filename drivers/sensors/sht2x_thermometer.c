@@ -11,6 +11,7 @@
 /*----------------------------------------------------------------------------*/
 static enum Result thermoInit(void *, const void *);
 static void thermoDeinit(void *);
+static const struct SensorDescriptor *thermoGetDescriptor(const void *);
 static const char *thermoGetFormat(const void *);
 static enum SensorStatus thermoGetStatus(const void *);
 static uint64_t thermoGetTimestamp(const void *);
@@ -31,6 +32,7 @@ const struct SensorClass * const SHT2XThermometer =
     .init = thermoInit,
     .deinit = thermoDeinit,
 
+    .getDescriptor = thermoGetDescriptor,
     .getFormat = thermoGetFormat,
     .getStatus = thermoGetStatus,
     .getTimestamp = thermoGetTimestamp,
@@ -66,6 +68,18 @@ static void thermoDeinit(void *)
 {
 }
 /*----------------------------------------------------------------------------*/
+static const struct SensorDescriptor *thermoGetDescriptor(const void *)
+{
+  static const struct SensorDescriptor descriptor = {
+      .type = SENSOR_TYPE_INT32,
+      .count = 1,
+      .exponent = -8,
+      .unit = SENSOR_UNIT_CELSIUS
+  };
+
+  return &descriptor;
+}
+/*----------------------------------------------------------------------------*/
 static const char *thermoGetFormat(const void *)
 {
   return "i24q8";
@@ -5,6 +5,55 @@
  */
 
 #include <dpm/sensors/thermistor_ntc.h>
+#include <xcore/accel.h>
+/*----------------------------------------------------------------------------*/
+static inline void convertDivided(size_t, const int16_t *, int32_t *,
+    const uint16_t *, size_t, size_t);
+static inline void convertShifted(const int16_t *, int32_t *restrict,
+    const uint16_t *restrict, size_t, size_t, unsigned int);
+static unsigned int getStepShift(size_t);
+/*----------------------------------------------------------------------------*/
+static inline void convertDivided(size_t size, const int16_t *table,
+    int32_t *output, const uint16_t *input, size_t count, size_t stride)
+{
+  for (size_t index = 0; index < count; index += stride)
+    output[index] = ntcRawToTemperature(size, table, input[index]);
+}
+/*----------------------------------------------------------------------------*/
+static inline void convertShifted(const int16_t *table,
+    int32_t *restrict output, const uint16_t *restrict input, size_t count,
+    size_t stride, unsigned int shift)
+{
+  const int32_t mask = (int32_t)(1UL << shift) - 1;
+  const int32_t half = (int32_t)(1UL << shift) >> 1;
+
+  /*
+   * Branchless loop body: the bias emulates truncation of the signed division
+   * in ntcRawToTemperature, results are identical to the scalar version.
+   */
+  for (size_t index = 0; index < count; index += stride)
+  {
+    const int32_t value = input[index];
+    const int32_t binIndex = value >> shift;
+
+    const int32_t currentBinOutput = table[binIndex];
+    const int32_t slope = table[binIndex + 1] - currentBinOutput;
+    const int32_t product = (value & mask) * slope - half;
+    const int32_t bias = (product >> 31) & mask;
+
+    output[index] = currentBinOutput + ((product + bias) >> shift);
+  }
+}
+/*----------------------------------------------------------------------------*/
+static unsigned int getStepShift(size_t size)
+{
+  const uint32_t step = (UINT16_MAX + 1) / (uint32_t)(size - 1);
+
+  if (step & (step - 1))
+    return UINT_MAX;
+  else
+    return 31 - countLeadingZeros32(step);
+}
 /*----------------------------------------------------------------------------*/
 size_t ntcFindBinIndex(size_t size, const int16_t table[static size],
     int32_t temperature)
@@ -29,3 +78,55 @@ size_t ntcFindBinIndex(size_t size, const int16_t table[static size],
 
   return right;
 }
+/*----------------------------------------------------------------------------*/
+/**
+ * Convert an array of raw values using a single table.
+ * @param size Table size, division is replaced with a shift when the size
+ * is a power of two plus one.
+ * @param table Pointer to the table.
+ * @param output Output buffer for temperatures, must not overlap the input.
+ * @param input Raw values.
+ * @param count Number of values.
+ */
+void ntcRawToTemperatureArray(size_t size, const int16_t table[static size],
+    int32_t *output, const uint16_t *input, size_t count)
+{
+  const unsigned int shift = getStepShift(size);
+
+  if (shift != UINT_MAX)
+    convertShifted(table, output, input, count, 1, shift);
+  else
+    convertDivided(size, table, output, input, count, 1);
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Convert interleaved samples of several channels with per-channel tables.
+ * @param size Size of each table, all tables must have the same size.
+ * @param tables Array of table pointers, one table for each channel.
+ * @param channels Number of channels.
+ * @param output Output buffer for temperatures, must not overlap the input.
+ * @param input Raw values, channel samples are interleaved.
+ * @param count Total number of values.
+ */
+void ntcRawToTemperatureChannels(size_t size, const int16_t * const *tables,
+    size_t channels, int32_t *output, const uint16_t *input, size_t count)
+{
+  const unsigned int shift = getStepShift(size);
+  const size_t limit = MIN(channels, count);
+
+  for (size_t channel = 0; channel < limit; ++channel)
+  {
+    const size_t remaining = count - channel;
+
+    if (shift != UINT_MAX)
+    {
+      convertShifted(tables[channel], output + channel, input + channel,
+          remaining, channels, shift);
+    }
+    else
+    {
+      convertDivided(size, tables[channel], output + channel, input + channel,
+          remaining, channels);
+    }
+  }
+}
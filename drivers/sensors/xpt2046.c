@@ -16,7 +16,20 @@
 #include <limits.h>
 #include <string.h>
 /*----------------------------------------------------------------------------*/
-#define ADC_MAX MASK(12)
+#define ADC_MAX         MASK(12)
+#define AFFINE_FRACTION 16
+#define FILTER_FRACTION 8
+#define FILTER_MAX      7
+
+enum
+{
+  AXIS_Z1,
+  AXIS_Z2,
+  AXIS_X,
+  AXIS_Y,
+
+  AXIS_COUNT
+};
 
 enum
 {
@@ -34,12 +47,20 @@ enum State
   STATE_PROCESS
 };
 /*----------------------------------------------------------------------------*/
+static int16_t applyAffine(const int32_t *, int32_t, int32_t);
+static uint16_t applyFilter(struct XPT2046 *, size_t, uint16_t, bool);
+static int32_t calcAffineCoefficient(int64_t, int64_t);
+static void calcPosition(void *);
+static void fillCommandBuffer(struct XPT2046 *);
 static void onBusEvent(void *);
 static void onPinEvent(void *);
 static void onTimerEvent(void *);
+static uint16_t readMedian(const struct XPT2046 *, size_t);
+static void startReading(struct XPT2046 *);
 
 static enum Result tsInit(void *, const void *);
 static void tsDeinit(void *);
+static const struct SensorDescriptor *tsGetDescriptor(const void *);
 static const char *tsGetFormat(const void *);
 static enum SensorStatus tsGetStatus(const void *);
 static uint64_t tsGetTimestamp(const void *);
@@ -60,6 +81,7 @@ const struct SensorClass * const XPT2046 = &(const struct SensorClass){
     .init = tsInit,
     .deinit = tsDeinit,
 
+    .getDescriptor = tsGetDescriptor,
     .getFormat = tsGetFormat,
     .getStatus = tsGetStatus,
     .getTimestamp = tsGetTimestamp,
@@ -75,11 +97,50 @@ const struct SensorClass * const XPT2046 = &(const struct SensorClass){
     .update = tsUpdate
 };
 /*----------------------------------------------------------------------------*/
+static int16_t applyAffine(const int32_t *row, int32_t x, int32_t y)
+{
+  const int32_t value = row[0] * x + row[1] * y + row[2];
+  return (int16_t)((value + (1L << (AFFINE_FRACTION - 1))) >> AFFINE_FRACTION);
+}
+/*----------------------------------------------------------------------------*/
+static uint16_t applyFilter(struct XPT2046 *sensor, size_t channel,
+    uint16_t value, bool reset)
+{
+  const int32_t input = (int32_t)value << FILTER_FRACTION;
+
+  if (reset)
+  {
+    /* Start from the current value after the panel has been pressed */
+    sensor->filtered[channel] = input;
+  }
+  else
+  {
+    sensor->filtered[channel] +=
+        (input - sensor->filtered[channel]) >> sensor->filter;
+  }
+
+  return (uint16_t)((sensor->filtered[channel]
+      + (1 << (FILTER_FRACTION - 1))) >> FILTER_FRACTION);
+}
+/*----------------------------------------------------------------------------*/
+static int32_t calcAffineCoefficient(int64_t numerator, int64_t denominator)
+{
+  numerator *= 1LL << AFFINE_FRACTION;
+
+  /* Round to nearest */
+  if ((numerator < 0) != (denominator < 0))
+    numerator -= denominator / 2;
+  else
+    numerator += denominator / 2;
+
+  return (int32_t)(numerator / denominator);
+}
+/*----------------------------------------------------------------------------*/
 static void calcPosition(void *object)
 {
   struct XPT2046 * const sensor = object;
-  const uint16_t z1 = (sensor->rxBuffer[1] << 8 | sensor->rxBuffer[2]) >> 3;
-  const uint16_t z2 = (sensor->rxBuffer[3] << 8 | sensor->rxBuffer[4]) >> 3;
+  const uint16_t z1 = readMedian(sensor, AXIS_Z1);
+  const uint16_t z2 = readMedian(sensor, AXIS_Z2);
   int z = (ADC_MAX - z2) + z1;
 
   if (z < 0)
@@ -89,16 +150,26 @@ static void calcPosition(void *object)
   {
     /* Touch panel pressed */
 
-    const uint16_t x = (sensor->rxBuffer[5] << 8 | sensor->rxBuffer[6]) >> 3;
-    const uint16_t y = (sensor->rxBuffer[7] << 8 | sensor->rxBuffer[8]) >> 3;
+    const bool pressed =
+        (atomicFetchOr(&sensor->flags, FLAG_PRESSED) & FLAG_PRESSED) != 0;
+    const uint16_t x = applyFilter(sensor, 0,
+        readMedian(sensor, AXIS_X), !pressed);
+    const uint16_t y = applyFilter(sensor, 1,
+        readMedian(sensor, AXIS_Y), !pressed);
     int16_t result[3];
 
-    atomicFetchOr(&sensor->flags, FLAG_PRESSED);
-
-    result[0] = (int16_t)(((x - sensor->xMin) * sensor->xRes)
-          / (sensor->xMax - sensor->xMin));
-    result[1] = (int16_t)(((y - sensor->yMin) * sensor->yRes)
-          / (sensor->yMax - sensor->yMin));
+    if (sensor->affine)
+    {
+      result[0] = applyAffine(sensor->matrix, x, y);
+      result[1] = applyAffine(sensor->matrix + 3, x, y);
+    }
+    else
+    {
+      result[0] = (int16_t)(((x - sensor->xMin) * sensor->xRes)
+            / (sensor->xMax - sensor->xMin));
+      result[1] = (int16_t)(((y - sensor->yMin) * sensor->yRes)
+            / (sensor->yMax - sensor->yMin));
+    }
     result[2] = (int16_t)z;
 
     sensor->onResultCallback(sensor->callbackArgument, &result, sizeof(result));
@@ -110,6 +181,36 @@ static void calcPosition(void *object)
   }
 }
 /*----------------------------------------------------------------------------*/
+static void fillCommandBuffer(struct XPT2046 *sensor)
+{
+  static const uint8_t commands[AXIS_COUNT] = {
+      [AXIS_Z1] = CTRL_Z1_POS,
+      [AXIS_Z2] = CTRL_Z2_POS,
+      [AXIS_X] = CTRL_HI_X,
+      [AXIS_Y] = CTRL_HI_Y
+  };
+  size_t position = 0;
+
+  /*
+   * Conversions are issued back to back: each command is sent during
+   * the second byte of the previous result. The last command powers down
+   * the converter and enables the pen interrupt.
+   */
+  memset(sensor->txBuffer, 0, sizeof(sensor->txBuffer));
+
+  for (size_t axis = 0; axis < AXIS_COUNT; ++axis)
+  {
+    for (size_t index = 0; index < sensor->samples; ++index)
+    {
+      sensor->txBuffer[position] = commands[axis] | CTRL_ADC_ON;
+      position += 2;
+    }
+  }
+
+  sensor->txBuffer[position] = CTRL_HI_Y | CTRL_SER;
+  sensor->length = (uint8_t)(position + 3);
+}
+/*----------------------------------------------------------------------------*/
 static void onBusEvent(void *object)
 {
   struct XPT2046 * const sensor = object;
@@ -140,12 +241,34 @@ static void onTimerEvent(void *object)
   sensor->onUpdateCallback(sensor->callbackArgument);
 }
 /*----------------------------------------------------------------------------*/
+static uint16_t readMedian(const struct XPT2046 *sensor, size_t axis)
+{
+  const uint8_t *buffer = sensor->rxBuffer + axis * sensor->samples * 2 + 1;
+  uint16_t values[XPT2046_MAX_SAMPLES];
+
+  /* Insertion sort is sufficient for a small number of samples */
+  for (size_t index = 0; index < sensor->samples; ++index)
+  {
+    const uint16_t value = (buffer[0] << 8 | buffer[1]) >> 3;
+    size_t position = index;
+
+    while (position > 0 && values[position - 1] > value)
+    {
+      values[position] = values[position - 1];
+      --position;
+    }
+
+    values[position] = value;
+    buffer += 2;
+  }
+
+  return values[sensor->samples >> 1];
+}
+/*----------------------------------------------------------------------------*/
 static void startReading(struct XPT2046 *sensor)
 {
   static_assert(sizeof(sensor->rxBuffer) == sizeof(sensor->txBuffer),
       "Incorrect buffer configuration");
-  static_assert(sizeof(sensor->txBuffer) == 11,
-      "Incorrect buffer configuartion");
 
   /* Lock the interface */
   ifSetParam(sensor->bus, IF_ACQUIRE, NULL);
@@ -160,8 +283,8 @@ static void startReading(struct XPT2046 *sensor)
 
   pinReset(sensor->cs);
 
-  ifRead(sensor->bus, sensor->rxBuffer, sizeof(sensor->rxBuffer));
-  ifWrite(sensor->bus, sensor->txBuffer, sizeof(sensor->txBuffer));
+  ifRead(sensor->bus, sensor->rxBuffer, sensor->length);
+  ifWrite(sensor->bus, sensor->txBuffer, sensor->length);
 }
 /*----------------------------------------------------------------------------*/
 static enum Result tsInit(void *object, const void *configBase)
@@ -177,6 +300,14 @@ static enum Result tsInit(void *object, const void *configBase)
 
   struct XPT2046 * const sensor = object;
 
+  if (config->samples > XPT2046_MAX_SAMPLES)
+    return E_VALUE;
+  /* Median is defined only for an odd number of samples */
+  if (config->samples && !(config->samples & 1))
+    return E_VALUE;
+  if (config->filter > FILTER_MAX)
+    return E_VALUE;
+
   sensor->cs = pinInit(config->cs);
   if (!pinValid(sensor->cs))
     return E_VALUE;
@@ -193,6 +324,8 @@ static enum Result tsInit(void *object, const void *configBase)
   sensor->onUpdateCallback = NULL;
 
   sensor->flags = 0;
+  sensor->filter = config->filter;
+  sensor->samples = config->samples ? config->samples : 1;
   sensor->state = STATE_IDLE;
 
   sensor->threshold = config->threshold;
@@ -202,18 +335,15 @@ static enum Result tsInit(void *object, const void *configBase)
   sensor->yRes = config->y;
   sensor->yMax = sensor->yRes;
   sensor->yMin = 0;
+  sensor->affine = false;
 
   /* Initialize command buffer with conversion commands for all axes */
-  memset(sensor->txBuffer, 0, sizeof(sensor->txBuffer));
-  sensor->txBuffer[0] = CTRL_Z1_POS | CTRL_ADC_ON;
-  sensor->txBuffer[2] = CTRL_Z2_POS | CTRL_ADC_ON;
-  sensor->txBuffer[4] = CTRL_HI_X | CTRL_ADC_ON;
-  sensor->txBuffer[6] = CTRL_HI_Y | CTRL_ADC_ON;
-  sensor->txBuffer[8] = CTRL_HI_Y | CTRL_SER;
+  fillCommandBuffer(sensor);
 
+  const uint32_t frequency = config->frequency ?
+      config->frequency : dataUpdateFreq;
   const uint32_t overflow =
-      (timerGetFrequency(sensor->timer) + (dataUpdateFreq - 1))
-          / dataUpdateFreq;
+      (timerGetFrequency(sensor->timer) + (frequency - 1)) / frequency;
 
   interruptSetCallback(sensor->event, onPinEvent, sensor);
   timerSetAutostop(sensor->timer, true);
@@ -234,6 +364,18 @@ static void tsDeinit(void *object)
   interruptSetCallback(sensor->event, NULL, NULL);
 }
 /*----------------------------------------------------------------------------*/
+static const struct SensorDescriptor *tsGetDescriptor(const void *)
+{
+  static const struct SensorDescriptor descriptor = {
+      .type = SENSOR_TYPE_INT16,
+      .count = 3,
+      .exponent = 0,
+      .unit = SENSOR_UNIT_NONE
+  };
+
+  return &descriptor;
+}
+/*----------------------------------------------------------------------------*/
 static const char *tsGetFormat(const void *)
 {
   return "i16i16i16";
@@ -403,17 +545,65 @@ static bool tsUpdate(void *object)
   return busy;
 }
 /*----------------------------------------------------------------------------*/
+/**
+ * Reset calibration to the min/max model without scaling, the sensor
+ * reports raw coordinates afterwards.
+ * @param sensor Pointer to an XPT2046 object.
+ */
 void xpt2046ResetCalibration(struct XPT2046 *sensor)
 {
+  sensor->affine = false;
   sensor->xMax = sensor->xRes;
   sensor->xMin = 0;
   sensor->yMax = sensor->yRes;
   sensor->yMin = 0;
 }
 /*----------------------------------------------------------------------------*/
+/**
+ * Calculate and enable an affine calibration that corrects offset, scale,
+ * rotation and skew of the panel.
+ * @param sensor Pointer to an XPT2046 object.
+ * @param raw Raw coordinates of three touch points reported after
+ * the calibration reset.
+ * @param screen Screen coordinates of the same points.
+ * @return @b true on success or @b false when the points are collinear.
+ */
+bool xpt2046SetAffineCalibration(struct XPT2046 *sensor,
+    const struct XPT2046Point raw[static 3],
+    const struct XPT2046Point screen[static 3])
+{
+  const int64_t dx0 = raw[0].x - raw[2].x;
+  const int64_t dx1 = raw[1].x - raw[2].x;
+  const int64_t dy0 = raw[0].y - raw[2].y;
+  const int64_t dy1 = raw[1].y - raw[2].y;
+  const int64_t det = dx0 * dy1 - dx1 * dy0;
+
+  if (det == 0)
+    return false;
+
+  for (size_t axis = 0; axis < 2; ++axis)
+  {
+    int32_t * const row = sensor->matrix + axis * 3;
+    const int64_t s0 = axis ? screen[0].y : screen[0].x;
+    const int64_t s1 = axis ? screen[1].y : screen[1].x;
+    const int64_t s2 = axis ? screen[2].y : screen[2].x;
+    const int64_t ds0 = s0 - s2;
+    const int64_t ds1 = s1 - s2;
+
+    row[0] = calcAffineCoefficient(ds0 * dy1 - ds1 * dy0, det);
+    row[1] = calcAffineCoefficient(dx0 * ds1 - dx1 * ds0, det);
+    row[2] = (int32_t)(s2 * (1LL << AFFINE_FRACTION)
+        - (int64_t)row[0] * raw[2].x - (int64_t)row[1] * raw[2].y);
+  }
+
+  sensor->affine = true;
+  return true;
+}
+/*----------------------------------------------------------------------------*/
 void xpt2046SetCalibration(struct XPT2046 *sensor,
     uint16_t ax, uint16_t ay, uint16_t bx, uint16_t by)
 {
+  sensor->affine = false;
   sensor->xMax = bx;
   sensor->xMin = ax;
   sensor->yMax = by;
@@ -0,0 +1,349 @@
+/*
+ * timer_wheel.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#include <dpm/timer_wheel.h>
+#include <halm/irq.h>
+#include <assert.h>
+#include <stdlib.h>
+/*----------------------------------------------------------------------------*/
+#define DEFAULT_SIZE 32
+/*----------------------------------------------------------------------------*/
+static uint32_t getElapsedTicks(const struct VirtualTimer *);
+static void insertTimer(struct VirtualTimer *);
+static void interruptHandler(void *);
+static void removeTimer(struct VirtualTimer *);
+/*----------------------------------------------------------------------------*/
+static enum Result wheelInit(void *, const void *);
+static void wheelDeinit(void *);
+
+static enum Result vtInit(void *, const void *);
+static void vtDeinit(void *);
+static void vtEnable(void *);
+static void vtDisable(void *);
+static void vtSetAutostop(void *, bool);
+static void vtSetCallback(void *, void (*)(void *), void *);
+static uint32_t vtGetFrequency(const void *);
+static uint32_t vtGetOverflow(const void *);
+static void vtSetOverflow(void *, uint32_t);
+static uint32_t vtGetValue(const void *);
+static void vtSetValue(void *, uint32_t);
+/*----------------------------------------------------------------------------*/
+const struct EntityClass * const TimerWheel = &(const struct EntityClass){
+    .size = sizeof(struct TimerWheel),
+    .init = wheelInit,
+    .deinit = wheelDeinit
+};
+
+const struct TimerClass * const VirtualTimer = &(const struct TimerClass){
+    .size = sizeof(struct VirtualTimer),
+    .init = vtInit,
+    .deinit = vtDeinit,
+
+    .enable = vtEnable,
+    .disable = vtDisable,
+    .setAutostop = vtSetAutostop,
+    .setCallback = vtSetCallback,
+    .getFrequency = vtGetFrequency,
+    .setFrequency = NULL,
+    .getOverflow = vtGetOverflow,
+    .setOverflow = vtSetOverflow,
+    .getValue = vtGetValue,
+    .setValue = vtSetValue
+};
+/*----------------------------------------------------------------------------*/
+static uint32_t getElapsedTicks(const struct VirtualTimer *timer)
+{
+  if (timer->enabled)
+  {
+    /* Deadline includes one extra tick for the partially elapsed tick */
+    const uint32_t remaining = timer->deadline - timer->wheel->ticks;
+    return remaining <= timer->overflow ? timer->overflow + 1 - remaining : 0;
+  }
+  else
+    return timer->value;
+}
+/*----------------------------------------------------------------------------*/
+static void insertTimer(struct VirtualTimer *timer)
+{
+  struct TimerWheel * const wheel = timer->wheel;
+  struct VirtualTimer ** const slot =
+      &wheel->slots[timer->deadline & wheel->mask];
+
+  timer->previous = NULL;
+  timer->next = *slot;
+  if (timer->next != NULL)
+    timer->next->previous = timer;
+  *slot = timer;
+}
+/*----------------------------------------------------------------------------*/
+static void interruptHandler(void *object)
+{
+  struct TimerWheel * const wheel = object;
+  IrqState state = irqSave();
+  const uint32_t ticks = ++wheel->ticks;
+  struct VirtualTimer *current = wheel->slots[ticks & wheel->mask];
+
+  /*
+   * Only timers with the current deadline expire, others in the same slot
+   * are waiting for one of the next revolutions of the wheel.
+   */
+  while (current != NULL)
+  {
+    if (current->deadline != ticks)
+    {
+      current = current->next;
+      continue;
+    }
+
+    removeTimer(current);
+
+    if (current->autostop)
+    {
+      current->enabled = false;
+      current->value = 0;
+
+      if (!--wheel->active)
+        timerDisable(wheel->timer);
+    }
+    else
+    {
+      current->deadline = ticks + current->overflow;
+      insertTimer(current);
+    }
+
+    void (*callback)(void *) = current->callback;
+    void * const argument = current->callbackArgument;
+
+    irqRestore(state);
+    if (callback != NULL)
+      callback(argument);
+    state = irqSave();
+
+    /* Callbacks may change the list, restart from the head of the slot */
+    current = wheel->slots[ticks & wheel->mask];
+  }
+
+  irqRestore(state);
+}
+/*----------------------------------------------------------------------------*/
+static void removeTimer(struct VirtualTimer *timer)
+{
+  struct TimerWheel * const wheel = timer->wheel;
+
+  if (timer->previous != NULL)
+    timer->previous->next = timer->next;
+  else
+    wheel->slots[timer->deadline & wheel->mask] = timer->next;
+
+  if (timer->next != NULL)
+    timer->next->previous = timer->previous;
+}
+/*----------------------------------------------------------------------------*/
+static enum Result wheelInit(void *object, const void *configBase)
+{
+  const struct TimerWheelConfig * const config = configBase;
+  assert(config != NULL);
+  assert(config->timer != NULL);
+  assert(config->frequency > 0);
+
+  struct TimerWheel * const wheel = object;
+  const size_t size = config->size ? config->size : DEFAULT_SIZE;
+
+  if (size & (size - 1))
+    return E_VALUE;
+
+  const uint32_t frequency = timerGetFrequency(config->timer);
+
+  /* Tick period should be an integer number of hardware timer ticks */
+  if (config->frequency > frequency || frequency % config->frequency)
+    return E_VALUE;
+
+  wheel->slots = malloc(size * sizeof(struct VirtualTimer *));
+  if (wheel->slots == NULL)
+    return E_MEMORY;
+
+  for (size_t index = 0; index < size; ++index)
+    wheel->slots[index] = NULL;
+
+  wheel->timer = config->timer;
+  wheel->frequency = config->frequency;
+  wheel->mask = (uint32_t)(size - 1);
+  wheel->ticks = 0;
+  wheel->active = 0;
+
+  timerSetAutostop(wheel->timer, false);
+  timerSetCallback(wheel->timer, interruptHandler, wheel);
+  timerSetOverflow(wheel->timer, frequency / config->frequency);
+
+  return E_OK;
+}
+/*----------------------------------------------------------------------------*/
+static void wheelDeinit(void *object)
+{
+  struct TimerWheel * const wheel = object;
+  assert(wheel->active == 0);
+
+  timerDisable(wheel->timer);
+  timerSetCallback(wheel->timer, NULL, NULL);
+  free(wheel->slots);
+}
+/*----------------------------------------------------------------------------*/
+static enum Result vtInit(void *object, const void *configBase)
+{
+  const struct VirtualTimerConfig * const config = configBase;
+  assert(config != NULL);
+  assert(config->parent != NULL);
+
+  struct VirtualTimer * const timer = object;
+
+  timer->callback = NULL;
+  timer->callbackArgument = NULL;
+  timer->wheel = config->parent;
+  timer->next = NULL;
+  timer->previous = NULL;
+  timer->deadline = 0;
+  timer->overflow = 1;
+  timer->value = 0;
+  timer->autostop = false;
+  timer->enabled = false;
+
+  return E_OK;
+}
+/*----------------------------------------------------------------------------*/
+static void vtDeinit(void *object)
+{
+  vtDisable(object);
+}
+/*----------------------------------------------------------------------------*/
+static void vtEnable(void *object)
+{
+  struct VirtualTimer * const timer = object;
+  struct TimerWheel * const wheel = timer->wheel;
+  const IrqState state = irqSave();
+
+  if (!timer->enabled)
+  {
+    const uint32_t remaining = timer->value < timer->overflow ?
+        timer->overflow - timer->value : 1;
+
+    /* Current tick is partially elapsed, round the delay up */
+    timer->deadline = wheel->ticks + remaining + 1;
+    timer->enabled = true;
+    insertTimer(timer);
+
+    if (!wheel->active++)
+    {
+      timerSetValue(wheel->timer, 0);
+      timerEnable(wheel->timer);
+    }
+  }
+
+  irqRestore(state);
+}
+/*----------------------------------------------------------------------------*/
+static void vtDisable(void *object)
+{
+  struct VirtualTimer * const timer = object;
+  struct TimerWheel * const wheel = timer->wheel;
+  const IrqState state = irqSave();
+
+  if (timer->enabled)
+  {
+    timer->value = getElapsedTicks(timer);
+    timer->enabled = false;
+    removeTimer(timer);
+
+    if (!--wheel->active)
+      timerDisable(wheel->timer);
+  }
+
+  irqRestore(state);
+}
+/*----------------------------------------------------------------------------*/
+static void vtSetAutostop(void *object, bool state)
+{
+  struct VirtualTimer * const timer = object;
+  timer->autostop = state;
+}
+/*----------------------------------------------------------------------------*/
+static void vtSetCallback(void *object, void (*callback)(void *),
+    void *argument)
+{
+  struct VirtualTimer * const timer = object;
+  const IrqState state = irqSave();
+
+  timer->callbackArgument = argument;
+  timer->callback = callback;
+
+  irqRestore(state);
+}
+/*----------------------------------------------------------------------------*/
+static uint32_t vtGetFrequency(const void *object)
+{
+  const struct VirtualTimer * const timer = object;
+  return timer->wheel->frequency;
+}
+/*----------------------------------------------------------------------------*/
+static uint32_t vtGetOverflow(const void *object)
+{
+  const struct VirtualTimer * const timer = object;
+  return timer->overflow;
+}
+/*----------------------------------------------------------------------------*/
+static void vtSetOverflow(void *object, uint32_t overflow)
+{
+  struct VirtualTimer * const timer = object;
+  const bool enabled = timer->enabled;
+
+  if (enabled)
+    vtDisable(timer);
+  timer->overflow = overflow ? overflow : 1;
+  if (enabled)
+    vtEnable(timer);
+}
+/*----------------------------------------------------------------------------*/
+static uint32_t vtGetValue(const void *object)
+{
+  const struct VirtualTimer * const timer = object;
+  const IrqState state = irqSave();
+  const uint32_t value = getElapsedTicks(timer);
+
+  irqRestore(state);
+  return value;
+}
+/*----------------------------------------------------------------------------*/
+static void vtSetValue(void *object, uint32_t value)
+{
+  struct VirtualTimer * const timer = object;
+  const bool enabled = timer->enabled;
+
+  if (enabled)
+    vtDisable(timer);
+  timer->value = value;
+  if (enabled)
+    vtEnable(timer);
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Create a virtual timer.
+ *
+ * Virtual timers share a single hardware timer of the wheel and may be used
+ * in place of hardware timers in driver configurations. Timer resolution
+ * is one tick of the wheel, delays are rounded up to the whole number
+ * of ticks.
+ *
+ * @param wheel Pointer to a TimerWheel object. Must not be NULL.
+ * @return Pointer to a newly created VirtualTimer object on success.
+ * Returns NULL if the operation fails.
+ */
+void *timerWheelCreate(void *wheel)
+{
+  const struct VirtualTimerConfig timerConfig = {
+      .parent = wheel
+  };
+
+  return init(VirtualTimer, &timerConfig);
+}
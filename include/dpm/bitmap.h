@@ -0,0 +1,52 @@
+/*
+ * bitmap.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#ifndef DPM_BITMAP_H_
+#define DPM_BITMAP_H_
+/*----------------------------------------------------------------------------*/
+#include <xcore/helpers.h>
+#include <stddef.h>
+#include <stdint.h>
+/*----------------------------------------------------------------------------*/
+#define BITMAP_WORD_WIDTH   32
+#define BITMAP_MAX_WORDS    32
+#define BITMAP_MAX_SIZE     (BITMAP_MAX_WORDS * BITMAP_WORD_WIDTH)
+#define BITMAP_NONE         SIZE_MAX
+
+#define BITMAP_WORDS(size) \
+    (((size) + BITMAP_WORD_WIDTH - 1) / BITMAP_WORD_WIDTH)
+/*----------------------------------------------------------------------------*/
+/*
+ * Two-level bitmap. Each bit of the summary word marks a non-empty word
+ * of the second level. The summary may temporarily contain bits for empty
+ * words, such bits are removed during the search.
+ */
+struct Bitmap
+{
+  uint32_t *words;
+  uint32_t summary;
+};
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+void bitmapInit(struct Bitmap *, uint32_t *, size_t, bool);
+bool bitmapClear(struct Bitmap *, size_t);
+size_t bitmapFindLast(struct Bitmap *);
+bool bitmapSet(struct Bitmap *, size_t);
+bool bitmapTest(const struct Bitmap *, size_t);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+static inline bool bitmapEmpty(const struct Bitmap *bitmap)
+{
+  return bitmap->summary == 0;
+}
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* DPM_BITMAP_H_ */
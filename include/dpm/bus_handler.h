@@ -7,23 +7,58 @@
 #ifndef DPM_BUS_HANDLER_H_
 #define DPM_BUS_HANDLER_H_
 /*----------------------------------------------------------------------------*/
-#include <xcore/helpers.h>
+#include <dpm/bitmap.h>
 #include <stddef.h>
 #include <stdint.h>
 /*----------------------------------------------------------------------------*/
+/* Storage for a bus handler with a fixed number of devices */
+#define BH_STORAGE(capacity) \
+    struct \
+    { \
+      struct BHEntry devices[capacity]; \
+      uint32_t words[BITMAP_WORDS(capacity) * 3]; \
+    }
+
+#define bhInitStorage(handler, storage, wq) \
+    bhInitStatic((handler), (storage)->devices, (storage)->words, \
+        ARRAY_SIZE((storage)->devices), (wq))
+/*----------------------------------------------------------------------------*/
 typedef void (*BHCallback)(void *, void *);
 typedef bool (*BHDeviceCallback)(void *);
 typedef void (*BHDeviceCallbackSetter)(void *, void (*)(void *), void *);
 
+struct Timer64;
+
+struct BHStatistics
+{
+  /* Total time spent waiting for the bus */
+  uint64_t waitTime;
+  /* Longest time spent waiting for the bus */
+  uint64_t waitTimeMax;
+  /* Total time the bus was occupied by the device */
+  uint64_t busyTime;
+  /* Number of completed update cycles */
+  uint32_t cycles;
+  /* Number of errors reported by the device */
+  uint32_t errors;
+};
+
 struct BHEntry
 {
   void *handler;
   void *device;
-  uint32_t mask;
   BHDeviceCallbackSetter errorCallbackSetter;
   BHDeviceCallbackSetter idleCallbackSetter;
   BHDeviceCallbackSetter updateCallbackSetter;
   BHDeviceCallback updateCallback;
+
+#ifdef CONFIG_BUS_HANDLER_STATS
+  struct BHStatistics stats;
+  /* Time of the first pending update request */
+  uint64_t requested;
+  /* Time when the device occupied the bus */
+  uint64_t started;
+#endif
 };
 
 struct BusHandler
@@ -32,21 +67,30 @@ struct BusHandler
   struct BHEntry *devices;
   void *wq;
 
+#ifdef CONFIG_BUS_HANDLER_STATS
+  /* Chrono timer for statistics */
+  struct Timer64 *chrono;
+#endif
+
   BHCallback errorCallback;
   void *errorCallbackArgument;
   BHCallback idleCallback;
   void *idleCallbackArgument;
 
+  struct Bitmap pool;
+  struct Bitmap detaching;
+  struct Bitmap updating;
+
   size_t capacity;
-  uint32_t pool;
-  uint32_t detaching;
-  uint32_t updating;
+  bool allocated;
   bool busy;
 };
 /*----------------------------------------------------------------------------*/
 BEGIN_DECLS
 
 bool bhInit(struct BusHandler *, size_t, void *);
+void bhInitStatic(struct BusHandler *, struct BHEntry *, uint32_t *, size_t,
+    void *);
 void bhDeinit(struct BusHandler *);
 bool bhAttach(struct BusHandler *, void *, BHDeviceCallbackSetter,
     BHDeviceCallbackSetter, BHDeviceCallbackSetter, BHDeviceCallback);
@@ -54,6 +98,13 @@ void bhDetach(struct BusHandler *, void *);
 void bhSetErrorCallback(struct BusHandler *, BHCallback, void *);
 void bhSetIdleCallback(struct BusHandler *, BHCallback, void *);
 
+#ifdef CONFIG_BUS_HANDLER_STATS
+bool bhGetStatistics(const struct BusHandler *, const void *,
+    struct BHStatistics *);
+void bhResetStatistics(struct BusHandler *);
+void bhSetChrono(struct BusHandler *, struct Timer64 *);
+#endif
+
 END_DECLS
 /*----------------------------------------------------------------------------*/
 #endif /* DPM_BUS_HANDLER_H_ */
@@ -0,0 +1,110 @@
+/*
+ * bus_scheduler.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#ifndef DPM_BUS_SCHEDULER_H_
+#define DPM_BUS_SCHEDULER_H_
+/*----------------------------------------------------------------------------*/
+#include <dpm/bus_handler.h>
+/*----------------------------------------------------------------------------*/
+#define BS_MAX_BUSES 32
+
+/* Storage for a bus scheduler with a fixed number of buses and devices */
+#define BS_STORAGE(count, capacity) \
+    struct \
+    { \
+      struct BSBus buses[count]; \
+      struct BSEntry devices[capacity]; \
+      uint32_t words[BITMAP_WORDS(capacity) * ((count) + 3)]; \
+    }
+
+#define bsInitStorage(scheduler, storage, interfaces, wq) \
+    bsInitStatic((scheduler), (storage)->buses, (storage)->devices, \
+        (storage)->words, (interfaces), ARRAY_SIZE((storage)->buses), \
+        ARRAY_SIZE((storage)->devices), (wq))
+/*----------------------------------------------------------------------------*/
+typedef void (*BSDeviceBusSetter)(void *, void *);
+
+struct BSStatistics
+{
+  /* Total time the bus was occupied by devices */
+  uint64_t busyTime;
+  /* Number of completed update cycles */
+  uint32_t cycles;
+};
+
+struct BSEntry
+{
+  void *scheduler;
+  void *device;
+  /* Bus currently occupied by the device */
+  struct BSBus *bus;
+  /* Bit mask of buses reachable by the device */
+  uint32_t reachable;
+
+  BSDeviceBusSetter busSetter;
+  BHDeviceCallbackSetter errorCallbackSetter;
+  BHDeviceCallbackSetter idleCallbackSetter;
+  BHDeviceCallbackSetter updateCallbackSetter;
+  BHDeviceCallback updateCallback;
+};
+
+struct BSBus
+{
+  struct BSEntry *current;
+  /* Bus object passed to devices */
+  void *interface;
+  /* Devices waiting for this bus */
+  struct Bitmap pending;
+
+  struct BSStatistics stats;
+  /* Time when the current device occupied the bus */
+  uint64_t started;
+};
+
+struct BusScheduler
+{
+  struct BSBus *buses;
+  struct BSEntry *devices;
+  void *wq;
+
+  /* Chrono timer for statistics */
+  struct Timer64 *chrono;
+
+  BHCallback errorCallback;
+  void *errorCallbackArgument;
+  BHCallback idleCallback;
+  void *idleCallbackArgument;
+
+  struct Bitmap pool;
+  struct Bitmap detaching;
+  struct Bitmap updating;
+
+  size_t capacity;
+  size_t count;
+  bool allocated;
+  bool pending;
+};
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+bool bsInit(struct BusScheduler *, void * const *, size_t, size_t, void *);
+void bsInitStatic(struct BusScheduler *, struct BSBus *, struct BSEntry *,
+    uint32_t *, void * const *, size_t, size_t, void *);
+void bsDeinit(struct BusScheduler *);
+bool bsAttach(struct BusScheduler *, void *, uint32_t, BSDeviceBusSetter,
+    BHDeviceCallbackSetter, BHDeviceCallbackSetter, BHDeviceCallbackSetter,
+    BHDeviceCallback);
+void bsDetach(struct BusScheduler *, void *);
+bool bsGetStatistics(const struct BusScheduler *, size_t,
+    struct BSStatistics *);
+void bsResetStatistics(struct BusScheduler *);
+void bsSetChrono(struct BusScheduler *, struct Timer64 *);
+void bsSetErrorCallback(struct BusScheduler *, BHCallback, void *);
+void bsSetIdleCallback(struct BusScheduler *, BHCallback, void *);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* DPM_BUS_SCHEDULER_H_ */
@@ -37,7 +37,14 @@ enum [[gnu::packed]] DisplayParameter
    * First and last addresses of the current display window.
    * Parameter type is \p struct \p DisplayWindow.
    */
-  IF_DISPLAY_WINDOW
+  IF_DISPLAY_WINDOW,
+  /**
+   * Repeat the first pixel of the buffer during the next write, length
+   * of the write sets the total number of bytes. Available when the
+   * underlying bus supports writes with a fixed source address.
+   * Data pointer should be set to zero.
+   */
+  IF_DISPLAY_REPEAT
 };
 /*----------------------------------------------------------------------------*/
 struct DisplayPoint
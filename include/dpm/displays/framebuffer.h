@@ -0,0 +1,84 @@
+/*
+ * displays/framebuffer.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#ifndef DPM_DISPLAYS_FRAMEBUFFER_H_
+#define DPM_DISPLAYS_FRAMEBUFFER_H_
+/*----------------------------------------------------------------------------*/
+#include <dpm/displays/display.h>
+#include <stdbool.h>
+#include <stddef.h>
+/*----------------------------------------------------------------------------*/
+struct WorkQueue;
+
+struct FramebufferConfig
+{
+  /** Mandatory: display interface with 16-bit pixels. */
+  void *display;
+  /** Optional: work queue for flush tasks. */
+  struct WorkQueue *wq;
+  /** Mandatory: maximum number of dirty regions. */
+  size_t capacity;
+};
+
+struct Framebuffer
+{
+  void (*callback)(void *);
+  void *callbackArgument;
+
+  /* Display interface */
+  struct Interface *display;
+  /* Work queue for flush tasks */
+  struct WorkQueue *wq;
+
+  /* Pixels in the byte order of the display interface */
+  uint16_t *pixels;
+  /* Dirty regions collected since the last flush */
+  struct DisplayWindow *pending;
+  /* Regions being written to the display */
+  struct DisplayWindow *active;
+
+  /* Maximum number of regions in each list */
+  size_t capacity;
+  /* Number of pending regions */
+  size_t count;
+  /* Number of active regions */
+  size_t total;
+  /* Index of the active region being written */
+  size_t index;
+
+  /* Display resolution */
+  uint16_t width;
+  uint16_t height;
+  /* Next row of the active region */
+  uint16_t row;
+  /* Flush is in progress */
+  bool busy;
+};
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+bool fbInit(struct Framebuffer *, const struct FramebufferConfig *);
+void fbDeinit(struct Framebuffer *);
+void fbFill(struct Framebuffer *, const struct DisplayWindow *, uint16_t);
+bool fbFlush(struct Framebuffer *);
+void fbInvalidate(struct Framebuffer *, const struct DisplayWindow *);
+void fbSetCallback(struct Framebuffer *, void (*)(void *), void *);
+void fbSetPixel(struct Framebuffer *, uint16_t, uint16_t, uint16_t);
+void fbWrite(struct Framebuffer *, const struct DisplayWindow *,
+    const uint16_t *);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+static inline bool fbIsBusy(const struct Framebuffer *framebuffer)
+{
+  return framebuffer->busy;
+}
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* DPM_DISPLAYS_FRAMEBUFFER_H_ */
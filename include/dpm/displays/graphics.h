@@ -0,0 +1,111 @@
+/*
+ * displays/graphics.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#ifndef DPM_DISPLAYS_GRAPHICS_H_
+#define DPM_DISPLAYS_GRAPHICS_H_
+/*----------------------------------------------------------------------------*/
+#include <dpm/displays/display.h>
+#include <stdbool.h>
+#include <stddef.h>
+/*----------------------------------------------------------------------------*/
+#define GFX_PATTERN_LENGTH 64
+/*----------------------------------------------------------------------------*/
+struct GfxGlyph
+{
+  /* Offset of the glyph bitmap in the font data */
+  uint16_t offset;
+  /* Glyph width in pixels */
+  uint8_t width;
+  /* Horizontal distance to the next glyph */
+  uint8_t advance;
+};
+
+struct GfxFont
+{
+  /* Glyph descriptors */
+  const struct GfxGlyph *glyphs;
+  /*
+   * Glyph bitmaps with 4-bit coverage values, two pixels per byte with
+   * the left pixel in the high nibble, rows are aligned to a byte.
+   */
+  const uint8_t *bitmaps;
+  /* Code of the first glyph */
+  uint8_t first;
+  /* Number of glyphs */
+  uint8_t count;
+  /* Height of all glyphs */
+  uint8_t height;
+  /* Maximum glyph width */
+  uint8_t width;
+};
+
+struct GraphicsConfig
+{
+  /**
+   * Mandatory: display interface with 16-bit pixels. Interface is switched
+   * to blocking mode and should not be switched to zero-copy mode while
+   * it is used by the graphics library.
+   */
+  void *display;
+  /** Optional: font for text output. */
+  const struct GfxFont *font;
+  /** Optional: number of entries in the glyph cache. */
+  size_t cache;
+};
+
+struct GfxCacheEntry
+{
+  /* Pre-rendered glyph in the byte order of the display interface */
+  uint16_t *pixels;
+  /* Time of the last use */
+  uint32_t time;
+  /* Text and background colors of the glyph */
+  uint16_t color;
+  uint16_t background;
+  /* Character code */
+  uint8_t code;
+  /* Entry contains a glyph */
+  bool valid;
+};
+
+struct Graphics
+{
+  /* Display interface */
+  struct Interface *display;
+  /* Font for text output */
+  const struct GfxFont *font;
+
+  /* Glyph cache */
+  struct GfxCacheEntry *entries;
+  size_t capacity;
+  /* Counter for least recently used replacement */
+  uint32_t time;
+
+  /* Display resolution */
+  uint16_t width;
+  uint16_t height;
+
+  /* Buffer for repeated patterns and converted pixels */
+  uint16_t pattern[GFX_PATTERN_LENGTH];
+};
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+bool gfxInit(struct Graphics *, const struct GraphicsConfig *);
+void gfxDeinit(struct Graphics *);
+bool gfxBlit(struct Graphics *, int16_t, int16_t, uint16_t, uint16_t,
+    const uint16_t *);
+bool gfxDrawHLine(struct Graphics *, int16_t, int16_t, uint16_t, uint16_t);
+bool gfxDrawText(struct Graphics *, int16_t, int16_t, const char *, uint16_t,
+    uint16_t);
+bool gfxDrawVLine(struct Graphics *, int16_t, int16_t, uint16_t, uint16_t);
+bool gfxFill(struct Graphics *, int16_t, int16_t, uint16_t, uint16_t,
+    uint16_t);
+uint16_t gfxGetTextWidth(const struct Graphics *, const char *);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* DPM_DISPLAYS_GRAPHICS_H_ */
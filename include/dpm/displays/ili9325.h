@@ -47,6 +47,8 @@ struct ILI9325
   uint8_t orientation;
   /* Enable blocking mode */
   bool blocking;
+  /* Repeat the first pixel during the next write */
+  bool repeat;
 };
 /*----------------------------------------------------------------------------*/
 #endif /* DPM_DISPLAYS_ILI9325_H_ */
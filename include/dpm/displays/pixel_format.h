@@ -0,0 +1,25 @@
+/*
+ * displays/pixel_format.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#ifndef DPM_DISPLAYS_PIXEL_FORMAT_H_
+#define DPM_DISPLAYS_PIXEL_FORMAT_H_
+/*----------------------------------------------------------------------------*/
+#include <xcore/helpers.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+void pfArgb8888ToRgb565(uint16_t *, const uint32_t *, size_t, uint16_t, bool);
+void pfRgb888ToRgb565(uint16_t *, const uint8_t *, size_t, bool);
+void pfRgb888ToRgb565Dither(uint16_t *, const uint8_t *, size_t, uint16_t,
+    uint16_t, bool);
+void pfSwapBytes(uint16_t *, const uint16_t *, size_t);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* DPM_DISPLAYS_PIXEL_FORMAT_H_ */
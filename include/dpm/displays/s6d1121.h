@@ -47,6 +47,8 @@ struct S6D1121
   uint8_t orientation;
   /* Enable blocking mode */
   bool blocking;
+  /* Repeat the first pixel during the next write */
+  bool repeat;
 };
 /*----------------------------------------------------------------------------*/
 #endif /* DPM_DISPLAYS_S6D1121_H_ */
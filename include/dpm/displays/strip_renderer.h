@@ -0,0 +1,109 @@
+/*
+ * displays/strip_renderer.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#ifndef DPM_DISPLAYS_STRIP_RENDERER_H_
+#define DPM_DISPLAYS_STRIP_RENDERER_H_
+/*----------------------------------------------------------------------------*/
+#include <dpm/displays/display.h>
+#include <stdbool.h>
+#include <stddef.h>
+/*----------------------------------------------------------------------------*/
+struct WorkQueue;
+
+struct StripRendererConfig
+{
+  /** Mandatory: display interface with 16-bit pixels. */
+  void *display;
+  /** Optional: work queue for rendering tasks. */
+  struct WorkQueue *wq;
+  /** Mandatory: maximum number of display list entries. */
+  size_t capacity;
+  /** Mandatory: height of the strip in rows. */
+  uint16_t rows;
+};
+
+struct SRCommand
+{
+  /* Glyph or bitmap data */
+  const void *data;
+  /* Bounding box of the primitive, may exceed the display */
+  struct DisplayWindow area;
+  /* Primitive color */
+  uint16_t color;
+  /* Primitive type */
+  uint8_t type;
+  /* Line goes from the bottom left corner to the top right corner */
+  bool rising;
+};
+
+struct StripRenderer
+{
+  void (*callback)(void *);
+  void *callbackArgument;
+
+  /* Display interface */
+  struct Interface *display;
+  /* Work queue for rendering tasks */
+  struct WorkQueue *wq;
+
+  /* Ping-pong strip buffers */
+  uint16_t *buffers[2];
+  /* Display list */
+  struct SRCommand *commands;
+
+  /* Maximum number of display list entries */
+  size_t capacity;
+  /* Number of display list entries */
+  size_t count;
+
+  /* Display resolution */
+  uint16_t width;
+  uint16_t height;
+  /* Height of the strip */
+  uint16_t rows;
+  /* Number of strips in a frame */
+  uint16_t strips;
+  /* Number of rendered strips */
+  uint16_t rendered;
+  /* Number of strips submitted for writing */
+  uint16_t sent;
+  /* Background color in the byte order of the display interface */
+  uint16_t background;
+
+  /* Strip transfer is in progress */
+  bool transfer;
+  /* Rendering of the frame is in progress */
+  bool busy;
+};
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+bool srInit(struct StripRenderer *, const struct StripRendererConfig *);
+void srDeinit(struct StripRenderer *);
+bool srAddBitmap(struct StripRenderer *, uint16_t, uint16_t, uint16_t,
+    uint16_t, const uint16_t *);
+bool srAddGlyph(struct StripRenderer *, uint16_t, uint16_t, uint16_t,
+    uint16_t, const uint8_t *, uint16_t);
+bool srAddLine(struct StripRenderer *, uint16_t, uint16_t, uint16_t,
+    uint16_t, uint16_t);
+bool srAddRect(struct StripRenderer *, const struct DisplayWindow *,
+    uint16_t);
+void srClear(struct StripRenderer *, uint16_t);
+bool srRender(struct StripRenderer *);
+void srSetCallback(struct StripRenderer *, void (*)(void *), void *);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+static inline bool srIsBusy(const struct StripRenderer *renderer)
+{
+  return renderer->busy;
+}
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* DPM_DISPLAYS_STRIP_RENDERER_H_ */
@@ -0,0 +1,23 @@
+/*
+ * dpm/memory_bus.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#ifndef DPM_MEMORY_BUS_H_
+#define DPM_MEMORY_BUS_H_
+/*----------------------------------------------------------------------------*/
+#include <xcore/interface.h>
+/*----------------------------------------------------------------------------*/
+enum MemoryBusParameter
+{
+  /**
+   * Repeat the first element of the buffer during the next write, length
+   * of the write sets the total number of bytes on the bus. Get request
+   * returns @b E_OK when the option is supported by the bus.
+   * Data pointer should be set to zero.
+   */
+  IF_MEMORY_BUS_REPEAT = IF_PARAMETER_END
+};
+/*----------------------------------------------------------------------------*/
+#endif /* DPM_MEMORY_BUS_H_ */
@@ -11,14 +11,34 @@
 /*----------------------------------------------------------------------------*/
 enum OneWireParameter
 {
-  /** Start the device search. Data pointer should be set to zero. */
+  /**
+   * Start the device search. Search is always performed on the bus,
+   * cached results are not reused. Data pointer should be set to zero.
+   */
   IF_ONE_WIRE_START_SEARCH = IF_PARAMETER_END,
   /**
    * Read an address of the next device. Returns @b E_EMPTY when
    * all devices have already been found or @b E_OK otherwise.
    * Data pointer should be set to zero.
    */
-  IF_ONE_WIRE_FIND_NEXT
+  IF_ONE_WIRE_FIND_NEXT,
+  /**
+   * Drop cached search results. Cache is also dropped when the bus becomes
+   * empty or non-empty and rebuilt by each search started with
+   * @b IF_ONE_WIRE_START_SEARCH. Data pointer should be set to zero.
+   */
+  IF_ONE_WIRE_INVALIDATE,
+  /**
+   * Switch devices to overdrive speed during the next transfer.
+   * All devices on the bus should support overdrive speed.
+   * Data pointer should be set to zero.
+   */
+  IF_ONE_WIRE_OVERDRIVE,
+  /**
+   * Switch devices back to standard speed during the next transfer.
+   * Data pointer should be set to zero.
+   */
+  IF_ONE_WIRE_STANDARD
 };
 /*----------------------------------------------------------------------------*/
 #endif /* DPM_ONE_WIRE_H_ */
@@ -79,6 +79,10 @@ struct MemoryBusDma
   bool blocking;
   /* Transmission is currently active */
   bool busy;
+  /* DMA channel is configured for a fixed source address */
+  bool fixed;
+  /* Repeat the first element during the next write */
+  bool repeat;
 };
 /*----------------------------------------------------------------------------*/
 #endif /* DPM_PLATFORM_LPC_MEMORY_BUS_DMA_H_ */
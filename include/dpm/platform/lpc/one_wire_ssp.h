@@ -20,6 +20,11 @@ struct OneWireSspConfig
   PinNumber miso;
   /** Mandatory: pin used for data transmission on the serial bus. */
   PinNumber mosi;
+  /**
+   * Optional: number of device addresses in the search cache. Cache is
+   * rebuilt by each search started with IF_ONE_WIRE_START_SEARCH.
+   */
+  size_t cache;
   /** Optional: interrupt priority. */
   IrqPriority priority;
   /** Mandatory: peripheral identifier. */
@@ -35,6 +40,8 @@ struct OneWireSsp
 
   /* Address of the device */
   uint64_t address;
+  /* Addresses of the devices found during the search */
+  uint64_t *cache;
 
   /* Pointer to an input buffer */
   uint8_t *rxBuffer;
@@ -55,6 +62,22 @@ struct OneWireSsp
 
   /* Temporary variables for device search algorithm */
   uint8_t lastDiscrepancy, lastZero;
+
+  /* Maximum number of cached addresses */
+  uint8_t cacheCapacity;
+  /* Number of cached addresses */
+  uint8_t cacheCount;
+  /* Index of the next cached address returned by the search */
+  uint8_t cachePosition;
+  /* Cache contains addresses of all devices on the bus */
+  bool cacheValid;
+  /* Presence pulse was detected during the last bus reset */
+  bool present;
+
+  /* Overdrive speed is requested */
+  bool overdrive;
+  /* Current bus speed */
+  uint8_t speed;
 };
 /*----------------------------------------------------------------------------*/
 #endif /* DPM_PLATFORM_LPC_ONE_WIRE_SSP_H_ */
@@ -0,0 +1,76 @@
+/*
+ * regmap.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#ifndef DPM_REGMAP_H_
+#define DPM_REGMAP_H_
+/*----------------------------------------------------------------------------*/
+#include <xcore/helpers.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+/*----------------------------------------------------------------------------*/
+#define REGMAP_WORD_WIDTH 32
+
+#define REGMAP_WORDS(count) \
+    (((count) + REGMAP_WORD_WIDTH - 1) / REGMAP_WORD_WIDTH)
+/*----------------------------------------------------------------------------*/
+/* Entry of a declarative table with register reset values */
+struct RegMapDefault
+{
+  uint8_t address;
+  uint8_t value;
+};
+
+/*
+ * RAM shadow of a contiguous range of 8-bit device registers. Writes
+ * update the shadow and mark changed registers as dirty, dirty registers
+ * are then sent to the device in auto-increment transfers. The map is not
+ * thread-safe and should be used from the state machine of the driver only.
+ */
+struct RegMap
+{
+  /* Register values */
+  uint8_t *values;
+  /* Dirty flags, one bit per register */
+  uint32_t *dirty;
+
+  /* Address of the first register */
+  uint8_t first;
+  /* Maximum number of clean registers merged into a transfer */
+  uint8_t gap;
+  /* Number of registers */
+  uint16_t count;
+};
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+void regmapInit(struct RegMap *, uint8_t *, uint32_t *, uint8_t, size_t,
+    size_t);
+void regmapInvalidate(struct RegMap *, uint8_t, size_t);
+void regmapLoad(struct RegMap *, const struct RegMapDefault *, size_t);
+size_t regmapPrepare(struct RegMap *, uint8_t *, size_t);
+uint8_t regmapRead(const struct RegMap *, uint8_t);
+bool regmapUpdate(struct RegMap *, uint8_t, uint8_t, uint8_t);
+bool regmapWrite(struct RegMap *, uint8_t, uint8_t);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+static inline bool regmapIsDirty(const struct RegMap *map)
+{
+  for (size_t index = 0; index < REGMAP_WORDS((size_t)map->count); ++index)
+  {
+    if (map->dirty[index])
+      return true;
+  }
+
+  return false;
+}
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* DPM_REGMAP_H_ */
@@ -0,0 +1,44 @@
+/*
+ * sensors/ds18b20_defs.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#ifndef DPM_SENSORS_DS18B20_DEFS_H_
+#define DPM_SENSORS_DS18B20_DEFS_H_
+/*----------------------------------------------------------------------------*/
+#include <dpm/sensors/sensor.h>
+/*----------------------------------------------------------------------------*/
+#define CRC8_INITIAL            0x00
+
+#define LENGTH_READ_SCRATCHPAD  1
+#define LENGTH_SCRATCHPAD       9
+#define LENGTH_START_CONVERSION 1
+#define LENGTH_WRITE_SCRATCHPAD 4
+/*----------------------------------------------------------------------------*/
+enum
+{
+  CMD_READ_SCRATCHPAD   = 0xBE,
+  CMD_START_CONVERSION  = 0x44,
+  CMD_WRITE_SCRATCHPAD  = 0x4E
+};
+
+enum
+{
+  FLAG_RESET  = 0x01,
+  FLAG_READY  = 0x02,
+  FLAG_LOOP   = 0x04,
+  FLAG_SAMPLE = 0x08
+};
+/*----------------------------------------------------------------------------*/
+struct DS18B20Group;
+struct DS18B20GroupSensor;
+
+enum SensorStatus ds18b20GroupGetStatus(const struct DS18B20Group *);
+void ds18b20GroupReset(struct DS18B20Group *, struct DS18B20GroupSensor *);
+void ds18b20GroupSample(struct DS18B20Group *, struct DS18B20GroupSensor *);
+void ds18b20GroupStart(struct DS18B20Group *, struct DS18B20GroupSensor *);
+void ds18b20GroupStop(struct DS18B20Group *);
+bool ds18b20GroupUpdate(struct DS18B20Group *, struct DS18B20GroupSensor *);
+/*----------------------------------------------------------------------------*/
+#endif /* DPM_SENSORS_DS18B20_DEFS_H_ */
@@ -0,0 +1,92 @@
+/*
+ * sensors/ds18b20_group.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#ifndef DPM_SENSORS_DS18B20_GROUP_H_
+#define DPM_SENSORS_DS18B20_GROUP_H_
+/*----------------------------------------------------------------------------*/
+#include <dpm/sensors/ds18b20.h>
+/*----------------------------------------------------------------------------*/
+extern const struct EntityClass * const DS18B20Group;
+extern const struct SensorClass * const DS18B20GroupSensor;
+
+struct DS18B20GroupConfig
+{
+  /** Mandatory: sensor bus. */
+  void *bus;
+  /** Mandatory: timer for conversion time calculations. */
+  void *timer;
+  /** Mandatory: maximum number of sensors on the bus. */
+  size_t capacity;
+  /** Optional: temperature resolution of all sensors. */
+  enum DS18B20Resolution resolution;
+};
+
+struct DS18B20GroupSensor;
+
+struct DS18B20Group
+{
+  struct Entity base;
+
+  /* Sensor proxy used for update requests */
+  struct DS18B20GroupSensor *active;
+  /* Sensor proxies */
+  struct DS18B20GroupSensor **sensors;
+
+  /* Sensor bus */
+  struct Interface *bus;
+  /* Timer for timeout calculations */
+  struct Timer *timer;
+
+  /* Maximum number of sensors */
+  size_t capacity;
+  /* Number of sensors */
+  size_t count;
+  /* Index of the sensor being read */
+  size_t position;
+
+  /* Command and scratchpad buffer */
+  uint8_t buffer[9];
+  /* Command and status flags */
+  uint8_t flags;
+  /* Temperature resolution configuration */
+  uint8_t resolution;
+  /* Current operation */
+  uint8_t state;
+};
+
+struct DS18B20GroupSensorConfig
+{
+  /** Mandatory: parent object. */
+  struct DS18B20Group *parent;
+  /** Mandatory: device address. */
+  uint64_t address;
+};
+
+struct DS18B20GroupSensor
+{
+  struct Sensor base;
+
+  void *callbackArgument;
+  void (*onErrorCallback)(void *, enum SensorResult);
+  void (*onResultCallback)(void *, const void *, size_t);
+  void (*onUpdateCallback)(void *);
+
+  /* Parent object */
+  struct DS18B20Group *parent;
+  /* Device address */
+  uint64_t address;
+  /* Command flags */
+  uint8_t flags;
+};
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+struct DS18B20GroupSensor *ds18b20GroupMakeSensor(struct DS18B20Group *,
+    uint64_t);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* DPM_SENSORS_DS18B20_GROUP_H_ */
@@ -7,6 +7,7 @@
 #ifndef DPM_SENSORS_HMC5883_H_
 #define DPM_SENSORS_HMC5883_H_
 /*----------------------------------------------------------------------------*/
+#include <dpm/regmap.h>
 #include <dpm/sensors/sensor.h>
 #include <halm/pin.h>
 /*----------------------------------------------------------------------------*/
@@ -25,6 +26,7 @@ enum [[gnu::packed]] HMC5883Frequency
   HMC5883_FREQUENCY_15HZ,
   HMC5883_FREQUENCY_30HZ,
   HMC5883_FREQUENCY_75HZ,
+  HMC5883_FREQUENCY_160HZ,
 
   HMC5883_FREQUENCY_END
 };
@@ -71,7 +73,12 @@ struct HMC5883Config
   /** Optional: bit rate of the serial interface. */
   uint32_t rate;
 
-  /** Mandatory: sample rate for the magnetometer. */
+  /**
+   * Mandatory: sample rate for the magnetometer. The rate of 160 Hz is
+   * achieved in single measurement mode, the next measurement is triggered
+   * after each read. Oversampling is disabled in this case, other
+   * oversampling settings are rejected.
+   */
   enum HMC5883Frequency frequency;
   /** Optional: gain configuration. */
   enum HMC5883Gain gain;
@@ -101,10 +108,26 @@ struct HMC5883
   /* Baud rate of the serial interface */
   uint32_t rate;
 
+  /* Hard-iron and soft-iron correction */
+  struct
+  {
+    /* Correction matrix in Q16.16 format */
+    int32_t matrix[9];
+    /* Hard-iron offsets in raw units */
+    int16_t offset[3];
+  } correction;
+
+  /* Shadow of configuration registers */
+  struct RegMap regmap;
+  /* Dirty flags of configuration registers */
+  uint32_t dirty[REGMAP_WORDS(3)];
+
   /* Timestamp of the last measurement */
   uint64_t timestamp;
-  /* Buffer for received data */
-  uint8_t buffer[7];
+  /* Buffer for received data and measurement commands */
+  uint8_t buffer[8];
+  /* Values of configuration registers */
+  uint8_t registers[3];
   /* Calibration mode */
   uint8_t calibration;
   /* Command and status flags */
@@ -124,6 +147,7 @@ BEGIN_DECLS
 void hmc5883ApplyNegOffset(struct HMC5883 *);
 void hmc5883ApplyPosOffset(struct HMC5883 *);
 void hmc5883EnableNormalMode(struct HMC5883 *);
+void hmc5883SetCorrection(struct HMC5883 *, const int16_t *, const int32_t *);
 
 END_DECLS
 /*----------------------------------------------------------------------------*/
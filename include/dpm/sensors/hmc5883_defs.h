@@ -23,7 +23,8 @@ enum
   FLAG_EVENT    = 0x04,
   FLAG_LOOP     = 0x08,
   FLAG_SAMPLE   = 0x10,
-  FLAG_SUSPEND  = 0x20
+  FLAG_SUSPEND  = 0x20,
+  FLAG_POINTER  = 0x40
 };
 
 enum
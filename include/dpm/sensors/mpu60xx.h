@@ -7,12 +7,17 @@
 #ifndef DPM_SENSORS_MPU60XX_H_
 #define DPM_SENSORS_MPU60XX_H_
 /*----------------------------------------------------------------------------*/
+#include <dpm/regmap.h>
 #include <dpm/sensors/sensor.h>
 #include <halm/pin.h>
 /*----------------------------------------------------------------------------*/
+/* Number of shadowed registers from XG_OFFS_USRH to INT_ENABLE */
+#define MPU60XX_SHADOW_LENGTH 38
+/*----------------------------------------------------------------------------*/
 extern const struct EntityClass * const MPU60XX;
 extern const struct SensorClass * const MPU60XXAccelerometer;
 extern const struct SensorClass * const MPU60XXGyroscope;
+extern const struct SensorClass * const MPU60XXOrientation;
 extern const struct SensorClass * const MPU60XXThermometer;
 
 struct Interface;
@@ -59,12 +64,46 @@ struct MPU60XXConfig
   /** Optional: pin used as Chip Select output. */
   PinNumber cs;
 
-  /** Mandatory: sample rate for both accelerometer and gyroscope. */
+  /**
+   * Mandatory: sample rate for both accelerometer and gyroscope. Rates
+   * above 1 kHz disable the digital low pass filter, accelerometer samples
+   * are updated at 1 kHz in this case. The rate is rounded to the nearest
+   * integer fraction of 1 kHz or, for rates above 1 kHz, of 8 kHz.
+   */
   uint16_t sampleRate;
+  /**
+   * Optional: number of samples accumulated in the hardware FIFO before
+   * reading. Samples are read in bursts and delivered to proxies as arrays,
+   * the timestamp refers to the first sample of the array. Zero value
+   * disables FIFO mode.
+   */
+  uint8_t fifoDepth;
   /** Optional: accelerometer scale configuration. */
   enum MPU60XXAccelScale accelScale;
   /** Optional: gyroscope scale configuration. */
   enum MPU60XXGyroScale gyroScale;
+  /**
+   * Optional: gain of the orientation filter in rad/s, Q0.16 format.
+   * Default value of 0.1 rad/s is used when the field is zero.
+   */
+  uint16_t fusionGain;
+
+  /**
+   * Optional: number of consecutive still samples used for gyroscope bias
+   * estimation. Zero value disables estimation.
+   */
+  uint16_t biasWindow;
+  /**
+   * Optional: maximum deviation of the angular rate in mdps for samples
+   * considered still. Default value of 1000 mdps is used when the field
+   * is zero.
+   */
+  uint16_t biasThreshold;
+  /**
+   * Optional: enable writing of the gyroscope bias into the offset
+   * registers of the sensor.
+   */
+  bool biasOffload;
 };
 
 struct MPU60XXProxy;
@@ -79,6 +118,8 @@ struct MPU60XX
   struct MPU60XXProxy *accelerometer;
   /* Gyroscope sensor proxy */
   struct MPU60XXProxy *gyroscope;
+  /* Orientation sensor proxy */
+  struct MPU60XXProxy *orientation;
   /* Thermometer sensor proxy */
   struct MPU60XXProxy *thermometer;
 
@@ -97,17 +138,75 @@ struct MPU60XX
   /* Baud rate of the serial interface */
   uint32_t rate;
 
-  /* Sample rate settings */
-  uint16_t sampleRate;
+  /* Gyroscope output rate in Hz */
+  uint16_t baseRate;
+  /* Sample rate divider, output rate is the base rate divided by it */
+  uint16_t rateDivider;
   /* Accelerometer scale settings */
   uint8_t accelScale;
   /* Gyroscope scale settings */
   uint8_t gyroScale;
 
+  /* Shadow of registers from XG_OFFS_USRH to INT_ENABLE */
+  struct RegMap regmap;
+  /* Dirty flags of shadowed registers */
+  uint32_t dirty[REGMAP_WORDS(MPU60XX_SHADOW_LENGTH)];
+
   /* Timestamp of the last measurement */
   uint64_t timestamp;
-  /* Buffer for received data */
+  /* Buffer for received data and register writes */
   uint8_t buffer[14];
+  /* Values of shadowed registers */
+  uint8_t registers[MPU60XX_SHADOW_LENGTH];
+
+  struct
+  {
+    /* Raw samples read from the FIFO */
+    uint8_t *buffer;
+    /* Converted samples */
+    int32_t *results;
+    /* Expected timestamp of the next sample */
+    uint64_t expected;
+    /* Number of bytes available in the FIFO */
+    uint16_t available;
+    /* Maximum number of samples in a burst */
+    uint8_t depth;
+  } fifo;
+
+  struct
+  {
+    /* Orientation quaternion in Q2.30 format */
+    int32_t quaternion[4];
+    /* Filter gain multiplied by the sample period, Q2.30 format */
+    int32_t step;
+  } fusion;
+
+  struct
+  {
+    /* Accelerometer correction matrix in Q16.16 format */
+    int32_t matrix[9];
+    /* Accelerometer offsets in raw units */
+    int16_t offset[3];
+
+    /* Gyroscope bias in raw units not covered by offset registers */
+    int16_t bias[3];
+    /* Values of gyroscope offset registers */
+    int16_t registers[3];
+
+    /* Reference accelerometer and gyroscope samples of the still interval */
+    int16_t reference[6];
+    /* Sum of gyroscope samples in the still interval */
+    int32_t sum[3];
+    /* Number of samples in the still interval */
+    uint16_t count;
+    /* Length of the still interval required for bias update */
+    uint16_t window;
+    /* Maximum deviation of still gyroscope samples in raw units */
+    uint16_t threshold;
+    /* Write bias into offset registers */
+    bool offload;
+  } calibration;
+
   /* Command and status flags */
   uint16_t flags;
   /* Current operation */
@@ -141,8 +240,14 @@ BEGIN_DECLS
 
 struct MPU60XXProxy *mpu60xxMakeAccelerometer(struct MPU60XX *);
 struct MPU60XXProxy *mpu60xxMakeGyroscope(struct MPU60XX *);
+struct MPU60XXProxy *mpu60xxMakeOrientation(struct MPU60XX *);
 struct MPU60XXProxy *mpu60xxMakeThermometer(struct MPU60XX *);
 
+void mpu60xxGetGyroBias(const struct MPU60XX *, int16_t *);
+void mpu60xxSetAccelCalibration(struct MPU60XX *, const int16_t *,
+    const int32_t *);
+void mpu60xxSetGyroBias(struct MPU60XX *, const int16_t *);
+
 END_DECLS
 /*----------------------------------------------------------------------------*/
 #endif /* DPM_SENSORS_MPU60XX_H_ */
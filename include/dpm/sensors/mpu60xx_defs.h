@@ -22,13 +22,24 @@ enum
   FLAG_THERMO_LOOP   = 0x0080,
   FLAG_THERMO_SAMPLE = 0x0100,
   FLAG_SUSPEND       = 0x0200,
+  FLAG_ORIENT_LOOP   = 0x0400,
+  FLAG_ORIENT_SAMPLE = 0x0800,
+  FLAG_OFFSET        = 0x1000,
 
-  FLAG_LOOP          = FLAG_ACCEL_LOOP | FLAG_GYRO_LOOP | FLAG_THERMO_LOOP,
+  FLAG_LOOP          = FLAG_ACCEL_LOOP | FLAG_GYRO_LOOP | FLAG_THERMO_LOOP
+      | FLAG_ORIENT_LOOP,
   FLAG_SAMPLE        = FLAG_ACCEL_SAMPLE | FLAG_GYRO_SAMPLE | FLAG_THERMO_SAMPLE
+      | FLAG_ORIENT_SAMPLE
 };
 
 enum
 {
+  REG_XG_OFFS_USRH        = 0x13,
+  REG_XG_OFFS_USRL        = 0x14,
+  REG_YG_OFFS_USRH        = 0x15,
+  REG_YG_OFFS_USRL        = 0x16,
+  REG_ZG_OFFS_USRH        = 0x17,
+  REG_ZG_OFFS_USRL        = 0x18,
   REG_SMPLRT_DIV          = 0x19,
   REG_CONFIG              = 0x1A,
   REG_GYRO_CONFIG         = 0x1B,
@@ -60,8 +71,16 @@ enum
   REG_FIFO_R_W            = 0x74,
   REG_WHO_AM_I            = 0x75
 };
+/*------------------Shadowed registers----------------------------------------*/
+#define SHADOW_FIRST                    REG_XG_OFFS_USRH
+#define SHADOW_LAST                     REG_INT_ENABLE
+#define SHADOW_LENGTH                   (SHADOW_LAST - SHADOW_FIRST + 1)
 /*------------------Sample Rate Divider register------------------------------*/
 #define SMPLRT_DIV_MAX                  1000
+/* Maximum sample rate with the digital low pass filter disabled */
+#define SMPLRT_DIV_MAX_DLPF_OFF         8000
+/* Maximum value of the divider */
+#define SMPLRT_DIV_RANGE                256
 /*------------------Configuration register------------------------------------*/
 enum
 {
@@ -145,6 +164,11 @@ enum
 #define FIFO_EN_YG_FIFO_EN              BIT(5)
 #define FIFO_EN_XG_FIFO_EN              BIT(6)
 #define FIFO_EN_TEMP_FIFO_EN            BIT(7)
+/*------------------FIFO Count registers--------------------------------------*/
+#define FIFO_SIZE                       1024
+/* Accelerometer, temperature and gyroscope samples in register order */
+#define FIFO_FRAME_SIZE                 14
+#define FIFO_MAX_FRAMES                 (FIFO_SIZE / FIFO_FRAME_SIZE)
 /*------------------INT Pin/Bypass Enable Configuration register--------------*/
 #define INT_PIN_CFG_I2C_BYPASS_EN       BIT(1)
 #define INT_PIN_CFG_FSYNC_INT_EN        BIT(2)
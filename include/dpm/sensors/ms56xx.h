@@ -11,6 +11,7 @@
 #include <halm/pin.h>
 /*----------------------------------------------------------------------------*/
 extern const struct SensorClass * const MS56XX;
+extern const struct SensorClass * const MS56XXAltimeter;
 extern const struct SensorClass * const MS56XXThermometer;
 
 struct Interface;
@@ -50,12 +51,24 @@ struct MS56XXConfig
   /** Optional: pin used as Chip Select output. */
   PinNumber cs;
 
+  /**
+   * Optional: sea level pressure in Pa used for altitude calculation.
+   * Standard pressure of 101325 Pa is used when the field is zero.
+   */
+  uint32_t seaLevelPressure;
+  /**
+   * Optional: number of pressure conversions per temperature conversion.
+   * Temperature is converted before each pressure conversion when the
+   * field is zero.
+   */
+  uint8_t temperaturePeriod;
   /** Optional: oversampling configuration. */
   enum MS56XXOversampling oversampling;
   /** Mandatory: sensor subtype. */
   enum MS56XXSubtype subtype;
 };
 
+struct MS56XXAltimeter;
 struct MS56XXThermometer;
 
 struct MS56XX
@@ -70,6 +83,8 @@ struct MS56XX
   void (*calculate)(const uint16_t *, int32_t, int64_t *, int64_t *);
   void (*compensate)(int32_t, int32_t, int64_t *, int32_t *, int64_t *);
 
+  /* Altimeter sensor proxy */
+  struct MS56XXAltimeter *altimeter;
   /* Thermometer sensor proxy */
   struct MS56XXThermometer *thermometer;
 
@@ -88,10 +103,25 @@ struct MS56XX
 
   /* Timestamp of the last measurement */
   uint64_t timestamp;
+  /* Start time of the current conversion */
+  uint64_t started;
   /* Raw pressure value */
   uint32_t pressure;
   /* Raw temperature value */
   uint32_t temperature;
+  /* Reciprocal of the sea level pressure in Q0.40 format */
+  uint32_t seaLevelScale;
+
+  /* Compensation values calculated from the last temperature value */
+  struct
+  {
+    /* Offset at actual temperature */
+    int64_t off;
+    /* Sensitivity at actual temperature */
+    int64_t sens;
+    /* Compensated temperature */
+    int32_t temperature;
+  } compensation;
 
   /* PROM data */
   uint16_t prom[8];
@@ -103,10 +133,34 @@ struct MS56XX
   uint8_t oversampling;
   /* Current PROM position */
   uint8_t parameter;
+  /* Pressure conversions left before the next temperature conversion */
+  uint8_t cycle;
+  /* Pressure conversions per temperature conversion */
+  uint8_t period;
+  /* Type of the conversion result waiting for processing */
+  uint8_t pending;
   /* Current operation */
   uint8_t state;
 };
 
+struct MS56XXAltimeterConfig
+{
+  /** Mandatory: parent object. */
+  struct MS56XX *parent;
+};
+
+struct MS56XXAltimeter
+{
+  struct Sensor base;
+
+  void *callbackArgument;
+  void (*onErrorCallback)(void *, enum SensorResult);
+  void (*onResultCallback)(void *, const void *, size_t);
+  void (*onUpdateCallback)(void *);
+
+  struct MS56XX *parent;
+};
+
 struct MS56XXThermometerConfig
 {
   /** Mandatory: parent object. */
@@ -127,7 +181,9 @@ struct MS56XXThermometer
 /*----------------------------------------------------------------------------*/
 BEGIN_DECLS
 
+struct MS56XXAltimeter *ms56xxMakeAltimeter(struct MS56XX *);
 struct MS56XXThermometer *ms56xxMakeThermometer(struct MS56XX *);
+void ms56xxSetSeaLevelPressure(struct MS56XX *, uint32_t);
 
 END_DECLS
 /*----------------------------------------------------------------------------*/
@@ -27,11 +27,49 @@ enum SensorStatus
   SENSOR_ERROR
 };
 
+enum SensorType
+{
+  SENSOR_TYPE_INT8,
+  SENSOR_TYPE_INT16,
+  SENSOR_TYPE_INT32,
+  SENSOR_TYPE_INT64,
+  SENSOR_TYPE_UINT8,
+  SENSOR_TYPE_UINT16,
+  SENSOR_TYPE_UINT32,
+  SENSOR_TYPE_UINT64
+};
+
+enum SensorUnit
+{
+  SENSOR_UNIT_NONE,
+  SENSOR_UNIT_CELSIUS,
+  SENSOR_UNIT_G,
+  SENSOR_UNIT_GAUSS,
+  SENSOR_UNIT_METER,
+  SENSOR_UNIT_PASCAL,
+  SENSOR_UNIT_PERCENT,
+  SENSOR_UNIT_RADIAN_PER_SECOND
+};
+
+/* Binary description of measurement results */
+struct SensorDescriptor
+{
+  /* Element type, value of the enum SensorType */
+  uint8_t type;
+  /* Number of elements in the result */
+  uint8_t count;
+  /* Binary exponent, value of an element is element * 2^exponent */
+  int8_t exponent;
+  /* Physical unit, value of the enum SensorUnit */
+  uint8_t unit;
+};
+
 /* Class descriptor */
 struct SensorClass
 {
   CLASS_HEADER
 
+  const struct SensorDescriptor *(*getDescriptor)(const void *);
   const char *(*getFormat)(const void *);
   enum SensorStatus (*getStatus)(const void *);
   uint64_t (*getTimestamp)(const void *);
@@ -55,6 +93,19 @@ struct Sensor
 /*----------------------------------------------------------------------------*/
 BEGIN_DECLS
 
+/**
+ * Get the binary descriptor of measurement results.
+ *
+ * @param sensor Pointer to a Sensor object.
+ * @return Pointer to a statically allocated descriptor, it stays valid
+ * for the lifetime of the sensor.
+ */
+static inline const struct SensorDescriptor *sensorGetDescriptor(
+    const void *sensor)
+{
+  return ((const struct SensorClass *)CLASS(sensor))->getDescriptor(sensor);
+}
+
 /**
  * Get the data format of measurement results.
  *
@@ -232,6 +283,38 @@ static inline bool sensorUpdate(void *sensor)
   return ((const struct SensorClass *)CLASS(sensor))->update(sensor);
 }
 
+/**
+ * Get the size of a single result element.
+ *
+ * @param descriptor Pointer to a result descriptor.
+ * @return Element size in bytes or zero when the element type is unknown.
+ */
+static inline size_t sensorElementSize(
+    const struct SensorDescriptor *descriptor)
+{
+  switch ((enum SensorType)descriptor->type)
+  {
+    case SENSOR_TYPE_INT8:
+    case SENSOR_TYPE_UINT8:
+      return 1;
+
+    case SENSOR_TYPE_INT16:
+    case SENSOR_TYPE_UINT16:
+      return 2;
+
+    case SENSOR_TYPE_INT32:
+    case SENSOR_TYPE_UINT32:
+      return 4;
+
+    case SENSOR_TYPE_INT64:
+    case SENSOR_TYPE_UINT64:
+      return 8;
+
+    default:
+      return 0;
+  }
+}
+
 END_DECLS
 /*----------------------------------------------------------------------------*/
 #endif /* DPM_SENSORS_SENSOR_H_ */
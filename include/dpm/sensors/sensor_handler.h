@@ -7,15 +7,45 @@
 #ifndef DPM_SENSORS_SENSOR_HANDLER_H_
 #define DPM_SENSORS_SENSOR_HANDLER_H_
 /*----------------------------------------------------------------------------*/
+#include <dpm/bitmap.h>
 #include <dpm/sensors/sensor.h>
+#include <stddef.h>
+/*----------------------------------------------------------------------------*/
+/* Storage for a sensor handler with a fixed number of sensors */
+#define SH_STORAGE(capacity) \
+    struct \
+    { \
+      struct SHEntry sensors[capacity]; \
+      uint32_t words[BITMAP_WORDS(capacity) * 3]; \
+    }
+
+#define shInitStorage(handler, storage) \
+    shInitStatic((handler), (storage)->sensors, (storage)->words, \
+        ARRAY_SIZE((storage)->sensors))
+/* Default payload length of a sample stored in the batch buffer */
+#define SH_SAMPLE_LENGTH 16
+/* Size of a batch buffer element for the given payload length */
+#define SH_SAMPLE_SIZE(length) \
+    ((offsetof(struct SHSample, data) + (length) + 7) & ~(size_t)7)
 /*----------------------------------------------------------------------------*/
 struct WorkQueue;
 
+struct SHSample
+{
+  /* Timestamp of the measurement */
+  uint64_t timestamp;
+  /* Sensor tag */
+  int tag;
+  /* Payload length */
+  uint32_t length;
+  /* Payload, word-aligned due to the preceding fields */
+  uint8_t data[];
+};
+
 struct SHEntry
 {
   void *handler;
   void *sensor;
-  uint32_t mask;
   int tag;
 };
 
@@ -30,6 +60,29 @@ struct SensorHandler
   void (*failureCallback)(void *, int, enum SensorResult);
   void *failureCallbackArgument;
 
+  /* Optional batch delivery interface */
+  struct
+  {
+    uint8_t *buffer;
+    void (*callback)(void *);
+    void *argument;
+
+    /* Maximum payload length */
+    uint32_t length;
+    /* Distance between consecutive samples */
+    uint32_t stride;
+
+    /* Free-running indices of the single-producer single-consumer ring */
+    uint32_t head;
+    uint32_t tail;
+    /* Ring capacity minus one */
+    uint32_t mask;
+    /* Number of samples that triggers the notification */
+    uint32_t watermark;
+    /* Number of samples lost due to the ring overflow */
+    uint32_t dropped;
+  } batch;
+
   /* Optional Bus Handler executor interface */
   void (*errorCallback)(void *);
   void *errorCallbackArgument;
@@ -41,10 +94,12 @@ struct SensorHandler
   /* Optional Work Queue executor interface */
   void *wq;
 
+  struct Bitmap pool;
+  struct Bitmap detaching;
+  struct Bitmap updating;
+
   size_t capacity;
-  uint32_t pool;
-  uint32_t detaching;
-  uint32_t updating;
+  bool allocated;
   bool busy;
   bool pending;
 };
@@ -52,6 +107,8 @@ struct SensorHandler
 BEGIN_DECLS
 
 bool shInit(struct SensorHandler *, size_t);
+void shInitStatic(struct SensorHandler *, struct SHEntry *, uint32_t *,
+    size_t);
 void shDeinit(struct SensorHandler *);
 bool shAttach(struct SensorHandler *, void *, int);
 void shDetach(struct SensorHandler *, void *);
@@ -62,12 +119,31 @@ void shSetDataCallback(struct SensorHandler *,
 void shSetFailureCallback(struct SensorHandler *,
     void (*)(void *, int, enum SensorResult), void *);
 
+/* Batch data interface */
+void shSetBatchBuffer(struct SensorHandler *, void *, size_t, size_t,
+    size_t);
+void shSetBatchCallback(struct SensorHandler *, void (*)(void *), void *);
+uint32_t shGetDroppedSamples(const struct SensorHandler *);
+size_t shGetSamples(struct SensorHandler *, const struct SHSample **);
+void shReleaseSamples(struct SensorHandler *, size_t);
+
 /* Executor interface */
 void shSetErrorCallback(void *, void (*)(void *), void *);
 void shSetIdleCallback(void *, void (*)(void *), void *);
 void shSetUpdateCallback(void *, void (*)(void *), void *);
 void shSetUpdateWorkQueue(void *, struct WorkQueue *);
 
+END_DECLS
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+static inline const struct SHSample *shNextSample(
+    const struct SensorHandler *handler, const struct SHSample *sample)
+{
+  return (const struct SHSample *)((const uint8_t *)sample
+      + handler->batch.stride);
+}
+
 END_DECLS
 /*----------------------------------------------------------------------------*/
 #endif /* DPM_SENSORS_SENSOR_HANDLER_H_ */
@@ -0,0 +1,115 @@
+/*
+ * sensors/sensor_logger.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#ifndef DPM_SENSORS_SENSOR_LOGGER_H_
+#define DPM_SENSORS_SENSOR_LOGGER_H_
+/*----------------------------------------------------------------------------*/
+#include <dpm/sensors/sensor_handler.h>
+/*----------------------------------------------------------------------------*/
+/*
+ * Each flash page holds an independent block: a header with the magic
+ * number, used length and sequence number, followed by records. Element
+ * values and timestamps are stored as zigzag varint deltas that restart
+ * at the beginning of every block.
+ */
+#define SL_BLOCK_MAGIC        0x4C53
+#define SL_BLOCK_HEADER_SIZE  8
+#define SL_MAX_STREAMS        127
+/*----------------------------------------------------------------------------*/
+struct Interface;
+struct Timer64;
+
+struct SensorLoggerConfig
+{
+  /** Mandatory: flash memory interface. */
+  void *memory;
+  /** Mandatory: sensor handler. */
+  struct SensorHandler *handler;
+  /** Optional: 64-bit timer for sample timestamps. */
+  struct Timer64 *chrono;
+
+  /** Optional: start of the log region, should be aligned to a sector. */
+  uint32_t offset;
+  /** Optional: size of the log region, whole memory is used by default. */
+  uint32_t size;
+  /** Mandatory: maximum number of streams. */
+  size_t capacity;
+};
+
+struct SLStream
+{
+  /* Element values of the previous sample in the current block */
+  uint8_t previous[SH_SAMPLE_LENGTH];
+  /* Descriptor of stream samples */
+  struct SensorDescriptor descriptor;
+  /* Sensor tag */
+  int tag;
+  /* Stream definition is written to the current block */
+  bool defined;
+};
+
+struct SensorLogger
+{
+  /* Flash memory interface */
+  struct Interface *memory;
+  /* Sensor handler */
+  struct SensorHandler *handler;
+  /* Chrono timer for timestamps */
+  struct Timer64 *chrono;
+
+  /* Double buffer for flash pages */
+  uint8_t *buffers[2];
+  /* Attached streams */
+  struct SLStream *streams;
+
+  /* Timestamp of the previous record in the current block */
+  uint64_t timestamp;
+
+  /* Erase unit, sector or block parameter */
+  int eraseParameter;
+  /* Size of the erase unit */
+  uint32_t eraseSize;
+  /* Size of the flash page and of each buffer */
+  uint32_t pageSize;
+
+  /* Log region */
+  uint32_t offset;
+  uint32_t size;
+  /* Write position */
+  uint32_t position;
+  /* Sequence number of the next block */
+  uint32_t sequence;
+  /* Used length of the active buffer */
+  uint32_t length;
+  /* Number of samples lost due to full buffers or memory errors */
+  uint32_t dropped;
+
+  size_t capacity;
+  size_t count;
+
+  /* Number of records in each buffer */
+  uint16_t records[2];
+  /* Index of the buffer being filled */
+  uint8_t active;
+  /* Buffers submitted for writing */
+  uint8_t busy;
+  /* Index of the buffer being written */
+  uint8_t current;
+  /* State of the memory transfer */
+  uint8_t state;
+};
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+bool slInit(struct SensorLogger *, const struct SensorLoggerConfig *);
+void slDeinit(struct SensorLogger *);
+bool slAttach(struct SensorLogger *, int, const struct SensorDescriptor *);
+void slFlush(struct SensorLogger *);
+uint32_t slGetDroppedSamples(const struct SensorLogger *);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* DPM_SENSORS_SENSOR_LOGGER_H_ */
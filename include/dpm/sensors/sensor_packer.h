@@ -0,0 +1,27 @@
+/*
+ * sensors/sensor_packer.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#ifndef DPM_SENSORS_SENSOR_PACKER_H_
+#define DPM_SENSORS_SENSOR_PACKER_H_
+/*----------------------------------------------------------------------------*/
+#include <dpm/sensors/sensor.h>
+/*----------------------------------------------------------------------------*/
+/*
+ * Packed record layout: tag, type, count, exponent and unit bytes followed
+ * by elements in little-endian byte order. Multi-frame results are packed
+ * as a sequence of records.
+ */
+#define SENSOR_PACK_HEADER_SIZE 5
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+size_t sensorPack(void *, size_t, uint8_t, const struct SensorDescriptor *,
+    const void *, size_t);
+size_t sensorPackLength(const struct SensorDescriptor *);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* DPM_SENSORS_SENSOR_PACKER_H_ */
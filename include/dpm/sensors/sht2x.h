@@ -11,6 +11,7 @@
 #include <halm/pin.h>
 /*----------------------------------------------------------------------------*/
 extern const struct SensorClass * const SHT2X;
+extern const struct SensorClass * const SHT2XDewPoint;
 extern const struct SensorClass * const SHT2XThermometer;
 
 struct Interface;
@@ -45,8 +46,14 @@ struct SHT2XConfig
 
   /** Optional: resolution configuration. */
   enum SHT2XResolution resolution;
+  /**
+   * Optional: poll the sensor for conversion completion instead of waiting
+   * for the worst-case conversion time.
+   */
+  bool poll;
 };
 
+struct SHT2XDewPoint;
 struct SHT2XThermometer;
 
 struct SHT2X
@@ -58,6 +65,8 @@ struct SHT2X
   void (*onResultCallback)(void *, const void *, size_t);
   void (*onUpdateCallback)(void *);
 
+  /* Dew point sensor proxy */
+  struct SHT2XDewPoint *dewPoint;
   /* Thermometer sensor proxy */
   struct SHT2XThermometer *thermometer;
 
@@ -81,8 +90,30 @@ struct SHT2X
   uint8_t flags;
   /* Resolution settings */
   uint8_t resolution;
+  /* Remaining number of completion polls */
+  uint8_t polls;
   /* Current operation */
   uint8_t state;
+  /* Poll for conversion completion */
+  bool poll;
+};
+
+struct SHT2XDewPointConfig
+{
+  /** Mandatory: parent object. */
+  struct SHT2X *parent;
+};
+
+struct SHT2XDewPoint
+{
+  struct Sensor base;
+
+  void *callbackArgument;
+  void (*onErrorCallback)(void *, enum SensorResult);
+  void (*onResultCallback)(void *, const void *, size_t);
+  void (*onUpdateCallback)(void *);
+
+  struct SHT2X *parent;
 };
 
 struct SHT2XThermometerConfig
@@ -105,6 +136,7 @@ struct SHT2XThermometer
 /*----------------------------------------------------------------------------*/
 BEGIN_DECLS
 
+struct SHT2XDewPoint *sht2xMakeDewPoint(struct SHT2X *);
 struct SHT2XThermometer *sht2xMakeThermometer(struct SHT2X *);
 
 END_DECLS
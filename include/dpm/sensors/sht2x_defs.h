@@ -14,7 +14,9 @@ enum
   FLAG_LOOP          = 0x04,
   FLAG_SAMPLE        = 0x08,
   FLAG_THERMO_LOOP   = 0x10,
-  FLAG_THERMO_SAMPLE = 0x20
+  FLAG_THERMO_SAMPLE = 0x20,
+  FLAG_DEW_LOOP      = 0x40,
+  FLAG_DEW_SAMPLE    = 0x80
 };
 
 enum Command
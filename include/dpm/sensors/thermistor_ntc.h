@@ -15,6 +15,10 @@
 BEGIN_DECLS
 
 size_t ntcFindBinIndex(size_t size, const int16_t [static size], int32_t);
+void ntcRawToTemperatureArray(size_t size, const int16_t [static size],
+    int32_t *, const uint16_t *, size_t);
+void ntcRawToTemperatureChannels(size_t size, const int16_t * const *, size_t,
+    int32_t *, const uint16_t *, size_t);
 
 END_DECLS
 /*----------------------------------------------------------------------------*/
@@ -52,6 +56,35 @@ static inline uint16_t ntcTemperatureToRaw(size_t size,
   return (uint16_t)(previousRawOutput + (offset * step + (slope >> 1)) / slope);
 }
 
+/*
+ * Constant-time inverse conversion using a table indexed by temperature.
+ * Table entries are raw values spaced (1 << shift) temperature units apart
+ * starting from the minimum temperature. Temperatures outside of the table
+ * are saturated to the limits of the raw range. The inverse table usually
+ * covers a narrower range than the direct table, therefore such temperatures
+ * should be converted with ntcTemperatureToRaw instead.
+ */
+static inline uint16_t ntcTemperatureToRawInverse(size_t size,
+    const uint16_t table[static size], int32_t minimum, unsigned int shift,
+    int32_t temperature)
+{
+  if (temperature < minimum)
+    return UINT16_MAX;
+
+  const int32_t offset = temperature - minimum;
+  const size_t binIndex = (size_t)(offset >> shift);
+  const int32_t position = offset & (int32_t)((1UL << shift) - 1);
+
+  if (binIndex >= size - 1)
+    return binIndex == size - 1 && !position ? table[size - 1] : 0;
+
+  const int32_t currentBinOutput = table[binIndex];
+  const int32_t slope = table[binIndex + 1] - currentBinOutput;
+  const int32_t half = (int32_t)(1UL << shift) >> 1;
+
+  return (uint16_t)(currentBinOutput + ((position * slope + half) >> shift));
+}
+
 END_DECLS
 /*----------------------------------------------------------------------------*/
 #endif /* DPM_SENSORS_THERMISTOR_NTC_H_ */
@@ -10,12 +10,22 @@
 #include <dpm/sensors/sensor.h>
 #include <halm/pin.h>
 /*----------------------------------------------------------------------------*/
+#define XPT2046_MAX_SAMPLES 7
+/* Command byte, two bytes per conversion and a trailing power-down command */
+#define XPT2046_BUFFER_SIZE (XPT2046_MAX_SAMPLES * 8 + 3)
+
 extern const struct SensorClass * const XPT2046;
 
 struct Interface;
 struct Interrupt;
 struct Timer;
 
+struct XPT2046Point
+{
+  int16_t x;
+  int16_t y;
+};
+
 struct XPT2046Config
 {
   /** Mandatory: serial interface. */
@@ -30,12 +40,25 @@ struct XPT2046Config
   /** Mandatory: pin used as Chip Select output. */
   PinNumber cs;
 
+  /** Optional: update rate while the panel is touched, default is 100 Hz. */
+  uint16_t frequency;
   /** Optional: touch threshold */
   uint16_t threshold;
   /** Mandatory: X resolution. */
   uint16_t x;
   /** Mandatory: Y resolution. */
   uint16_t y;
+
+  /**
+   * Optional: strength of the IIR filter applied to coordinates, filter
+   * coefficient is 1 / 2^filter. Filter is disabled when set to zero.
+   */
+  uint8_t filter;
+  /**
+   * Optional: number of conversions per axis, median value is used.
+   * Must be odd, default is one conversion.
+   */
+  uint8_t samples;
 };
 
 struct XPT2046
@@ -58,12 +81,24 @@ struct XPT2046
   /* Baud rate of the serial interface */
   uint32_t rate;
 
+  /* Affine calibration matrix in Q16.16 format */
+  int32_t matrix[6];
+  /* Filtered coordinates in fixed point format */
+  int32_t filtered[2];
+
   /* Response buffer */
-  uint8_t rxBuffer[11];
+  uint8_t rxBuffer[XPT2046_BUFFER_SIZE];
+  /* Command buffer */
+  uint8_t txBuffer[XPT2046_BUFFER_SIZE];
+  /* Length of the transfer */
+  uint8_t length;
+
   /* Command and status flags */
   uint8_t flags;
-  /* Command buffer */
-  uint8_t txBuffer[11];
+  /* IIR filter strength */
+  uint8_t filter;
+  /* Conversions per axis */
+  uint8_t samples;
   /* Current state */
   uint8_t state;
 
@@ -74,11 +109,16 @@ struct XPT2046
   uint16_t yMax;
   uint16_t yMin;
   uint16_t yRes;
+
+  /* Affine calibration is used instead of the min/max model */
+  bool affine;
 };
 /*----------------------------------------------------------------------------*/
 BEGIN_DECLS
 
 void xpt2046ResetCalibration(struct XPT2046 *);
+bool xpt2046SetAffineCalibration(struct XPT2046 *,
+    const struct XPT2046Point [static 3], const struct XPT2046Point [static 3]);
 void xpt2046SetCalibration(struct XPT2046 *,
     uint16_t, uint16_t, uint16_t, uint16_t);
 void xpt2046SetSensitivity(struct XPT2046 *, uint16_t);
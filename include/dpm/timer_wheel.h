@@ -0,0 +1,88 @@
+/*
+ * timer_wheel.h
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+#ifndef DPM_TIMER_WHEEL_H_
+#define DPM_TIMER_WHEEL_H_
+/*----------------------------------------------------------------------------*/
+#include <halm/timer.h>
+#include <stddef.h>
+/*----------------------------------------------------------------------------*/
+extern const struct EntityClass * const TimerWheel;
+
+struct VirtualTimer;
+
+struct TimerWheelConfig
+{
+  /** Mandatory: hardware timer. */
+  struct Timer *timer;
+  /**
+   * Mandatory: tick frequency of virtual timers. The frequency of the
+   * hardware timer should be a multiple of this frequency.
+   */
+  uint32_t frequency;
+  /** Optional: number of wheel slots, should be a power of two. */
+  size_t size;
+};
+
+struct TimerWheel
+{
+  struct Entity base;
+
+  /* Hardware timer */
+  struct Timer *timer;
+  /* Lists of virtual timers, a timer is stored in the slot of its deadline */
+  struct VirtualTimer **slots;
+  /* Tick frequency */
+  uint32_t frequency;
+  /* Number of slots minus one */
+  uint32_t mask;
+  /* Free-running tick counter */
+  uint32_t ticks;
+  /* Number of enabled virtual timers */
+  uint32_t active;
+};
+/*----------------------------------------------------------------------------*/
+extern const struct TimerClass * const VirtualTimer;
+
+struct VirtualTimerConfig
+{
+  /** Mandatory: parent timer wheel. */
+  struct TimerWheel *parent;
+};
+
+struct VirtualTimer
+{
+  struct Timer base;
+
+  void (*callback)(void *);
+  void *callbackArgument;
+
+  /* Parent timer wheel */
+  struct TimerWheel *wheel;
+  /* Neighbours in the slot list */
+  struct VirtualTimer *next;
+  struct VirtualTimer *previous;
+
+  /* Tick number of the expiration */
+  uint32_t deadline;
+  /* Timer period in ticks */
+  uint32_t overflow;
+  /* Elapsed ticks of the stopped timer */
+  uint32_t value;
+
+  /* Disable the timer after expiration */
+  bool autostop;
+  /* Timer is linked into the wheel */
+  bool enabled;
+};
+/*----------------------------------------------------------------------------*/
+BEGIN_DECLS
+
+void *timerWheelCreate(void *);
+
+END_DECLS
+/*----------------------------------------------------------------------------*/
+#endif /* DPM_TIMER_WHEEL_H_ */
@@ -0,0 +1,281 @@
+/*
+ * pixel_format.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the MIT License
+ */
+
+/*
+ * Host benchmark of pixel format kernels. Kernels are compared bit by bit
+ * with per-pixel scalar references, including tails and misaligned input
+ * buffers, then both versions are timed on a 320x240 frame. References
+ * are not inlined, so that both versions are compiled for unknown pixel
+ * counts. Build with automatic vectorization disabled to get figures close
+ * to a Cortex-M core:
+ *
+ *   cc -O2 -fno-tree-vectorize -Iinclude -I<xcore>/include \
+ *       tools/benchmarks/pixel_format.c drivers/displays/pixel_format.c \
+ *       -o pixel_format_bench
+ *
+ * Build without -fno-tree-vectorize or with -O3 to compare against
+ * references vectorized by the host compiler.
+ */
+
+#include <dpm/displays/pixel_format.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/*----------------------------------------------------------------------------*/
+#define FRAME_WIDTH   320
+#define FRAME_HEIGHT  240
+#define FRAME_PIXELS  (FRAME_WIDTH * FRAME_HEIGHT)
+#define ITERATIONS    200
+/*----------------------------------------------------------------------------*/
+static bool checkKernels(void);
+static uint16_t convertPixel(unsigned int, unsigned int, unsigned int, bool);
+static double getTime(void);
+[[gnu::noinline]] static void refArgb8888ToRgb565(uint16_t *,
+    const uint32_t *, size_t, uint16_t, bool);
+[[gnu::noinline]] static void refRgb888ToRgb565(uint16_t *, const uint8_t *,
+    size_t, bool);
+[[gnu::noinline]] static void refRgb888ToRgb565Dither(uint16_t *,
+    const uint8_t *, size_t, uint16_t, uint16_t, bool);
+[[gnu::noinline]] static void refSwapBytes(uint16_t *, const uint16_t *,
+    size_t);
+/*----------------------------------------------------------------------------*/
+static const uint8_t ditherMatrix[4][4] = {
+    {0, 8, 2, 10},
+    {12, 4, 14, 6},
+    {3, 11, 1, 9},
+    {15, 7, 13, 5}
+};
+
+static uint8_t rgbFrame[FRAME_PIXELS * 3 + 1];
+static uint32_t argbFrame[FRAME_PIXELS];
+static uint16_t outputFrame[FRAME_PIXELS];
+static uint16_t referenceFrame[FRAME_PIXELS];
+/*----------------------------------------------------------------------------*/
+static bool checkKernels(void)
+{
+  static const size_t counts[] = {0, 1, 2, 3, 4, 5, 7, 8, 13, FRAME_WIDTH};
+
+  for (size_t index = 0; index < ARRAY_SIZE(counts); ++index)
+  {
+    const size_t count = counts[index];
+
+    for (unsigned int flags = 0; flags < 4; ++flags)
+    {
+      /* Odd offset makes the input misaligned */
+      const uint8_t * const input = rgbFrame + (flags & 1);
+      const bool bigEndian = (flags & 2) != 0;
+      const size_t length = count * sizeof(uint16_t);
+
+      pfRgb888ToRgb565(outputFrame, input, count, bigEndian);
+      refRgb888ToRgb565(referenceFrame, input, count, bigEndian);
+      if (memcmp(outputFrame, referenceFrame, length))
+        return false;
+
+      for (uint16_t x = 0; x < 4; ++x)
+      {
+        for (uint16_t y = 0; y < 4; ++y)
+        {
+          pfRgb888ToRgb565Dither(outputFrame, input, count, x, y, bigEndian);
+          refRgb888ToRgb565Dither(referenceFrame, input, count, x, y,
+              bigEndian);
+          if (memcmp(outputFrame, referenceFrame, length))
+            return false;
+        }
+      }
+
+      pfArgb8888ToRgb565(outputFrame, argbFrame, count, 0x7BEF, bigEndian);
+      refArgb8888ToRgb565(referenceFrame, argbFrame, count, 0x7BEF,
+          bigEndian);
+      if (memcmp(outputFrame, referenceFrame, length))
+        return false;
+
+      memcpy(outputFrame, argbFrame, length);
+      pfSwapBytes(outputFrame, outputFrame, count);
+      refSwapBytes(referenceFrame, (const uint16_t *)argbFrame, count);
+      if (memcmp(outputFrame, referenceFrame, length))
+        return false;
+    }
+  }
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+static uint16_t convertPixel(unsigned int r, unsigned int g, unsigned int b,
+    bool bigEndian)
+{
+  const uint16_t value = (uint16_t)(((r >> 3) << 11) | ((g >> 2) << 5)
+      | (b >> 3));
+
+  return bigEndian ? (uint16_t)((value << 8) | (value >> 8)) : value;
+}
+/*----------------------------------------------------------------------------*/
+static double getTime(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+/*----------------------------------------------------------------------------*/
+static void refArgb8888ToRgb565(uint16_t *output, const uint32_t *input,
+    size_t count, uint16_t background, bool bigEndian)
+{
+  const unsigned int r = background >> 11;
+  const unsigned int g = (background >> 5) & 0x3F;
+  const unsigned int b = background & 0x1F;
+  const unsigned int channels[3] = {
+      (r << 3) | (r >> 2),
+      (g << 2) | (g >> 4),
+      (b << 3) | (b >> 2)
+  };
+
+  for (size_t index = 0; index < count; ++index)
+  {
+    const uint32_t pixel = input[index];
+    const unsigned int alpha = pixel >> 24;
+    const unsigned int foreground = alpha + (alpha >> 7);
+    unsigned int result[3];
+
+    for (size_t channel = 0; channel < 3; ++channel)
+    {
+      const unsigned int value = (pixel >> (16 - channel * 8)) & 0xFF;
+
+      result[channel] = (value * foreground
+          + channels[channel] * (256 - foreground)) >> 8;
+    }
+
+    output[index] = convertPixel(result[0], result[1], result[2], bigEndian);
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void refRgb888ToRgb565(uint16_t *output, const uint8_t *input,
+    size_t count, bool bigEndian)
+{
+  for (size_t index = 0; index < count; ++index, input += 3)
+    output[index] = convertPixel(input[0], input[1], input[2], bigEndian);
+}
+/*----------------------------------------------------------------------------*/
+static void refRgb888ToRgb565Dither(uint16_t *output, const uint8_t *input,
+    size_t count, uint16_t x, uint16_t y, bool bigEndian)
+{
+  for (size_t index = 0; index < count; ++index, input += 3)
+  {
+    const unsigned int value = ditherMatrix[y & 3][(x + index) & 3];
+    const unsigned int r = MIN(input[0] + (value >> 1), 255);
+    const unsigned int g = MIN(input[1] + (value >> 2), 255);
+    const unsigned int b = MIN(input[2] + (value >> 1), 255);
+
+    output[index] = convertPixel(r, g, b, bigEndian);
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void refSwapBytes(uint16_t *output, const uint16_t *input,
+    size_t count)
+{
+  for (size_t index = 0; index < count; ++index)
+    output[index] = (uint16_t)((input[index] << 8) | (input[index] >> 8));
+}
+/*----------------------------------------------------------------------------*/
+int main(void)
+{
+  srand(1);
+
+  for (size_t index = 0; index < sizeof(rgbFrame); ++index)
+    rgbFrame[index] = (uint8_t)rand();
+
+  for (size_t index = 0; index < FRAME_PIXELS; ++index)
+  {
+    /* Make opaque and transparent pixels frequent as in real assets */
+    const uint32_t alpha = index % 3 ? (uint8_t)rand() : 0xFF;
+    argbFrame[index] = (alpha << 24) | ((uint32_t)rand() & 0x00FFFFFFUL);
+  }
+
+  if (!checkKernels())
+  {
+    printf("Kernel output differs from the reference\n");
+    return EXIT_FAILURE;
+  }
+
+  static const char * const names[] = {
+      "RGB888 to RGB565",
+      "RGB888 to RGB565 dithered",
+      "ARGB8888 blending",
+      "RGB565 byte swap"
+  };
+  uint32_t checksum = 0;
+
+  for (size_t test = 0; test < ARRAY_SIZE(names); ++test)
+  {
+    double elapsed[2];
+
+    for (size_t variant = 0; variant < 2; ++variant)
+    {
+      const bool reference = variant == 0;
+      const double start = getTime();
+
+      for (unsigned int iteration = 0; iteration < ITERATIONS; ++iteration)
+      {
+        uint16_t * const output = reference ? referenceFrame : outputFrame;
+
+        switch (test)
+        {
+          case 0:
+            if (reference)
+              refRgb888ToRgb565(output, rgbFrame, FRAME_PIXELS, true);
+            else
+              pfRgb888ToRgb565(output, rgbFrame, FRAME_PIXELS, true);
+            break;
+
+          case 1:
+            for (uint16_t y = 0; y < FRAME_HEIGHT; ++y)
+            {
+              const uint8_t * const row = rgbFrame + y * FRAME_WIDTH * 3;
+              uint16_t * const line = output + y * FRAME_WIDTH;
+
+              if (reference)
+                refRgb888ToRgb565Dither(line, row, FRAME_WIDTH, 0, y, true);
+              else
+                pfRgb888ToRgb565Dither(line, row, FRAME_WIDTH, 0, y, true);
+            }
+            break;
+
+          case 2:
+            if (reference)
+            {
+              refArgb8888ToRgb565(output, argbFrame, FRAME_PIXELS, 0x7BEF,
+                  true);
+            }
+            else
+            {
+              pfArgb8888ToRgb565(output, argbFrame, FRAME_PIXELS, 0x7BEF,
+                  true);
+            }
+            break;
+
+          default:
+            if (reference)
+              refSwapBytes(output, output, FRAME_PIXELS);
+            else
+              pfSwapBytes(output, output, FRAME_PIXELS);
+            break;
+        }
+
+        checksum += output[iteration % FRAME_PIXELS];
+      }
+
+      elapsed[variant] = (getTime() - start) * 1e3 / ITERATIONS;
+    }
+
+    printf("%-28s reference %8.3f ms, kernel %8.3f ms, ratio %5.2f\n",
+        names[test], elapsed[0], elapsed[1], elapsed[0] / elapsed[1]);
+  }
+
+  /* Checksum keeps the compiler from discarding the results */
+  printf("Checksum %08" PRIX32 "\n", checksum);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,170 @@
+/*
+ * thermistor_ntc.c
+ * Copyright (C) 2026 xent
+ * Project is distributed under the terms of the GNU General Public License v3.0
+ */
+
+/*
+ * Host benchmark of batch NTC conversions. Array and channel conversions
+ * are compared with ntcRawToTemperature for all raw values, then both
+ * versions are timed. Tables of 257 entries use the shifted conversion,
+ * tables of 200 entries fall back to the division. Build with:
+ *
+ *   cc -O2 -Iinclude -I<xcore>/include \
+ *       tools/benchmarks/thermistor_ntc.c drivers/sensors/thermistor_ntc.c \
+ *       -o thermistor_ntc_bench
+ *
+ * Add -fno-tree-vectorize to get figures closer to a Cortex-M core
+ * without vector instructions.
+ */
+
+#include <dpm/sensors/thermistor_ntc.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+/*----------------------------------------------------------------------------*/
+#define CHANNELS      4
+#define ITERATIONS    200
+#define SAMPLES       (UINT16_MAX + 1)
+/*----------------------------------------------------------------------------*/
+static bool checkConversions(size_t, const int16_t * const *);
+static double getTime(void);
+static void makeTable(int16_t *, size_t, int);
+static void runBenchmark(size_t, const int16_t * const *);
+/*----------------------------------------------------------------------------*/
+static uint16_t input[SAMPLES];
+static int32_t output[SAMPLES];
+static int16_t tables[CHANNELS][257];
+static uint32_t checksum = 0;
+/*----------------------------------------------------------------------------*/
+static bool checkConversions(size_t size, const int16_t * const *pointers)
+{
+  for (size_t index = 0; index < SAMPLES; ++index)
+    input[index] = (uint16_t)index;
+
+  ntcRawToTemperatureArray(size, pointers[0], output, input, SAMPLES);
+
+  for (size_t index = 0; index < SAMPLES; ++index)
+  {
+    if (output[index] != ntcRawToTemperature(size, pointers[0], input[index]))
+      return false;
+  }
+
+  ntcRawToTemperatureChannels(size, pointers, CHANNELS, output, input,
+      SAMPLES);
+
+  for (size_t index = 0; index < SAMPLES; ++index)
+  {
+    const int16_t * const table = pointers[index % CHANNELS];
+
+    if (output[index] != ntcRawToTemperature(size, table, input[index]))
+      return false;
+  }
+
+  return true;
+}
+/*----------------------------------------------------------------------------*/
+static double getTime(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+/*----------------------------------------------------------------------------*/
+/**
+ * Fill a table with a decreasing curve similar to the output of
+ * make_ntc_table.py, the exact shape does not affect the conversion.
+ * @param table Output table.
+ * @param size Number of table entries.
+ * @param shift Curve offset in hundredths of a degree.
+ */
+static void makeTable(int16_t *table, size_t size, int shift)
+{
+  for (size_t index = 0; index < size; ++index)
+  {
+    const int32_t position = (int32_t)(index * 512 / (size - 1)) - 256;
+    const int32_t value = 2500 + shift - position * 40
+        + position * position * position / 1024;
+
+    table[index] = (int16_t)MAX(MIN(value, INT16_MAX), INT16_MIN);
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void runBenchmark(size_t size, const int16_t * const *pointers)
+{
+  double elapsed[3];
+  double start;
+
+  srand(1);
+  for (size_t index = 0; index < SAMPLES; ++index)
+    input[index] = (uint16_t)rand();
+
+  start = getTime();
+  for (unsigned int iteration = 0; iteration < ITERATIONS; ++iteration)
+  {
+    const int16_t * const table = pointers[iteration % CHANNELS];
+
+    for (size_t index = 0; index < SAMPLES; ++index)
+      output[index] = ntcRawToTemperature(size, table, input[index]);
+    checksum += (uint32_t)output[iteration];
+  }
+  elapsed[0] = getTime() - start;
+
+  start = getTime();
+  for (unsigned int iteration = 0; iteration < ITERATIONS; ++iteration)
+  {
+    const int16_t * const table = pointers[iteration % CHANNELS];
+
+    ntcRawToTemperatureArray(size, table, output, input, SAMPLES);
+    checksum += (uint32_t)output[iteration];
+  }
+  elapsed[1] = getTime() - start;
+
+  start = getTime();
+  for (unsigned int iteration = 0; iteration < ITERATIONS; ++iteration)
+  {
+    ntcRawToTemperatureChannels(size, pointers, CHANNELS, output, input,
+        SAMPLES);
+    checksum += (uint32_t)output[iteration];
+  }
+  elapsed[2] = getTime() - start;
+
+  for (size_t index = 0; index < 3; ++index)
+    elapsed[index] *= 1e9 / ((double)ITERATIONS * SAMPLES);
+
+  printf("Table size %3zu: scalar %6.2f ns, array %6.2f ns, "
+      "channels %6.2f ns per sample\n",
+      size, elapsed[0], elapsed[1], elapsed[2]);
+}
+/*----------------------------------------------------------------------------*/
+int main(void)
+{
+  static const size_t sizes[] = {257, 200};
+  const int16_t *pointers[CHANNELS];
+
+  for (size_t channel = 0; channel < CHANNELS; ++channel)
+    pointers[channel] = tables[channel];
+
+  for (size_t index = 0; index < ARRAY_SIZE(sizes); ++index)
+  {
+    const size_t size = sizes[index];
+
+    for (size_t channel = 0; channel < CHANNELS; ++channel)
+      makeTable(tables[channel], size, (int)channel * 50);
+
+    if (!checkConversions(size, pointers))
+    {
+      printf("Table size %3zu: batch output differs from the scalar one\n",
+          size);
+      return EXIT_FAILURE;
+    }
+
+    runBenchmark(size, pointers);
+  }
+
+  /* Checksum keeps the compiler from discarding the results */
+  printf("Checksum %08" PRIX32 "\n", checksum);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+
+import argparse
+import struct
+import sys
+
+BLOCK_MAGIC = 0x4C53
+BLOCK_HEADER_SIZE = 8
+RECORD_DEFINITION = 0x80
+
+# Element width and signedness for each value of enum SensorType
+TYPES = [(1, True), (2, True), (4, True), (8, True),
+         (1, False), (2, False), (4, False), (8, False)]
+UNITS = ['', 'C', 'g', 'Gs', 'm', 'Pa', '%', 'rad/s']
+
+def read_varint(data, position):
+    value = 0
+    shift = 0
+    while True:
+        byte = data[position]
+        position += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, position
+
+def zigzag_decode(value):
+    return (value >> 1) ^ -(value & 1)
+
+def to_signed(value, width):
+    bits = width * 8
+    return value - (1 << bits) if value & (1 << (bits - 1)) else value
+
+def decode_block(data):
+    streams = {}
+    timestamp = 0
+    position = BLOCK_HEADER_SIZE
+    samples = []
+
+    while position < len(data):
+        header = data[position]
+        position += 1
+        index = header & ~RECORD_DEFINITION
+
+        if header & RECORD_DEFINITION:
+            tag, position = read_varint(data, position)
+            sensor_type, count, exponent, unit = struct.unpack_from('<BBbB', data, position)
+            position += 4
+            streams[index] = {
+                'tag': zigzag_decode(tag),
+                'type': sensor_type,
+                'count': count,
+                'exponent': exponent,
+                'unit': unit,
+                'previous': [0] * count
+            }
+        stream = streams[index]
+        width, signed = TYPES[stream['type']]
+        mask = (1 << (width * 8)) - 1
+
+        delta, position = read_varint(data, position)
+        timestamp += zigzag_decode(delta)
+
+        values = []
+        for i in range(stream['count']):
+            delta, position = read_varint(data, position)
+            raw = (stream['previous'][i] + zigzag_decode(delta)) & mask
+            stream['previous'][i] = raw
+            if signed:
+                raw = to_signed(raw, width)
+            values.append(raw * 2.0 ** stream['exponent'])
+
+        samples.append((timestamp, stream['tag'], values, UNITS[stream['unit']]))
+    return samples
+
+def read_blocks(image, page_size):
+    blocks = []
+    for offset in range(0, len(image) - page_size + 1, page_size):
+        magic, length, sequence = struct.unpack_from('<HHI', image, offset)
+        if magic != BLOCK_MAGIC or length < BLOCK_HEADER_SIZE or length > page_size:
+            continue
+        blocks.append((sequence, image[offset:offset + length]))
+
+    if not blocks:
+        return []
+
+    # Order blocks by sequence number, the log region may wrap around
+    blocks.sort(key=lambda block: block[0])
+    return [block[1] for block in blocks]
+
+def main():
+    args = argparse.ArgumentParser()
+    args.add_argument('-o', dest='output', help='output CSV file',
+                      type=str, default='')
+    args.add_argument('-p', dest='page_size', help='flash page size',
+                      type=int, default=256)
+    args.add_argument('-s', dest='offset', help='offset of the log region in the image',
+                      type=int, default=0)
+    args.add_argument(dest='input', help='memory image', type=str)
+    options = args.parse_args()
+
+    with open(options.input, 'rb') as input_file:
+        image = input_file.read()[options.offset:]
+
+    lines = []
+    for block in read_blocks(image, options.page_size):
+        for timestamp, tag, values, unit in decode_block(block):
+            fields = [str(timestamp), str(tag)] + [f'{value:g}' for value in values] + [unit]
+            lines.append(','.join(fields))
+
+    text = '\n'.join(lines) + ('\n' if lines else '')
+    if options.output:
+        with open(options.output, 'wb') as output_file:
+            output_file.write(text.encode())
+    else:
+        sys.stdout.write(text)
+
+if __name__ == '__main__':
+    main()
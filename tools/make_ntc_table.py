@@ -36,6 +36,31 @@ def make_table(size, adc_max, adc_res, b_value, r_external, r_thermistor, lowsid
         raw += step
     return output
 
+def make_inverse_table(table, t_min, t_max, cells):
+    span = t_max - t_min
+    shift = max(0, math.floor(math.log2(span / cells)))
+    if shift > 15:
+        raise ValueError()
+    t_step = 1 << shift
+    count = (span + t_step - 1) // t_step + 1
+    raw_step = 65536 // (len(table) - 1)
+
+    def temperature_to_raw(t):
+        if t > table[0]:
+            return 0
+        if t < table[-1]:
+            return 65535
+        for i in range(len(table) - 1):
+            lower, upper = table[i], table[i + 1]
+            if lower == upper or not min(lower, upper) <= t <= max(lower, upper):
+                continue
+            raw = i * raw_step + (t - lower) * raw_step / (upper - lower)
+            return min(max(round(raw), 0), 65535)
+        return 65535
+
+    output = [temperature_to_raw(t_min + i * t_step) for i in range(count)]
+    return output, shift
+
 def generate_header(name, suffix):
     output = textwrap.dedent(f'''\
         /*
@@ -60,7 +85,19 @@ def generate_header(name, suffix):
         ''')
     return output
 
-def generate_source(table, name, suffix, size):
+def generate_array(values):
+    output = ''
+    i = 0
+    while i < len(values):
+        count = min(8, len(values) - i)
+        output += '    ' + ', '.join(f'{value:6d}' for value in values[i:i + count])
+        i += count
+        if i < len(values):
+            output += ','
+        output += '\n'
+    return output
+
+def generate_source(table, name, suffix, size, inverse=None):
     output = textwrap.dedent(f'''\
         /*
          * {name}.c
@@ -75,19 +112,32 @@ def generate_source(table, name, suffix, size):
         static const int16_t NTC_TABLE_{suffix.upper()}[] = {{
         ''')
 
-    i = 0
-    while i < len(table):
-        count = min(8, len(table) - i)
-        output += '    ' + ', '.join(f'{value:6d}' for value in table[i:i + count])
-        i += count
-        if i < len(table):
-            output += ','
-        output += '\n'
-
+    output += generate_array(table)
     output += textwrap.dedent(f'''\
         }};
         static_assert(ARRAY_SIZE(NTC_TABLE_{suffix.upper()}) == NTC_TABLE_SIZE,
             "Incorrect table size");
+        ''')
+
+    if inverse is not None:
+        inverse_table, t_min, shift = inverse
+        output += textwrap.dedent(f'''\
+            /*----------------------------------------------------------------------------*/
+            #define NTC_INVERSE_MIN   {t_min}
+            #define NTC_INVERSE_MAX   {t_min + ((len(inverse_table) - 1) << shift)}
+            #define NTC_INVERSE_SHIFT {shift}
+            #define NTC_INVERSE_SIZE  {len(inverse_table)}
+            /*----------------------------------------------------------------------------*/
+            static const uint16_t NTC_INVERSE_{suffix.upper()}[] = {{
+            ''')
+        output += generate_array(inverse_table)
+        output += textwrap.dedent(f'''\
+            }};
+            static_assert(ARRAY_SIZE(NTC_INVERSE_{suffix.upper()}) == NTC_INVERSE_SIZE,
+                "Incorrect inverse table size");
+            ''')
+
+    output += textwrap.dedent(f'''\
         /*----------------------------------------------------------------------------*/
         int32_t ntcRawToTemperature{suffix}(uint16_t value)
         {{
@@ -96,9 +146,23 @@ def generate_source(table, name, suffix, size):
         /*----------------------------------------------------------------------------*/
         uint16_t ntcTemperatureToRaw{suffix}(int32_t temperature)
         {{
-          return ntcTemperatureToRaw(NTC_TABLE_SIZE, NTC_TABLE_{suffix.upper()}, temperature);
-        }}
         ''')
+
+    if inverse is not None:
+        output += textwrap.dedent(f'''\
+              /* Temperatures outside of the inverse table use the direct table */
+              if (temperature < NTC_INVERSE_MIN || temperature > NTC_INVERSE_MAX)
+                return ntcTemperatureToRaw(NTC_TABLE_SIZE, NTC_TABLE_{suffix.upper()}, temperature);
+
+              return ntcTemperatureToRawInverse(NTC_INVERSE_SIZE, NTC_INVERSE_{suffix.upper()},
+                  NTC_INVERSE_MIN, NTC_INVERSE_SHIFT, temperature);
+            }}
+            ''')
+    else:
+        output += textwrap.dedent(f'''\
+              return ntcTemperatureToRaw(NTC_TABLE_SIZE, NTC_TABLE_{suffix.upper()}, temperature);
+            }}
+            ''')
     return output
 
 def make_resistor_suffix(r):
@@ -114,6 +178,14 @@ def main():
     args = argparse.ArgumentParser()
     args.add_argument('-a', dest='resolution', help='ADC resolution in bits',
                       type=int, default=None)
+    args.add_argument('-i', dest='inverse', help='generate inverse table for temperature to raw conversion',
+                      default=False, action='store_true')
+    args.add_argument('--inverse-cells', dest='inverse_cells', help='minimum number of cells in the inverse table',
+                      type=int, default=64)
+    args.add_argument('--inverse-max', dest='inverse_max', help='inverse table upper temperature in Celsius',
+                      type=float, default=125.0)
+    args.add_argument('--inverse-min', dest='inverse_min', help='inverse table lower temperature in Celsius',
+                      type=float, default=-40.0)
     args.add_argument('-j', dest='justify', help='ADC justify left or right',
                       type=str, default='right')
     args.add_argument('-b', dest='beta', help='beta value',
@@ -147,6 +219,10 @@ def main():
         raise ValueError()
     if options.resolution is None or options.resolution < 8 or options.resolution > 16:
         raise ValueError()
+    if options.inverse_cells < 16 or options.inverse_cells > 1024:
+        raise ValueError()
+    if options.inverse_min >= options.inverse_max:
+        raise ValueError()
     if not options.header and not options.source:
         options.header = options.source = True
 
@@ -173,6 +249,13 @@ def main():
         lowside=options.lowside
     )
 
+    inverse = None
+    if options.inverse:
+        t_min = round(options.inverse_min * 100.0)
+        t_max = round(options.inverse_max * 100.0)
+        inverse_table, shift = make_inverse_table(table, t_min, t_max, options.inverse_cells)
+        inverse = (inverse_table, t_min, shift)
+
     if options.header:
         text = generate_header(name, suffix)
         if options.output:
@@ -181,7 +264,7 @@ def main():
         else:
             print(text, end='')
     if options.source:
-        text = generate_source(table, name, suffix, options.cells)
+        text = generate_source(table, name, suffix, options.cells, inverse)
         if options.output:
             with open(os.path.join(options.output, name) + '.c', 'wb') as output_file:
                 output_file.write(text.encode())